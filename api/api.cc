@@ -108,6 +108,11 @@ future<> set_server_load_sstable(http_context& ctx) {
                 "The column family API", set_column_family);
 }
 
+future<> set_server_commitlog(http_context& ctx) {
+    return register_api(ctx, "commitlog",
+                "The commit log API", set_commitlog);
+}
+
 future<> set_server_messaging_service(http_context& ctx) {
     return register_api(ctx, "messaging_service",
                 "The messaging service API", set_messaging_service);
@@ -148,9 +153,6 @@ future<> set_server_done(http_context& ctx) {
         rb->register_function(r, "lsa", "Log-structured allocator API");
         set_lsa(ctx, r);
 
-        rb->register_function(r, "commitlog",
-                "The commit log API");
-        set_commitlog(ctx,r);
         rb->register_function(r, "hinted_handoff",
                 "The hinted handoff API");
         set_hinted_handoff(ctx, r);
@@ -47,6 +47,7 @@ future<> set_server_storage_service(http_context& ctx);
 future<> set_server_snapshot(http_context& ctx);
 future<> set_server_gossip(http_context& ctx);
 future<> set_server_load_sstable(http_context& ctx);
+future<> set_server_commitlog(http_context& ctx);
 future<> set_server_messaging_service(http_context& ctx);
 future<> set_server_storage_proxy(http_context& ctx);
 future<> set_server_stream_manager(http_context& ctx);
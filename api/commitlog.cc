@@ -21,6 +21,7 @@
 
 #include "commitlog.hh"
 #include <db/commitlog/commitlog.hh>
+#include <db/commitlog/commitlog_replayer.hh>
 #include "api/api-doc/commitlog.json.hh"
 #include "database.hh"
 #include <vector>
@@ -74,6 +75,34 @@ void set_commitlog(http_context& ctx, routes& r) {
     httpd::commitlog_json::get_total_commit_log_size.set(r, [&ctx](std::unique_ptr<request> req) {
         return acquire_cl_metric<uint64_t>(ctx, std::bind(&db::commitlog::get_total_size, std::placeholders::_1));
     });
+
+    httpd::commitlog_json::get_replay_progress.set(r, [&ctx](std::unique_ptr<request> req) {
+        using progress = db::commitlog_replayer::progress;
+        return ctx.db.map_reduce0([](database&) {
+            return db::commitlog_replayer::local_progress();
+        }, progress(), [](progress a, const progress& b) {
+            a.segments_total += b.segments_total;
+            a.segments_replayed += b.segments_replayed;
+            a.bytes_total += b.bytes_total;
+            a.bytes_replayed += b.bytes_replayed;
+            a.applied_mutations += b.applied_mutations;
+            a.skipped_mutations += b.skipped_mutations;
+            a.invalid_mutations += b.invalid_mutations;
+            a.active |= b.active;
+            return a;
+        }).then([](const progress& p) {
+            httpd::commitlog_json::replay_progress res;
+            res.in_progress = p.active;
+            res.segments_total = p.segments_total;
+            res.segments_replayed = p.segments_replayed;
+            res.bytes_total = p.bytes_total;
+            res.bytes_replayed = p.bytes_replayed;
+            res.applied_mutations = p.applied_mutations;
+            res.skipped_mutations = p.skipped_mutations;
+            res.invalid_mutations = p.invalid_mutations;
+            return make_ready_future<json::json_return_type>(res);
+        });
+    });
 }
 
 }
@@ -27,6 +27,7 @@
 #include "schema_fwd.hh"
 #include "sstables/shared_sstable.hh"
 #include "exceptions/exceptions.hh"
+#include "gc_clock.hh"
 #include "sstables/compaction_backlog_manager.hh"
 
 class table;
@@ -44,6 +45,7 @@ enum class compaction_strategy_type {
     leveled,
     date_tiered,
     time_window,
+    incremental,
 };
 
 class compaction_strategy_impl;
@@ -88,6 +90,14 @@ class compaction_strategy {
     // An estimation of number of compaction for strategy to be satisfied.
     int64_t estimated_pending_compactions(column_family& cf) const;
 
+    // Check if a given sstable is entitled for tombstone compaction based on its
+    // droppable tombstone histogram and gc_before.
+    bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point gc_before) const;
+
+    // Relative share of compaction a column family gets when competing with others, from the
+    // "shares" compaction option.
+    unsigned shares() const;
+
     static sstring name(compaction_strategy_type type) {
         switch (type) {
         case compaction_strategy_type::null:
@@ -102,6 +112,8 @@ class compaction_strategy {
             return "DateTieredCompactionStrategy";
         case compaction_strategy_type::time_window:
             return "TimeWindowCompactionStrategy";
+        case compaction_strategy_type::incremental:
+            return "IncrementalCompactionStrategy";
         default:
             throw std::runtime_error("Invalid Compaction Strategy");
         }
@@ -122,6 +134,8 @@ class compaction_strategy {
             return compaction_strategy_type::date_tiered;
         } else if (short_name == "TimeWindowCompactionStrategy") {
             return compaction_strategy_type::time_window;
+        } else if (short_name == "IncrementalCompactionStrategy") {
+            return compaction_strategy_type::incremental;
         } else {
             throw exceptions::configuration_exception(format("Unable to find compaction strategy class '{}'", name));
         }
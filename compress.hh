@@ -23,17 +23,27 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
 
+#include "bytes.hh"
 #include "exceptions/exceptions.hh"
 
 
 class compressor {
     sstring _name;
 public:
+    // Amount of data used to train a dictionary, relative to the dictionary size.
+    static constexpr size_t dictionary_sample_ratio = 100;
+    // Training runs on the reactor and can't be preempted, its duration grows with
+    // the amount of samples. Keep it short, at the cost of weaker large dictionaries.
+    static constexpr size_t max_dictionary_sample_size = 256 * 1024;
+    // Largest dictionary which still gets the full ratio of samples.
+    static constexpr size_t max_dictionary_size = max_dictionary_sample_size / dictionary_sample_ratio;
+
     compressor(sstring);
 
     virtual ~compressor() {}
@@ -55,6 +65,31 @@ class compressor {
      */
     virtual size_t compress_max_size(size_t input_len) const = 0;
 
+    /**
+     * Returns the size of the dictionary which should be trained for data
+     * compressed by this compressor, or 0 if dictionaries are not used.
+     */
+    virtual size_t dictionary_size() const {
+        return 0;
+    }
+    /**
+     * Trains a dictionary of at most dictionary_size() bytes from samples
+     * concatenated in "samples". Returns an empty dictionary if training
+     * fails, e.g. because there is too little data.
+     */
+    virtual bytes train_dictionary(bytes_view samples, const std::vector<size_t>& sample_sizes) const;
+    /**
+     * Returns a compressor with the same options, which uses the given
+     * dictionary for all chunks. The dictionary has to be provided again
+     * to uncompress the data.
+     */
+    virtual shared_ptr<compressor> with_dictionary(bytes_view dictionary) const;
+    /**
+     * Returns the dictionary used by this compressor, empty if none.
+     */
+    virtual bytes_view dictionary() const {
+        return bytes_view();
+    }
     /**
      * Returns accepted option names for this compressor
      */
@@ -275,6 +275,7 @@ scylla_tests = set([
     'test/boost/auth_test',
     'test/boost/batchlog_manager_test',
     'test/boost/big_decimal_test',
+    'test/boost/bptree_test',
     'test/boost/broken_sstable_test',
     'test/boost/bytes_ostream_test',
     'test/boost/cache_flat_mutation_reader_test',
@@ -359,6 +360,7 @@ scylla_tests = set([
     'test/boost/sstable_test',
     'test/boost/storage_proxy_test',
     'test/boost/top_k_test',
+    'test/boost/tournament_tree_test',
     'test/boost/transport_test',
     'test/boost/truncation_migration_test',
     'test/boost/types_test',
@@ -381,7 +383,9 @@ scylla_tests = set([
     'test/manual/row_locker_test',
     'test/manual/streaming_histogram_test',
     'test/manual/sstable_scan_footprint_test',
+    'test/perf/perf_bloom_filter',
     'test/perf/perf_cache_eviction',
+    'test/perf/perf_commitlog',
     'test/perf/perf_cql_parser',
     'test/perf/perf_fast_forward',
     'test/perf/perf_hash',
@@ -518,6 +522,7 @@ scylla_core = (['database.cc',
                 'sstables/mp_row_consumer.cc',
                 'sstables/sstables.cc',
                 'sstables/sstables_manager.cc',
+                'sstables/partition_index_cache.cc',
                 'sstables/mc/writer.cc',
                 'sstables/sstable_version.cc',
                 'sstables/compress.cc',
@@ -526,6 +531,7 @@ scylla_core = (['database.cc',
                 'sstables/compaction_strategy.cc',
                 'sstables/size_tiered_compaction_strategy.cc',
                 'sstables/leveled_compaction_strategy.cc',
+                'sstables/incremental_compaction_strategy.cc',
                 'sstables/compaction_manager.cc',
                 'sstables/integrity_checked_file_impl.cc',
                 'sstables/prepended_input_stream.cc',
@@ -607,6 +613,7 @@ scylla_core = (['database.cc',
                 'service/priority_manager.cc',
                 'service/migration_manager.cc',
                 'service/storage_proxy.cc',
+                'service/partial_aggregates.cc',
                 'service/paxos/proposal.cc',
                 'service/paxos/prepare_response.cc',
                 'service/paxos/paxos_state.cc',
@@ -887,6 +894,7 @@ pure_boost_tests = set([
     'test/boost/auth_passwords_test',
     'test/boost/auth_resource_test',
     'test/boost/big_decimal_test',
+    'test/boost/bptree_test',
     'test/boost/caching_options_test',
     'test/boost/cartesian_product_test',
     'test/boost/checksum_utils_test',
@@ -912,6 +920,7 @@ pure_boost_tests = set([
     'test/boost/serialization_test',
     'test/boost/small_vector_test',
     'test/boost/top_k_test',
+    'test/boost/tournament_tree_test',
     'test/boost/vint_serialization_test',
     'test/manual/json_test',
     'test/manual/streaming_histogram_test',
@@ -919,9 +928,12 @@ pure_boost_tests = set([
 
 tests_not_using_seastar_test_framework = set([
     'test/boost/small_vector_test',
+    'test/boost/tournament_tree_test',
     'test/manual/gossip',
     'test/manual/message',
+    'test/perf/perf_bloom_filter',
     'test/perf/perf_cache_eviction',
+    'test/perf/perf_commitlog',
     'test/perf/perf_cql_parser',
     'test/perf/perf_hash',
     'test/perf/perf_mutation',
@@ -964,6 +976,7 @@ deps['test/boost/murmur_hash_test'] = ['bytes.cc', 'utils/murmur_hash.cc', 'test
 deps['test/boost/allocation_strategy_test'] = ['test/boost/allocation_strategy_test.cc', 'utils/logalloc.cc', 'utils/dynamic_bitset.cc']
 deps['test/boost/log_heap_test'] = ['test/boost/log_heap_test.cc']
 deps['test/boost/anchorless_list_test'] = ['test/boost/anchorless_list_test.cc']
+deps['test/boost/bptree_test'] = ['test/boost/bptree_test.cc', 'utils/logalloc.cc', 'utils/dynamic_bitset.cc']
 deps['test/perf/perf_fast_forward'] += ['release.cc']
 deps['test/perf/perf_simple_query'] += ['release.cc']
 deps['test/boost/meta_test'] = ['test/boost/meta_test.cc']
@@ -971,6 +984,7 @@ deps['test/manual/imr_test'] = ['test/manual/imr_test.cc', 'utils/logalloc.cc',
 deps['test/boost/reusable_buffer_test'] = ['test/boost/reusable_buffer_test.cc']
 deps['test/boost/utf8_test'] = ['utils/utf8.cc', 'test/boost/utf8_test.cc']
 deps['test/boost/small_vector_test'] = ['test/boost/small_vector_test.cc']
+deps['test/boost/tournament_tree_test'] = ['test/boost/tournament_tree_test.cc']
 deps['test/boost/multishard_mutation_query_test'] += ['test/boost/test_table.cc']
 deps['test/boost/vint_serialization_test'] = ['test/boost/vint_serialization_test.cc', 'vint-serialization.cc', 'bytes.cc']
 deps['test/boost/linearizing_input_stream_test'] = ['test/boost/linearizing_input_stream_test.cc']
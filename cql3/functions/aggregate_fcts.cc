@@ -40,6 +40,8 @@
  */
 
 
+#include <seastar/core/byteorder.hh>
+
 #include "utils/big_decimal.hh"
 #include "aggregate_fcts.hh"
 #include "functions.hh"
@@ -63,6 +65,12 @@ class impl_count_function : public aggregate_function::aggregate {
     virtual void add_input(cql_serialization_format sf, const std::vector<opt_bytes>& values) override {
         ++_count;
     }
+    virtual opt_bytes get_state(cql_serialization_format sf) override {
+        return long_type->decompose(_count);
+    }
+    virtual void merge_state(cql_serialization_format sf, const opt_bytes& state) override {
+        _count += value_cast<int64_t>(long_type->deserialize(*state));
+    }
 };
 
 class count_rows_function final : public native_aggregate_function {
@@ -77,7 +85,9 @@ class count_rows_function final : public native_aggregate_function {
 };
 
 // We need a wider accumulator for sum and average,
-// since summing the inputs can overflow the input type
+// since summing the inputs can overflow the input type.
+// The accumulator is also the state exchanged by partial aggregates,
+// so that only the final result is narrowed.
 template <typename T>
 struct accumulator_for;
 
@@ -92,6 +102,20 @@ struct int128_accumulator_for {
         }
         return ret;
     }
+
+    static bytes serialize(type acc) {
+        bytes b(bytes::initialized_later(), 2 * sizeof(uint64_t));
+        auto u = static_cast<unsigned __int128>(acc);
+        write_be<uint64_t>(reinterpret_cast<char*>(b.begin()), uint64_t(u >> 64));
+        write_be<uint64_t>(reinterpret_cast<char*>(b.begin()) + sizeof(uint64_t), uint64_t(u));
+        return b;
+    }
+
+    static type deserialize(bytes_view b) {
+        auto hi = read_be<uint64_t>(reinterpret_cast<const char*>(b.begin()));
+        auto lo = read_be<uint64_t>(reinterpret_cast<const char*>(b.begin()) + sizeof(uint64_t));
+        return static_cast<type>((static_cast<unsigned __int128>(hi) << 64) | lo);
+    }
 };
 
 template <typename T>
@@ -101,6 +125,14 @@ struct same_type_accumulator_for {
     static T narrow(type acc) {
         return acc;
     }
+
+    static bytes serialize(type acc) {
+        return data_type_for<T>()->decompose(acc);
+    }
+
+    static type deserialize(bytes_view b) {
+        return value_cast<T>(data_type_for<T>()->deserialize(b));
+    }
 };
 
 template <typename T>
@@ -126,6 +158,12 @@ class impl_sum_function_for final : public aggregate_function::aggregate {
         }
         _sum += value_cast<Type>(data_type_for<Type>()->deserialize(*values[0]));
     }
+    virtual opt_bytes get_state(cql_serialization_format sf) override {
+        return accumulator_for<Type>::serialize(_sum);
+    }
+    virtual void merge_state(cql_serialization_format sf, const opt_bytes& state) override {
+        _sum += accumulator_for<Type>::deserialize(*state);
+    }
 };
 
 template <typename Type>
@@ -184,6 +222,20 @@ class impl_avg_function_for final : public aggregate_function::aggregate {
         ++_count;
         _sum += value_cast<Type>(data_type_for<Type>()->deserialize(*values[0]));
     }
+    // The state is the count followed by the sum.
+    virtual opt_bytes get_state(cql_serialization_format sf) override {
+        auto sum = accumulator_for<Type>::serialize(_sum);
+        bytes state(bytes::initialized_later(), sizeof(int64_t) + sum.size());
+        write_be<int64_t>(reinterpret_cast<char*>(state.begin()), _count);
+        std::copy(sum.begin(), sum.end(), state.begin() + sizeof(int64_t));
+        return state;
+    }
+    virtual void merge_state(cql_serialization_format sf, const opt_bytes& state) override {
+        bytes_view v(*state);
+        _count += read_be<int64_t>(reinterpret_cast<const char*>(v.begin()));
+        v.remove_prefix(sizeof(int64_t));
+        _sum += accumulator_for<Type>::deserialize(v);
+    }
 };
 
 template <typename Type>
@@ -265,6 +317,12 @@ class impl_max_function_for final : public aggregate_function::aggregate {
             _max = max_wrapper(*_max, val);
         }
     }
+    virtual opt_bytes get_state(cql_serialization_format sf) override {
+        return compute(sf);
+    }
+    virtual void merge_state(cql_serialization_format sf, const opt_bytes& state) override {
+        add_input(sf, {state});
+    }
 };
 
 /// The same as `impl_max_function_for' but without knowledge of `Type'.
@@ -286,6 +344,12 @@ class impl_max_dynamic_function final : public aggregate_function::aggregate {
             _max = val;
         }
     }
+    virtual opt_bytes get_state(cql_serialization_format sf) override {
+        return _max;
+    }
+    virtual void merge_state(cql_serialization_format sf, const opt_bytes& state) override {
+        add_input(sf, {state});
+    }
 };
 
 template <typename Type>
@@ -356,6 +420,12 @@ class impl_min_function_for final : public aggregate_function::aggregate {
             _min = min_wrapper(*_min, val);
         }
     }
+    virtual opt_bytes get_state(cql_serialization_format sf) override {
+        return compute(sf);
+    }
+    virtual void merge_state(cql_serialization_format sf, const opt_bytes& state) override {
+        add_input(sf, {state});
+    }
 };
 
 /// The same as `impl_min_function_for' but without knowledge of `Type'.
@@ -377,6 +447,12 @@ class impl_min_dynamic_function final : public aggregate_function::aggregate {
             _min = val;
         }
     }
+    virtual opt_bytes get_state(cql_serialization_format sf) override {
+        return _min;
+    }
+    virtual void merge_state(cql_serialization_format sf, const opt_bytes& state) override {
+        add_input(sf, {state});
+    }
 };
 
 template <typename Type>
@@ -425,6 +501,12 @@ class impl_count_function_for final : public aggregate_function::aggregate {
         }
         ++_count;
     }
+    virtual opt_bytes get_state(cql_serialization_format sf) override {
+        return long_type->decompose(_count);
+    }
+    virtual void merge_state(cql_serialization_format sf, const opt_bytes& state) override {
+        _count += value_cast<int64_t>(long_type->deserialize(*state));
+    }
 };
 
 template <typename Type>
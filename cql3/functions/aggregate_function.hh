@@ -91,6 +91,30 @@ class aggregate_function : public virtual function {
          * Reset this aggregate.
          */
         virtual void reset() = 0;
+
+        /**
+         * Returns the intermediate state of this aggregate, which can be
+         * combined with the state of other aggregates of the same function
+         * with merge_state(). This allows computing an aggregate over disjoint
+         * parts of its input separately, e.g. on each replica, and combining
+         * the results later.
+         *
+         * The state is not the value returned by compute(), e.g. the state of
+         * an average is the sum and the count of its inputs.
+         *
+         * @param protocol_version native protocol version
+         * @return the aggregate current state.
+         */
+        virtual opt_bytes get_state(cql_serialization_format sf) = 0;
+
+        /**
+         * Combines the specified state, returned by get_state() of another
+         * aggregate of the same function, with the state of this aggregate.
+         *
+         * @param protocol_version native protocol version
+         * @param state the state to merge into this aggregate.
+         */
+        virtual void merge_state(cql_serialization_format sf, const opt_bytes& state) = 0;
     };
 };
 
@@ -101,6 +101,21 @@ abstract_function_selector::new_factory(shared_ptr<functions::function> fun, sha
         virtual bool is_aggregate_selector_factory() const override {
             return _fun->is_aggregate() || _factories->contains_only_aggregate_functions();
         }
+
+        virtual std::optional<aggregate_of_columns> get_aggregate_of_columns() const override {
+            if (!_fun->is_aggregate()) {
+                return std::nullopt;
+            }
+            aggregate_of_columns ret{dynamic_pointer_cast<functions::aggregate_function>(_fun), {}};
+            for (auto&& arg : *_factories) {
+                auto idx = arg->selected_column_index();
+                if (!idx) {
+                    return std::nullopt;
+                }
+                ret.column_indexes.push_back(*idx);
+            }
+            return ret;
+        }
     };
 
     return make_shared<fun_selector_factory>(std::move(fun), std::move(factories));
@@ -173,6 +173,21 @@ class selection_with_processing : public selection {
     virtual bool is_aggregate() const override {
         return _factories->does_aggregation();
     }
+
+    virtual std::optional<std::vector<aggregate_of_columns>> get_aggregates_of_columns() const override {
+        if (!_factories->does_aggregation()) {
+            return std::nullopt;
+        }
+        std::vector<aggregate_of_columns> ret;
+        for (auto&& factory : *_factories) {
+            auto aggregate = factory->get_aggregate_of_columns();
+            if (!aggregate) {
+                return std::nullopt;
+            }
+            ret.push_back(std::move(*aggregate));
+        }
+        return ret;
+    }
 protected:
     class selectors_with_processing : public selectors {
     private:
@@ -212,6 +212,14 @@ class selection {
 
     virtual bool is_aggregate() const = 0;
 
+    /**
+     * Returns the aggregate functions and their argument columns, if every selector of this selection applies
+     * an aggregate function directly to the values of columns, e.g. <code>SELECT count(*), max(v)</code>.
+     */
+    virtual std::optional<std::vector<aggregate_of_columns>> get_aggregates_of_columns() const {
+        return std::nullopt;
+    }
+
     /**
      * Checks that selectors are either all aggregates or that none of them is.
      *
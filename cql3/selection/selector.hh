@@ -43,6 +43,7 @@
 
 #include <vector>
 #include "cql3/assignment_testable.hh"
+#include "cql3/functions/aggregate_function.hh"
 #include "types.hh"
 #include "schema.hh"
 
@@ -119,6 +120,18 @@ class selector : public assignment_testable {
     }
 };
 
+/**
+ * An aggregate function applied to the values of columns, as opposed to
+ * the results of other functions.
+ */
+struct aggregate_of_columns {
+    shared_ptr<functions::aggregate_function> function;
+    /**
+     * The indexes, in the selection, of the columns passed as arguments.
+     */
+    std::vector<uint32_t> column_indexes;
+};
+
 /**
  * A factory for <code>selector</code> instances.
  */
@@ -190,6 +203,22 @@ class selector::factory {
      * @return the selector output type
      */
     virtual data_type get_return_type() const = 0;
+
+    /**
+     * Returns the index, in the selection, of the column whose values the selector instances created by this
+     * factory return unchanged, if they do.
+     */
+    virtual std::optional<uint32_t> selected_column_index() const {
+        return std::nullopt;
+    }
+
+    /**
+     * Returns the aggregate function and its argument columns, if the selector instances created by this factory
+     * apply an aggregate function directly to the values of columns.
+     */
+    virtual std::optional<aggregate_of_columns> get_aggregate_of_columns() const {
+        return std::nullopt;
+    }
 };
 
 }
@@ -68,6 +68,10 @@ class simple_selector_factory : public selector::factory {
         return _type;
     }
 
+    virtual std::optional<uint32_t> selected_column_index() const override {
+        return _idx;
+    }
+
     virtual ::shared_ptr<selector> new_instance() const override;
 };
 
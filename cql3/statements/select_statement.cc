@@ -58,6 +58,9 @@
 #include "db/timeout_clock.hh"
 #include "db/consistency_level_validations.hh"
 #include "database.hh"
+#include "service/storage_service.hh"
+#include "service/partial_aggregates.hh"
+#include "cql3/functions/functions.hh"
 #include <boost/algorithm/cxx11/any_of.hpp>
 
 bool is_system_keyspace(const sstring& name);
@@ -153,6 +156,32 @@ select_statement::select_statement(schema_ptr schema,
     _opts.set_if<query::partition_slice::option::bypass_cache>(_parameters->bypass_cache());
     _opts.set_if<query::partition_slice::option::distinct>(_parameters->is_distinct());
     _opts.set_if<query::partition_slice::option::reversed>(_is_reversed);
+
+    // Aggregates of atomic columns, by functions every node can look up, can
+    // be computed by the replicas and only their states sent back.
+    auto aggregates = _selection->get_aggregates_of_columns();
+    if (aggregates && !has_group_by() && !_parameters->is_distinct()) {
+        std::vector<query::partial_aggregate> partial_aggregates;
+        for (auto&& aggregate : *aggregates) {
+            auto&& function = *aggregate.function;
+            if (!functions::functions::find(function.name(), function.arg_types())) {
+                return;
+            }
+            query::partial_aggregate partial_aggregate{function.name().keyspace, function.name().name, {}, {}};
+            for (auto&& type : function.arg_types()) {
+                partial_aggregate.argument_types.push_back(type->name());
+            }
+            for (auto idx : aggregate.column_indexes) {
+                auto&& def = *_selection->get_columns()[idx];
+                if (def.type->is_multi_cell() || def.is_counter()) {
+                    return;
+                }
+                partial_aggregate.argument_columns.push_back(def.name());
+            }
+            partial_aggregates.push_back(std::move(partial_aggregate));
+        }
+        _partial_aggregates = std::move(partial_aggregates);
+    }
 }
 
 bool select_statement::uses_function(const sstring& ks_name, const sstring& function_name) const {
@@ -352,6 +381,10 @@ select_statement::do_execute(service::storage_proxy& proxy,
         return execute(proxy, command, std::move(key_ranges), state, options, now);
     }
 
+    if (can_use_partial_aggregates(options, *command, restrictions_need_filtering)) {
+        return execute_with_partial_aggregates(proxy, command, std::move(key_ranges), state, options);
+    }
+
     command->slice.options.set<query::partition_slice::option::allow_short_read>();
     auto timeout_duration = options.get_timeout_config().*get_timeout_config_selector();
     auto p = service::pager::query_pagers::pager(_schema, _selection,
@@ -651,6 +684,40 @@ select_statement::execute(service::storage_proxy& proxy,
     }
 }
 
+bool select_statement::can_use_partial_aggregates(const query_options& options, const query::read_command& cmd,
+        bool restrictions_need_filtering) const {
+    // States of partial aggregates cannot be reconciled, so only consistency
+    // levels which read from a single replica qualify.
+    auto cl = options.get_consistency();
+    // Replicas aggregate their ranges independently, so they can't tell when
+    // a limit is reached across all of them.
+    auto limited = cmd.row_limit != query::max_rows || cmd.partition_limit != query::max_partitions
+            || cmd.slice.partition_row_limit() != query::max_rows;
+    return _partial_aggregates && !restrictions_need_filtering && !limited
+            && (cl == db::consistency_level::ONE || cl == db::consistency_level::LOCAL_ONE)
+            && service::get_local_storage_service().cluster_supports_partial_aggregates();
+}
+
+future<shared_ptr<cql_transport::messages::result_message>>
+select_statement::execute_with_partial_aggregates(service::storage_proxy& proxy,
+                          lw_shared_ptr<query::read_command> cmd,
+                          dht::partition_range_vector&& partition_ranges,
+                          service::query_state& state,
+                          const query_options& options) const
+{
+    // Applies to each of the requests the scan is split into, like the timeout of each page on the paged path.
+    auto timeout = options.get_timeout_config().*get_timeout_config_selector();
+    return proxy.query_partial_aggregates(_schema, cmd, std::move(partition_ranges), *_partial_aggregates,
+            options.get_consistency(), timeout, state.get_trace_state()).then([this, &options] (std::vector<bytes_opt> states) {
+        service::partial_aggregates aggregates(*_schema, *_partial_aggregates, options.get_cql_serialization_format());
+        aggregates.merge(states);
+        auto rs = std::make_unique<result_set>(::make_shared<metadata>(*_selection->get_result_metadata()));
+        rs->add_row(aggregates.compute());
+        update_stats_rows_read(rs->size());
+        return shared_ptr<cql_transport::messages::result_message>(::make_shared<cql_transport::messages::result_message::rows>(result(std::move(rs))));
+    });
+}
+
 future<shared_ptr<cql_transport::messages::result_message>>
 indexed_table_select_statement::process_base_query_results(
         foreign_ptr<lw_shared_ptr<query::result>> results,
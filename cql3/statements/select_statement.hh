@@ -97,10 +97,20 @@ class select_statement : public cql_statement {
     bool _full_scan = false;
     bool _full_scan_no_bypass_cache = false;
     bool _range_scan = false;
+    /**
+     * The aggregates of the selection, if they can be computed by the replicas.
+     */
+    std::optional<std::vector<query::partial_aggregate>> _partial_aggregates;
 protected :
     virtual future<::shared_ptr<cql_transport::messages::result_message>> do_execute(service::storage_proxy& proxy,
         service::query_state& state, const query_options& options) const;
     friend class select_statement_executor;
+
+    bool can_use_partial_aggregates(const query_options& options, const query::read_command& cmd, bool restrictions_need_filtering) const;
+
+    future<::shared_ptr<cql_transport::messages::result_message>> execute_with_partial_aggregates(service::storage_proxy& proxy,
+        lw_shared_ptr<query::read_command> cmd, dht::partition_range_vector&& partition_ranges, service::query_state& state,
+        const query_options& options) const;
 public:
     select_statement(schema_ptr schema,
             uint32_t bound_terms,
@@ -117,10 +117,15 @@ make_flush_controller(const db::config& cfg, seastar::scheduling_group sg, const
 inline
 std::unique_ptr<compaction_manager>
 make_compaction_manager(const db::config& cfg, database_config& dbcfg) {
+    std::unique_ptr<compaction_manager> cm;
     if (cfg.compaction_static_shares() > 0) {
-        return std::make_unique<compaction_manager>(dbcfg.compaction_scheduling_group, service::get_local_compaction_priority(), dbcfg.available_memory, cfg.compaction_static_shares());
+        cm = std::make_unique<compaction_manager>(dbcfg.compaction_scheduling_group, service::get_local_compaction_priority(), dbcfg.available_memory, cfg.compaction_static_shares());
+    } else {
+        cm = std::make_unique<compaction_manager>(dbcfg.compaction_scheduling_group, service::get_local_compaction_priority(), dbcfg.available_memory);
     }
-    return std::make_unique<compaction_manager>(dbcfg.compaction_scheduling_group, service::get_local_compaction_priority(), dbcfg.available_memory);
+    cm->set_tombstone_compaction_check_interval(std::chrono::seconds(cfg.tombstone_compaction_check_interval_in_s()));
+    cm->set_compaction_boost_thresholds(cfg.compaction_boost_sstable_count_threshold(), cfg.compaction_boost_overlapping_sstables_threshold());
+    return cm;
 }
 
 lw_shared_ptr<keyspace_metadata>
@@ -218,7 +223,11 @@ database::database(const db::config& cfg, database_config dbcfg, service::migrat
     local_schema_registry().init(*this); // TODO: we're never unbound.
     setup_metrics();
 
+    _querier_cache.set_range_scan_entry_ttl(std::chrono::seconds(_cfg.range_scan_querier_ttl_in_s()));
+    _querier_cache.set_read_ahead_size(size_t(_cfg.range_scan_read_ahead_in_kb()) * 1024);
+
     _row_cache_tracker.set_compaction_scheduling_group(dbcfg.memory_compaction_scheduling_group);
+    sstables::index_page_cache_tracker::shard_tracker().set_max_memory(dbcfg.available_memory * 0.02);
 
     dblog.debug("Row: max_vector_size: {}, internal_count: {}", size_t(row::max_vector_size), size_t(row::internal_count));
 }
@@ -401,6 +410,25 @@ database::setup_metrics() {
         sm::make_gauge("querier_cache_population", _querier_cache.get_stats().population,
                        sm::description("The number of entries currently in the querier cache.")),
 
+        sm::make_gauge("querier_cache_memory_usage", _querier_cache.get_stats().memory_usage,
+                       sm::description("The memory used by the entries currently in the querier cache, including the memory reserved for read-ahead.")),
+
+        sm::make_derive("querier_cache_read_aheads", _querier_cache.get_stats().read_aheads,
+                       sm::description("Counts range scan queriers which started reading the next page in the background when they were cached.")),
+
+        sm::make_derive("multishard_reader_fills", [] { return get_multishard_reader_stats().cross_shard_fills; },
+                       sm::description("Counts the round trips multishard readers made to shards to fill their buffers.")),
+
+        sm::make_derive("multishard_reader_fill_bytes", [] { return get_multishard_reader_stats().cross_shard_fill_bytes; },
+                       sm::description("Counts the bytes of fragments multishard readers received from shards.")),
+
+        sm::make_derive("multishard_reader_stalls", [] { return get_multishard_reader_stats().cross_shard_stalls; },
+                       sm::description("Counts the times multishard readers had to wait for a round trip to a shard, "
+                                       "because its read-ahead did not keep up.")),
+
+        sm::make_derive("multishard_reader_stall_time_us", [] { return get_multishard_reader_stats().cross_shard_stall_time.count(); },
+                       sm::description("Total time multishard readers spent waiting for round trips to shards, in microseconds.")),
+
         sm::make_derive("sstable_read_queue_overloads", _stats->sstable_read_queue_overloaded,
                        sm::description("Counts the number of times the sstable read queue was overloaded. "
                                        "A non-zero value indicates that we have to drop read requests because they arrive faster than we can serve them.")),
@@ -1707,9 +1735,10 @@ database::stop() {
     assert(_large_data_handler->stopped());
     assert(_compaction_manager->stopped());
 
-    // try to ensure that CL has done disk flushing
-    future<> maybe_shutdown_commitlog = _commitlog != nullptr ? _commitlog->shutdown() : make_ready_future<>();
-    return maybe_shutdown_commitlog.then([this] {
+    return _querier_cache.stop().then([this] {
+        // try to ensure that CL has done disk flushing
+        return _commitlog != nullptr ? _commitlog->shutdown() : make_ready_future<>();
+    }).then([this] {
         return _view_update_concurrency_sem.wait(max_memory_pending_view_updates());
     }).then([this] {
         if (_commitlog != nullptr) {
@@ -338,6 +338,10 @@ struct table_stats {
     int64_t pending_compactions = 0;
     int64_t memtable_partition_insertions = 0;
     int64_t memtable_partition_hits = 0;
+    /** Number of sstable bloom filter probes done by single-partition reads */
+    int64_t bloom_filter_checks = 0;
+    /** Number of those probes which excluded the sstable from the read */
+    int64_t bloom_filter_negatives = 0;
     mutation_application_stats memtable_app_stats;
     utils::timed_rate_moving_average_and_histogram reads{256};
     utils::timed_rate_moving_average_and_histogram writes{256};
@@ -476,6 +480,9 @@ class table : public enable_lw_shared_from_this<table> {
     // sstables that should not be compacted (e.g. because they need to be used
     // to generate view updates later)
     std::unordered_map<uint64_t, sstables::shared_sstable> _sstables_staging;
+    // Compressor bound to the dictionary of the most recently added sstable which has one.
+    // Memtable flushes reuse it instead of training a dictionary on their own data.
+    compressor_ptr _compression_dictionary;
     // Control background fibers waiting for sstables to be deleted
     seastar::gate _sstable_deletion_gate;
     // This semaphore ensures that an operation like snapshot won't have its selected
@@ -598,6 +605,11 @@ class table : public enable_lw_shared_from_this<table> {
 
     void rebuild_statistics();
 
+    // Replaces compacted sstables by the ones they were compacted into, and releases the
+    // compaction's reference to them. Must run in a seastar thread.
+    void replace_compacted_sstables(std::vector<sstables::shared_sstable> old_sstables, std::vector<sstables::shared_sstable> new_sstables,
+        const std::function<void(const std::vector<sstables::shared_sstable>&)>& release_exhausted);
+
     // This function replaces new sstables by their ancestors, which are sstables that needed resharding.
     void replace_ancestors_needed_rewrite(std::unordered_set<uint64_t> ancestors, std::vector<sstables::shared_sstable> new_sstables);
     void remove_ancestors_needed_rewrite(std::unordered_set<uint64_t> ancestors);
@@ -616,6 +628,13 @@ class table : public enable_lw_shared_from_this<table> {
                                         streamed_mutation::forwarding fwd,
                                         mutation_reader::forwarding fwd_mr) const;
 
+    // Adds the result of a single-partition query to the builder straight from
+    // cache, see row_cache::read_if_continuous(). Returns false if the query
+    // has to read through a querier instead.
+    bool query_from_cache(const schema_ptr& s, const dht::partition_range& range, const query::partition_slice& slice,
+            uint32_t row_limit, gc_clock::time_point query_time, query::result::builder& builder,
+            const query::querier_cache_context& cache_ctx, const tracing::trace_state_ptr& trace_state);
+
     snapshot_source sstables_as_snapshot_source();
     partition_presence_checker make_partition_presence_checker(lw_shared_ptr<sstables::sstable_set>);
     std::chrono::steady_clock::time_point _sstable_writes_disabled_at;
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "serializer.hh"
+#include "db/extensions.hh"
+#include "exceptions/exceptions.hh"
+#include "schema.hh"
+#include "utils/i_filter.hh"
+
+namespace db {
+
+// Table option selecting the layout of the bloom filter of sstables written for the table:
+//
+//   ALTER TABLE ks.cf WITH bloom_filter_format = 'split_block';
+//
+// 'classic' (the default) is the Cassandra compatible filter, 'split_block' is the
+// cache-line blocked filter, see utils::filter::split_block_bloom_filter. Existing
+// sstables keep their format until rewritten.
+class bloom_filter_format_extension : public schema_extension {
+    bool _split_block = false;
+public:
+    static constexpr auto NAME = "bloom_filter_format";
+
+    bloom_filter_format_extension() = default;
+    explicit bloom_filter_format_extension(const sstring& s) : _split_block(parse(s)) {}
+    explicit bloom_filter_format_extension(bytes b) : bloom_filter_format_extension(deserialize(b)) {}
+    explicit bloom_filter_format_extension(const std::map<sstring, sstring>&) {
+        throw exceptions::configuration_exception(format("{} must be a string", NAME));
+    }
+    bytes serialize() const override {
+        return ser::serialize_to_buffer<bytes>(sstring(_split_block ? "split_block" : "classic"));
+    }
+    static sstring deserialize(bytes_view buffer) {
+        return ser::deserialize_from_buffer(buffer, boost::type<sstring>());
+    }
+    static bool parse(const sstring& s) {
+        if (s == "split_block") {
+            return true;
+        }
+        if (s == "classic") {
+            return false;
+        }
+        throw exceptions::configuration_exception(format("Invalid {} '{}', must be either 'classic' or 'split_block'", NAME, s));
+    }
+    bool split_block() const {
+        return _split_block;
+    }
+
+    // Returns the format of the bloom filter of sstables written for the given schema,
+    // classic_format being the format of the classic filter for the sstable version.
+    // Split block filters are written only if allowed, see sstable_writer_config.
+    static utils::filter_format filter_format_for(const schema& s, utils::filter_format classic_format, bool split_block_allowed) {
+        if (!split_block_allowed) {
+            return classic_format;
+        }
+        auto it = s.extensions().find(NAME);
+        if (it == s.extensions().end() || it->second->is_placeholder()) {
+            return classic_format;
+        }
+        auto ext = static_pointer_cast<bloom_filter_format_extension>(it->second);
+        return ext->split_block() ? utils::filter_format::split_block : classic_format;
+    }
+};
+
+}
@@ -77,6 +77,7 @@
 #include "commitlog_entry.hh"
 #include "commitlog_extensions.hh"
 #include "service/priority_manager.hh"
+#include "compress.hh"
 
 #include <boost/range/numeric.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -129,9 +130,18 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     c.commitlog_segment_size_in_mb = cfg.commitlog_segment_size_in_mb();
     c.commitlog_sync_period_in_ms = cfg.commitlog_sync_period_in_ms();
     c.mode = cfg.commitlog_sync() == "batch" ? sync_mode::BATCH : sync_mode::PERIODIC;
+    c.batch_window = std::chrono::milliseconds(cfg.commitlog_sync_batch_window_in_ms());
     c.extensions = &cfg.extensions();
     c.reuse_segments = cfg.commitlog_reuse_segments();
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
+    auto compression_name = cfg.commitlog_compression();
+    if (compression_name == "lz4") {
+        c.segment_compression = compression::lz4;
+    } else if (compression_name == "zstd") {
+        c.segment_compression = compression::zstd;
+    } else if (compression_name != "none" && !compression_name.empty()) {
+        throw std::invalid_argument(format("Invalid commitlog_compression '{}', must be one of: none, lz4, zstd", compression_name));
+    }
 
     return c;
 }
@@ -192,10 +202,24 @@ const std::string db::commitlog::descriptor::FILENAME_PREFIX(
         "CommitLog" + SEPARATOR);
 const std::string db::commitlog::descriptor::FILENAME_EXTENSION(".log");
 
+static compressor_ptr make_segment_compressor(db::commitlog::compression c) {
+    switch (c) {
+    case db::commitlog::compression::none:
+        return {};
+    case db::commitlog::compression::lz4:
+        return compressor::lz4;
+    case db::commitlog::compression::zstd:
+        return compressor::create("ZstdCompressor", [] (const sstring&) { return compressor::opt_string(); });
+    }
+    throw db::commitlog::invalid_segment_format();
+}
+
 class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_manager> {
 public:
     config cfg;
     std::vector<sstring> _segments_to_replay;
+    // Compressor of new segments, null if they are not compressed.
+    const compressor_ptr segment_compressor;
     const uint64_t max_size;
     const uint64_t max_mutation_size;
     // Divide the size-on-disk threshold by #cpus used, since we assume
@@ -253,8 +277,11 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         uint64_t allocation_count = 0;
         uint64_t bytes_written = 0;
         uint64_t bytes_slack = 0;
+        uint64_t bytes_compressed_saved = 0;
         uint64_t segments_created = 0;
         uint64_t segments_destroyed = 0;
+        uint64_t segments_recycled = 0;
+        uint64_t group_commit_windows = 0;
         uint64_t pending_flushes = 0;
         uint64_t flush_limit_exceeded = 0;
         uint64_t total_size = 0;
@@ -281,6 +308,27 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         _flush_semaphore.signal();
         --totals.pending_flushes;
     }
+
+    // Group commit in batch mode: an entry arriving at an idle segment may wait
+    // a bit for concurrent entries, so that they all share a single write+sync.
+    // Waiting only pays off if there is someone to wait for and if it saves a
+    // sync which is expensive compared to the wait, so the window is derived
+    // from the (moving) average size of recent groups and sync latency.
+    using group_commit_clock = std::chrono::steady_clock;
+    double _avg_group_size = 1;
+    double _avg_sync_latency_us = 0;
+
+    std::chrono::microseconds group_commit_window() const {
+        if (_avg_group_size < 2) {
+            return std::chrono::microseconds(0);
+        }
+        return std::min(cfg.batch_window, std::chrono::microseconds(int64_t(_avg_sync_latency_us / 2)));
+    }
+    void note_group_commit(uint64_t entries, group_commit_clock::duration latency) {
+        static constexpr double alpha = 0.2;
+        _avg_group_size += alpha * (double(entries) - _avg_group_size);
+        _avg_sync_latency_us += alpha * (std::chrono::duration<double, std::micro>(latency).count() - _avg_sync_latency_us);
+    }
     segment_manager(config c);
     ~segment_manager() {
         clogger.trace("Commitlog {} disposed", cfg.commit_log_location);
@@ -304,7 +352,7 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     future<sseg_ptr> new_segment();
     future<sseg_ptr> active_segment(db::timeout_clock::time_point timeout);
     future<sseg_ptr> allocate_segment();
-    future<sseg_ptr> allocate_segment_ex(const descriptor&, sstring filename, open_flags);
+    future<sseg_ptr> allocate_segment_ex(const descriptor&, sstring filename, open_flags, bool prezeroed = false);
 
     sstring filename(const descriptor& d) const {
         return cfg.commit_log_location + "/" + d.filename();
@@ -345,6 +393,8 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
 
     buffer_type acquire_buffer(size_t s);
     temporary_buffer<char> allocate_single_buffer(size_t);
+    // Scratch space for compressing a single buffer fragment.
+    temporary_buffer<char> _compression_buffer;
 
     future<std::vector<descriptor>> list_descriptors(sstring dir);
 
@@ -368,6 +418,9 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     std::vector<sseg_ptr> _segments;
     queue<sseg_ptr> _reserve_segments;
     std::deque<sstring> _recycled_segments;
+    // Segment files (live or recycled) whose whole extent has already been
+    // written, and thus do not need to be zeroed again before O_DSYNC reuse.
+    std::unordered_set<sstring> _prezeroed_segments;
     std::unordered_map<flush_handler_id, flush_handler> _flush_handlers;
     flush_handler_id _flush_ids = 0;
     replay_position _flush_position;
@@ -441,8 +494,13 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     file _file;
     sstring _file_name;
 
+    // Positions (of replay_positions, i.e. _file_pos, _flush_pos and position())
+    // are offsets in the segment as if it was not compressed. _disk_pos is the
+    // actual size of the file written so far, the same as _file_pos unless the
+    // segment is compressed.
     uint64_t _file_pos = 0;
     uint64_t _flush_pos = 0;
+    uint64_t _disk_pos = 0;
 
     bool _closed = false;
     // Not the same as _closed since files can be reused
@@ -460,6 +518,8 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     std::unordered_map<cf_id_type, uint64_t> _cf_dirty;
     time_point _sync_time;
     utils::flush_queue<replay_position, std::less<replay_position>, clock_type> _pending_ops;
+    // The group commit window currently open, if any. See segment_manager::group_commit_window().
+    std::optional<shared_future<>> _group_commit;
 
     uint64_t _num_allocs = 0;
 
@@ -498,6 +558,18 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     // The commit log (chained) sync marker/header size in bytes (int: length + int: checksum [segmentId, position])
     static constexpr size_t sync_marker_size = 2 * sizeof(uint32_t);
 
+    // Compressed segments have a version 2 descriptor. The file header also holds
+    // the compression (int: magic + int: version + long: id + int: compression + int: checksum)
+    // and each chunk starts with a larger header (int: next chunk + int: data position +
+    // int: data size + int: compressed size + int: checksum [segmentId, chunk, next, position, sizes]).
+    // Chunk data, i.e. the entries in the same format as in uncompressed segments, is compressed
+    // in blocks, one per buffer fragment (int: size + int: compressed size + compressed data).
+    // If that would not save anything, the data is stored as is and compressed size == data size.
+    static constexpr uint32_t compressed_segment_version = 2;
+    static constexpr size_t compressed_descriptor_header_size = 6 * sizeof(uint32_t);
+    static constexpr size_t compressed_segment_overhead_size = 5 * sizeof(uint32_t);
+    static constexpr size_t compressed_block_header_size = 2 * sizeof(uint32_t);
+
     static constexpr size_t alignment = 4096;
     // TODO : tune initial / default size
     static constexpr size_t default_size = align_up<size_t>(128 * 1024, alignment);
@@ -510,6 +582,16 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         ++_segment_manager->totals.segments_created;
         clogger.debug("Created new segment {}", *this);
     }
+
+    bool compressed() const {
+        return _desc.ver >= compressed_segment_version;
+    }
+    size_t file_header_size() const {
+        return compressed() ? compressed_descriptor_header_size : descriptor_header_size;
+    }
+    size_t chunk_header_size() const {
+        return compressed() ? compressed_segment_overhead_size : segment_overhead_size;
+    }
     ~segment() {
         if (!_closed_file) {
             _segment_manager->add_file_to_close(std::move(_file));
@@ -518,7 +600,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             clogger.debug("Segment {} is no longer active and will submitted for delete now", *this);
             ++_segment_manager->totals.segments_destroyed;
             _segment_manager->totals.total_size_on_disk -= size_on_disk();
-            _segment_manager->totals.total_size -= (size_on_disk() + _buffer.size_bytes());
+            _segment_manager->totals.total_size -= (_file_pos + _buffer.size_bytes());
             _segment_manager->add_file_to_delete(_file_name, _desc);
         } else {
             clogger.warn("Segment {} is dirty and is left on disk.", *this);
@@ -580,7 +662,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             // When we get here, nothing should add ops,
             // and we should have waited out all pending.
             return me->_pending_ops.close().finally([me] {
-                return me->_file.truncate(me->_flush_pos).then([me] {
+                // Everything was flushed by close(), compressed segments do not
+                // know the size of the file at _flush_pos, but it is _disk_pos now.
+                return me->_file.truncate(me->compressed() ? me->_disk_pos : me->_flush_pos).then([me] {
                     return me->_file.close().finally([me] { me->_closed_file = true; });
                 });
             });
@@ -633,7 +717,11 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
                 clogger.trace("{} already synced! ({} < {})", *this, pos, _flush_pos);
                 return make_ready_future<>();
             }
-            return _file.flush().then_wrapped([this, pos](future<> f) {
+            // With O_DSYNC every completed write is already on stable storage, and since
+            // the file is fully pre-written there is no metadata to sync either. We only
+            // get here once all writes below pos have completed, so skip the fdatasync.
+            auto synced = _segment_manager->cfg.use_o_dsync ? make_ready_future<>() : _file.flush();
+            return synced.then_wrapped([this, pos](future<> f) {
                 try {
                     f.get();
                     // TODO: retry/ignore/fail/stop - optional behaviour in origin.
@@ -659,9 +747,9 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     void new_buffer(size_t s) {
         assert(_buffer.empty());
 
-        auto overhead = segment_overhead_size;
+        auto overhead = chunk_header_size();
         if (_file_pos == 0) {
-            overhead += descriptor_header_size;
+            overhead += file_header_size();
         }
 
         auto a = align_up(s + overhead, alignment);
@@ -675,8 +763,8 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     }
 
     bool buffer_is_empty() const {
-        return buffer_position() <= segment_overhead_size
-                        || (_file_pos == 0 && buffer_position() <= (segment_overhead_size + descriptor_header_size));
+        return buffer_position() <= chunk_header_size()
+                        || (_file_pos == 0 && buffer_position() <= (chunk_header_size() + file_header_size()));
     }
     /**
      * Send any buffer contents to disk and get a new tmp buffer
@@ -692,6 +780,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         auto off = _file_pos;
         auto top = off + size;
         auto num = _num_allocs;
+        auto disk_off = _disk_pos;
 
         _file_pos = top;
         _buffer_ostream = { };
@@ -713,11 +802,22 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             crc.process(_desc.ver);
             crc.process<int32_t>(_desc.id & 0xffffffff);
             crc.process<int32_t>(_desc.id >> 32);
+            if (compressed()) {
+                write(out, uint32_t(_segment_manager->cfg.segment_compression));
+                crc.process(uint32_t(_segment_manager->cfg.segment_compression));
+            }
             write(out, crc.checksum());
-            header_size = descriptor_header_size;
+            header_size = file_header_size();
         }
 
-        if (!termination) {
+        auto disk_size = size;
+        if (compressed() && !termination) {
+            std::tie(buf, disk_size) = compress_chunk(std::move(buf), size, header_size, off, disk_off);
+
+            forget_schema_versions();
+
+            clogger.trace("Writing {} entries, {} k in {} -> {}, compressed to {} k", num, size, off, off + size, disk_size);
+        } else if (!termination) {
             // write chunk header
             crc32_nbo crc;
             crc.process<int32_t>(_desc.id & 0xffffffff);
@@ -734,14 +834,16 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             assert(num == 0);
             assert(_closed);
             clogger.trace("Terminating {} at pos {}", *this, _file_pos);
-            write(out, uint64_t(0));
+            // zero chunk header, either kind.
+            out.fill('\0', chunk_header_size());
         }
+        _disk_pos = disk_off + disk_size;
 
         replay_position rp(_desc.id, position_type(off));
 
         // The write will be allowed to start now, but flush (below) must wait for not only this,
         // but all previous write/flush pairs.
-        return _pending_ops.run_with_ordered_post_op(rp, [this, size, off, buf = std::move(buf)]() mutable {
+        return _pending_ops.run_with_ordered_post_op(rp, [this, size = disk_size, off = disk_off, logical_size = size, buf = std::move(buf)]() mutable {
             auto view = fragmented_temporary_buffer::view(buf);
             view.remove_suffix(buf.size_bytes() - size);
             assert(size == view.size_bytes());
@@ -777,8 +879,8 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
                         }
                     });
                 });
-            }).finally([this, buf = std::move(buf), size] {
-                    _segment_manager->notify_memory_written(size);
+            }).finally([this, buf = std::move(buf), logical_size] {
+                    _segment_manager->notify_memory_written(logical_size);
             });
         }, [me, flush_after, top, rp] { // lambda instead of bind, so we keep "me" alive.
             assert(me->_pending_ops.has_operation(rp));
@@ -786,18 +888,113 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         });
     }
 
+    /**
+     * Compresses the entries of a chunk of a compressed segment and writes the chunk header.
+     * Returns the buffer to write and the number of bytes of it to write, which is aligned
+     * and never more than size.
+     */
+    std::tuple<buffer_type, size_t> compress_chunk(buffer_type buf, size_t size, size_t header_size, uint64_t off, uint64_t disk_off) {
+        auto data_off = header_size + compressed_segment_overhead_size;
+        auto data_size = size - data_off;
+
+        auto in = fragmented_temporary_buffer::view(buf);
+        in.remove_prefix(data_off);
+        in.remove_suffix(buf.size_bytes() - size);
+
+        auto& compressor = *_segment_manager->segment_compressor;
+        auto& scratch = _segment_manager->_compression_buffer;
+        auto res = _segment_manager->acquire_buffer(size);
+        auto out = res.get_ostream();
+        // headers are written below, once we know which buffer to use.
+        out.write_substream(data_off);
+
+        size_t compressed_size = 0;
+        for (bytes_view frag : in) {
+            auto max = compressor.compress_max_size(frag.size());
+            if (scratch.size() < max) {
+                scratch = temporary_buffer<char>(max);
+            }
+            auto n = compressor.compress(reinterpret_cast<const char*>(frag.data()), frag.size(), scratch.get_write(), max);
+            compressed_size += compressed_block_header_size + n;
+            if (data_off + compressed_size >= size) {
+                break;
+            }
+            write(out, uint32_t(frag.size()));
+            write(out, uint32_t(n));
+            out.write(scratch.get(), n);
+        }
+
+        auto disk_size = size;
+        if (data_off + compressed_size < size) {
+            disk_size = align_up(data_off + compressed_size, alignment);
+            out.fill('\0', disk_size - data_off - compressed_size);
+            // copy the file header, if any.
+            auto hout = res.get_ostream();
+            auto header = fragmented_temporary_buffer::view(buf);
+            header.remove_suffix(buf.size_bytes() - header_size);
+            for (bytes_view frag : header) {
+                hout.write(reinterpret_cast<const char*>(frag.data()), frag.size());
+            }
+            _segment_manager->totals.bytes_compressed_saved += size - disk_size;
+            buf = std::move(res);
+        } else {
+            // Does not compress, keep the data as is.
+            compressed_size = data_size;
+        }
+
+        auto out_hdr = buf.get_ostream();
+        out_hdr.write_substream(header_size);
+
+        crc32_nbo crc;
+        crc.process<int32_t>(_desc.id & 0xffffffff);
+        crc.process<int32_t>(_desc.id >> 32);
+        crc.process(uint32_t(disk_off + header_size));
+        crc.process(uint32_t(disk_off + disk_size));
+        crc.process(uint32_t(off + data_off));
+        crc.process(uint32_t(data_size));
+        crc.process(uint32_t(compressed_size));
+
+        write(out_hdr, uint32_t(disk_off + disk_size));
+        write(out_hdr, uint32_t(off + data_off));
+        write(out_hdr, uint32_t(data_size));
+        write(out_hdr, uint32_t(compressed_size));
+        write(out_hdr, crc.checksum());
+
+        return std::make_tuple(std::move(buf), disk_size);
+    }
+
+    future<> group_commit_window() {
+        if (_group_commit) {
+            return _group_commit->get_future();
+        }
+        // Writes in flight already make the following entries group up
+        // behind them, only open a window when the segment is idle.
+        auto window = _segment_manager->group_commit_window();
+        if (!_pending_ops.empty() || window.count() == 0) {
+            return make_ready_future<>();
+        }
+        ++_segment_manager->totals.group_commit_windows;
+        _group_commit.emplace(seastar::sleep(window).then([me = shared_from_this()] {
+            me->_group_commit = std::nullopt;
+        }));
+        return _group_commit->get_future();
+    }
+
     future<sseg_ptr> batch_cycle(timeout_clock::time_point timeout) {
         /**
          * For batch mode we force a write "immediately".
          * However, we first wait for all previous writes/flushes
-         * to complete.
+         * to complete, and possibly for the group commit window
+         * to let concurrent allocations join.
          *
          * This has the benefit of allowing several allocations to
          * queue up in a single buffer.
          */
         auto me = shared_from_this();
         auto fp = _file_pos;
-        return _pending_ops.wait_for_pending(timeout).then([me, fp, timeout] {
+        return group_commit_window().then([me, timeout] {
+            return me->_pending_ops.wait_for_pending(timeout);
+        }).then([me, fp, timeout] {
             if (fp != me->_file_pos) {
                 // some other request already wrote this buffer.
                 // If so, wait for the operation at our intended file offset
@@ -817,7 +1014,12 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             }
             // It is ok to leave the sync behind on timeout because there will be at most one
             // such sync, all later allocations will block on _pending_ops until it is done.
-            return with_timeout(timeout, me->sync());
+            auto entries = me->_num_allocs;
+            auto start = segment_manager::group_commit_clock::now();
+            return with_timeout(timeout, me->sync().then([entries, start] (sseg_ptr s) {
+                s->_segment_manager->note_group_commit(entries, segment_manager::group_commit_clock::now() - start);
+                return s;
+            }));
         }).handle_exception([me, fp](auto p) {
             // If we get an IO exception (which we assume this is)
             // we should close the segment.
@@ -846,7 +1048,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         }
 
 
-        if (!is_still_allocating() || position() + s > _segment_manager->max_size) { // would we make the file too big?
+        // would we make the file too big? Positions of compressed segments may go past the
+        // size of the file, but must still fit position_type.
+        if (!is_still_allocating() || disk_position() + s > _segment_manager->max_size
+                || _file_pos + buffer_position() + s > std::numeric_limits<position_type>::max()) {
             return finish_and_get_new(timeout).then([id, writer = std::move(writer), permit = std::move(permit), timeout] (auto new_seg) mutable {
                 return new_seg->allocate(id, std::move(writer), std::move(permit), timeout);
             });
@@ -927,8 +1132,13 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         return position_type(_file_pos + buffer_position());
     }
 
+    // Position in the file, differs from position() in compressed segments.
+    uint64_t disk_position() const {
+        return _disk_pos + buffer_position();
+    }
+
     size_t size_on_disk() const {
-        return _file_pos;
+        return _disk_pos;
     }
 
     // ensures no more of this segment is writeable, by allocating any unused section at the end and marking it discarded
@@ -959,7 +1169,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         _cf_dirty.clear();
     }
     bool is_still_allocating() const {
-        return !_closed && position() < _segment_manager->max_size;
+        return !_closed && disk_position() < _segment_manager->max_size;
     }
     bool is_clean() const {
         return _cf_dirty.empty();
@@ -1026,6 +1236,7 @@ db::commitlog::segment_manager::segment_manager(config c)
 
         return cfg;
     }())
+    , segment_compressor(make_segment_compressor(cfg.segment_compression))
     , max_size(std::min<size_t>(std::numeric_limits<position_type>::max(), std::max<size_t>(cfg.commitlog_segment_size_in_mb, 1) * 1024 * 1024))
     , max_mutation_size(max_size >> 1)
     , max_disk_size(size_t(std::ceil(cfg.commitlog_total_space_in_mb / double(smp::count))) * 1024 * 1024)
@@ -1187,6 +1398,18 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
         sm::make_derive("slack", totals.bytes_slack,
                        sm::description("Counts a number of unused bytes written to the disk due to disk segment alignment.")),
 
+        sm::make_derive("bytes_compressed_saved", totals.bytes_compressed_saved,
+                       sm::description("Counts a number of bytes not written to the disk thanks to segment compression.")),
+
+        sm::make_derive("segments_recycled", totals.segments_recycled,
+                       sm::description("Counts a number of segments allocated by reusing a released segment file instead of creating a new one.")),
+
+        sm::make_derive("group_commit_windows", totals.group_commit_windows,
+                       sm::description("Counts a number of times a sync in batch mode was delayed to let concurrent writes join it.")),
+
+        sm::make_gauge("group_commit_window_us", [this] { return group_commit_window().count(); },
+                       sm::description("Holds the current length of the group commit window in batch mode, in microseconds.")),
+
         sm::make_gauge("pending_flushes", totals.pending_flushes,
                        sm::description("Holds a number of currently pending flushes. See the related flush_limit_exceeded metric.")),
 
@@ -1280,7 +1503,7 @@ static auto close_on_failure(future<file> file_fut, Func func) {
     });
 }
 
-future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment_ex(const descriptor& d, sstring filename, open_flags flags) {
+future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment_ex(const descriptor& d, sstring filename, open_flags flags, bool prezeroed) {
     file_open_options opt;
     opt.extent_allocation_size_hint = max_size;
     auto fut = do_io_check(commit_error_handler, [=] {
@@ -1297,14 +1520,18 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
         return fut;
     });
 
-    return close_on_failure(std::move(fut), [this, d, filename, flags] (file f) {
+    return close_on_failure(std::move(fut), [this, d, filename, flags, prezeroed] (file f) {
         f = make_checked_file(commit_error_handler, f);
         // xfs doesn't like files extended betond eof, so enlarge the file
         auto fut = make_ready_future<>();
         // If file is opened with O_DSYNC, we should explicitly write zeros
         // instead of just truncate/fallocate. Otherwise we get crappy
-        // behaviour.
-        if ((flags & open_flags::dsync) != open_flags{}) {
+        // behaviour. A recycled segment that was pre-written before already
+        // has all its extents allocated and written, so we can skip that.
+        if ((flags & open_flags::dsync) != open_flags{} && prezeroed) {
+            clogger.trace("Reusing pre-written segment {}", filename);
+            _prezeroed_segments.emplace(filename);
+        } else if ((flags & open_flags::dsync) != open_flags{}) {
             clogger.trace("Pre-writing {}KB to segment {}", max_size/1024, filename);
             // would be super nice if we just could mmap(/dev/zero) and do sendto
             // instead of this, but for now we must do explicit buffer writes.
@@ -1322,7 +1549,7 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
                         std::vector<iovec> v;
                         v.reserve(n);
                         size_t m = 0;
-                        while (m < rem && n < max_write) {
+                        while (m < rem && v.size() < n) {
                             auto s = std::min(rem - m, buf_size);
                             v.emplace_back(iovec{ buf.get_write(), s});
                             m += s;
@@ -1333,6 +1560,8 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
                         });
                     });
                 });
+            }).then([this, filename] {
+                _prezeroed_segments.emplace(filename);
             });
         } else {
             fut = f.truncate(max_size);
@@ -1353,7 +1582,7 @@ future<> db::commitlog::segment_manager::rename_file(sstring from, sstring to) c
 }
 
 future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment() {
-    descriptor d(next_id(), cfg.fname_prefix);
+    descriptor d(next_id(), cfg.fname_prefix, segment_compressor ? segment::compressed_segment_version : 1);
     auto dst = filename(d);
     auto flags = open_flags::wo;
     if (cfg.use_o_dsync) {
@@ -1363,13 +1592,15 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
     if (!_recycled_segments.empty()) {
         auto src = std::move(_recycled_segments.front());
         _recycled_segments.pop_front();
+        auto prezeroed = _prezeroed_segments.erase(src) != 0;
+        ++totals.segments_recycled;
         // Note: we have to do the rename here to ensure
         // proper descriptor id order. If we renamed in the delete call
         // that recycled the file we could potentially have
         // out-of-order files. (Sort does not help).
         clogger.debug("Using recycled segment file {} -> {}", src, dst);
         return rename_file(std::move(src), dst).then([=] {
-            return allocate_segment_ex(d, dst, flags);
+            return allocate_segment_ex(d, dst, flags, prezeroed);
         });
     }
 
@@ -1508,6 +1739,7 @@ future<> db::commitlog::segment_manager::clear_reserve_segments() {
 
     return parallel_for_each(i, e, [this](const sstring& filename) {
         clogger.debug("Deleting recycled segment file {}", filename);
+        _prezeroed_segments.erase(filename);
         return commit_io_check(&seastar::remove_file, filename);
     }).finally([this, re = std::move(re)] {
         return do_pending_deletes();
@@ -1587,6 +1819,7 @@ future<> db::commitlog::segment_manager::delete_segments(std::vector<sstring> fi
             });
         }
         return f.finally([&] {
+            auto prezeroed = _prezeroed_segments.erase(filename) != 0;
             // We allow reuse of the segment if the current disk size is less than shard max.
             // We however don't know the exact size of this file (or the others on the recycle
             // list, so assume they are max_size large.
@@ -1601,6 +1834,9 @@ future<> db::commitlog::segment_manager::delete_segments(std::vector<sstring> fi
                 // cause header ID to be invalid in the file -> ignored
                 return rename_file(filename, dst).then([=] {
                     _recycled_segments.emplace_back(dst);
+                    if (prezeroed) {
+                        _prezeroed_segments.emplace(dst);
+                    }
                     return make_ready_future<>();
                 }).handle_exception([this, filename](auto&&) {
                     return commit_io_check(&seastar::remove_file, filename);
@@ -1889,6 +2125,8 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
         bool header = true;
         bool failed = false;
         fragmented_temporary_buffer::reader frag_reader;
+        // set for compressed segments
+        compressor_ptr compressor;
 
         work(file f, descriptor din, seastar::io_priority_class read_io_prio_class, position_type o = 0)
                 : f(f), d(din), fin(make_file_input_stream(f, 0, make_file_input_stream_options(read_io_prio_class))), start_off(o) {
@@ -1956,6 +2194,11 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
                 crc.process<int32_t>(id & 0xffffffff);
                 crc.process<int32_t>(id >> 32);
 
+                if (ver >= segment::compressed_segment_version) {
+                    // what we read as the checksum is the compression, the checksum follows.
+                    return read_compression_header(id, checksum, crc);
+                }
+
                 auto cs = crc.checksum();
                 if (cs != checksum) {
                     throw header_checksum_error();
@@ -1967,6 +2210,214 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
                 return make_ready_future<>();
             });
         }
+        future<> read_compression_header(uint64_t id, uint32_t compression, crc32_nbo crc) {
+            return frag_reader.read_exactly(fin, sizeof(uint32_t)).then([this, id, compression, crc] (fragmented_temporary_buffer buf) mutable {
+                if (!advance(buf)) {
+                    throw invalid_segment_format();
+                }
+                auto in = buf.get_istream();
+                auto checksum = read<uint32_t>(in);
+
+                crc.process(compression);
+                if (crc.checksum() != checksum) {
+                    throw header_checksum_error();
+                }
+                this->compressor = make_segment_compressor(db::commitlog::compression(compression));
+                if (!this->compressor) {
+                    throw invalid_segment_format();
+                }
+
+                this->id = id;
+                this->next = 0;
+
+                return make_ready_future<>();
+            });
+        }
+        // Returns the n bytes at offset off of the fragments, without copying.
+        static fragmented_temporary_buffer share_fragments(std::vector<temporary_buffer<char>>& frags, size_t off, size_t n) {
+            std::vector<temporary_buffer<char>> res;
+            auto size = n;
+            for (auto& f : frags) {
+                if (n == 0) {
+                    break;
+                }
+                if (off >= f.size()) {
+                    off -= f.size();
+                    continue;
+                }
+                auto len = std::min(f.size() - off, n);
+                res.emplace_back(f.share(off, len));
+                off = 0;
+                n -= len;
+            }
+            return fragmented_temporary_buffer(std::move(res), size);
+        }
+        future<std::vector<temporary_buffer<char>>> read_fragments(size_t n) {
+            return do_with(std::vector<temporary_buffer<char>>(), n, [this] (std::vector<temporary_buffer<char>>& frags, size_t& n) {
+                return repeat([this, &frags, &n] {
+                    if (n == 0) {
+                        return make_ready_future<stop_iteration>(stop_iteration::yes);
+                    }
+                    return fin.read_up_to(n).then([this, &frags, &n] (temporary_buffer<char> buf) {
+                        if (buf.empty()) {
+                            eof = true;
+                            return stop_iteration::yes;
+                        }
+                        pos += buf.size();
+                        n -= buf.size();
+                        frags.emplace_back(std::move(buf));
+                        return stop_iteration::no;
+                    });
+                }).then([&frags] {
+                    return std::move(frags);
+                });
+            });
+        }
+        std::vector<temporary_buffer<char>> uncompress_chunk(std::vector<temporary_buffer<char>>& frags, size_t compressed_size, size_t data_size) {
+            std::vector<temporary_buffer<char>> shared;
+            for (auto& f : frags) {
+                shared.emplace_back(f.share());
+            }
+            fragmented_temporary_buffer buf(std::move(shared), compressed_size);
+            auto in = buf.get_istream();
+
+            std::vector<temporary_buffer<char>> res;
+            size_t total = 0;
+            while (in.bytes_left()) {
+                auto raw_size = read<uint32_t>(in);
+                auto block_size = read<uint32_t>(in);
+                if (raw_size > data_size - total) {
+                    throw std::runtime_error(format("block size {} past the end of chunk data", raw_size));
+                }
+                bytes_ostream linearization_buffer;
+                auto block = in.read_bytes_view(block_size, linearization_buffer);
+                temporary_buffer<char> out(raw_size);
+                auto n = compressor->uncompress(reinterpret_cast<const char*>(block.data()), block.size(), out.get_write(), out.size());
+                if (n != raw_size) {
+                    throw std::runtime_error(format("uncompressed {} bytes instead of {}", n, raw_size));
+                }
+                total += n;
+                res.emplace_back(std::move(out));
+            }
+            if (total != data_size) {
+                throw std::runtime_error(format("uncompressed {} bytes instead of {}", total, data_size));
+            }
+            return res;
+        }
+        future<> read_compressed_chunk() {
+            return frag_reader.read_exactly(fin, segment::compressed_segment_overhead_size).then([this](fragmented_temporary_buffer buf) {
+                auto start = pos;
+
+                if (!advance(buf)) {
+                    return make_ready_future<>();
+                }
+
+                auto in = buf.get_istream();
+                auto next = read<uint32_t>(in);
+                auto data_start = read<uint32_t>(in);
+                auto data_size = read<uint32_t>(in);
+                auto compressed_size = read<uint32_t>(in);
+                auto checksum = read<uint32_t>(in);
+
+                if (next == 0 && checksum == 0) {
+                    // in a pre-allocating world, this means eof
+                    return stop();
+                }
+
+                crc32_nbo crc;
+                crc.process<int32_t>(id & 0xffffffff);
+                crc.process<int32_t>(id >> 32);
+                crc.process<uint32_t>(start);
+                crc.process(next);
+                crc.process(data_start);
+                crc.process(data_size);
+                crc.process(compressed_size);
+
+                auto cs = crc.checksum();
+                if (cs != checksum || compressed_size > data_size || next < pos + compressed_size) {
+                    // as with uncompressed segments, do not trust anything past a broken chunk header.
+                    clogger.debug("Checksum error in segment chunk at {}.", start);
+                    corrupt_size += (file_size - pos);
+                    return stop();
+                }
+
+                this->next = next;
+
+                if (start_off >= data_start + data_size) {
+                    return skip(next - pos);
+                }
+
+                return read_fragments(compressed_size).then([this, start, data_start, data_size, compressed_size] (std::vector<temporary_buffer<char>> frags) {
+                    if (eof) {
+                        return make_ready_future<>();
+                    }
+                    std::vector<temporary_buffer<char>> data;
+                    try {
+                        data = compressed_size == data_size ? std::move(frags) : uncompress_chunk(frags, compressed_size, data_size);
+                    } catch (...) {
+                        clogger.debug("Failed to uncompress segment chunk at {}: {}. Skipping to next chunk", start, std::current_exception());
+                        corrupt_size += data_size;
+                        return make_ready_future<>();
+                    }
+                    return read_entries(std::move(data), data_start, data_size);
+                }).then([this] {
+                    return eof ? make_ready_future<>() : skip(this->next - pos);
+                });
+            });
+        }
+        // Reads the entries of a chunk of a compressed segment, data being the (uncompressed)
+        // data of the chunk, at position data_start.
+        future<> read_entries(std::vector<temporary_buffer<char>> data, size_t data_start, size_t data_size) {
+            return do_with(std::move(data), size_t(0), [this, data_start, data_size] (std::vector<temporary_buffer<char>>& data, size_t& off) {
+                return repeat([this, &data, &off, data_start, data_size] {
+                    static constexpr size_t entry_header_size = segment::entry_overhead_size - sizeof(uint32_t);
+
+                    if (eof || (off + entry_header_size) >= data_size) {
+                        return make_ready_future<stop_iteration>(stop_iteration::yes);
+                    }
+
+                    replay_position rp(id, position_type(data_start + off));
+
+                    auto header = share_fragments(data, off, entry_header_size);
+                    auto in = header.get_istream();
+                    auto size = read<uint32_t>(in);
+                    auto checksum = read<uint32_t>(in);
+
+                    crc32_nbo crc;
+                    crc.process(size);
+
+                    if (size < 3 * sizeof(uint32_t) || checksum != crc.checksum() || size > data_size - off) {
+                        if (size != 0) {
+                            clogger.debug("Segment entry at {} has broken header. Skipping to next chunk ({} bytes)", rp, data_size - off);
+                            corrupt_size += data_size - off;
+                        }
+                        // size == 0 -> zero padding due to dma blocks
+                        return make_ready_future<stop_iteration>(stop_iteration::yes);
+                    }
+
+                    auto buf = share_fragments(data, off + entry_header_size, size - segment::entry_overhead_size);
+                    auto tail = share_fragments(data, off + size - sizeof(uint32_t), sizeof(uint32_t));
+                    auto tin = tail.get_istream();
+                    auto entry_checksum = read<uint32_t>(tin);
+                    off += size;
+
+                    crc.process_fragmented(fragmented_temporary_buffer::view(buf));
+                    if (crc.checksum() != entry_checksum) {
+                        clogger.debug("Segment entry at {} checksum error. Skipping {} bytes", rp, size);
+                        corrupt_size += size;
+                        return make_ready_future<stop_iteration>(stop_iteration::no);
+                    }
+
+                    return s.produce({std::move(buf), rp}).then([] {
+                        return stop_iteration::no;
+                    }).handle_exception([this](auto ep) {
+                        return fail().then([] {
+                            return stop_iteration::yes;
+                        });
+                    });
+                });
+            });
+        }
         future<> read_chunk() {
             return frag_reader.read_exactly(fin, segment::segment_overhead_size).then([this](fragmented_temporary_buffer buf) {
                 auto start = pos;
@@ -2076,7 +2527,9 @@ db::commitlog::read_log_file(const sstring& filename, const sstring& pfx, seasta
             }).then([this] {
                 return read_header().then(
                         [this] {
-                            return do_until(std::bind(&work::end_of_file, this), std::bind(&work::read_chunk, this));
+                            return do_until(std::bind(&work::end_of_file, this), [this] {
+                                return compressor ? read_compressed_chunk() : read_chunk();
+                            });
                 }).then([this] {
                   if (corrupt_size > 0) {
                       throw segment_data_corruption_error("Data corruption", corrupt_size);
@@ -2161,6 +2614,14 @@ uint64_t db::commitlog::get_num_segments_destroyed() const {
     return _segment_manager->totals.segments_destroyed;
 }
 
+uint64_t db::commitlog::get_num_segments_recycled() const {
+    return _segment_manager->totals.segments_recycled;
+}
+
+uint64_t db::commitlog::get_num_group_commit_windows() const {
+    return _segment_manager->totals.group_commit_windows;
+}
+
 uint64_t db::commitlog::get_num_dirty_segments() const {
     return _segment_manager->get_num_dirty_segments();
 }
@@ -114,6 +114,11 @@ class commitlog {
         PERIODIC, BATCH
     };
     using force_sync = commitlog_entry_writer::force_sync;
+    // Compression of the entries written to segments. The value is stored
+    // in the header of compressed segments.
+    enum class compression : uint32_t {
+        none = 0, lz4 = 1, zstd = 2,
+    };
     struct config {
         config() = default;
         config(const config&) = default;
@@ -133,10 +138,15 @@ class commitlog {
         uint64_t max_active_flushes = 0;
 
         sync_mode mode = sync_mode::PERIODIC;
+        // Upper bound of the group commit window in batch mode, i.e. of how
+        // long a sync may be delayed to let concurrent writes join it.
+        // Zero disables the window.
+        std::chrono::microseconds batch_window = std::chrono::milliseconds(2);
         std::string fname_prefix = descriptor::FILENAME_PREFIX;
 
         bool reuse_segments = true;
         bool use_o_dsync = false;
+        compression segment_compression = compression::none;
 
         const db::extensions * extensions = nullptr;
     };
@@ -298,6 +308,15 @@ class commitlog {
     uint64_t get_flush_limit_exceeded_count() const;
     uint64_t get_num_segments_created() const;
     uint64_t get_num_segments_destroyed() const;
+    /**
+     * Get number of segments allocated by reusing released segment files
+     */
+    uint64_t get_num_segments_recycled() const;
+    /**
+     * Get number of times a sync in batch mode was delayed to let
+     * concurrent writes join it
+     */
+    uint64_t get_num_group_commit_windows() const;
     /**
      * Get number of inactive (finished), segments lingering
      * due to still being dirty
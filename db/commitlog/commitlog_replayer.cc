@@ -42,11 +42,16 @@
 #include <memory>
 #include <vector>
 #include <algorithm>
+#include <numeric>
 #include <unordered_map>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/memory.hh>
+#include <seastar/core/seastar.hh>
 
 #include "commitlog.hh"
 #include "commitlog_replayer.hh"
@@ -63,6 +68,12 @@
 
 static logging::logger rlogger("commitlog_replayer");
 
+static thread_local db::commitlog_replayer::progress replay_progress;
+
+const db::commitlog_replayer::progress& db::commitlog_replayer::local_progress() {
+    return replay_progress;
+}
+
 class db::commitlog_replayer::impl {
     struct column_mappings {
         std::unordered_map<table_schema_version, column_mapping> map;
@@ -111,8 +122,54 @@ class db::commitlog_replayer::impl {
         return _column_mappings.stop();
     }
 
-    future<> process(stats*, commitlog::buffer_and_replay_position buf_rp) const;
-    future<stats> recover(sstring file, const sstring& fname_prefix) const;
+    // Segments replayed concurrently by a shard.
+    static constexpr size_t max_concurrent_segments = 4;
+    // Entries are routed to their owning shard in batches of this size...
+    static constexpr size_t batch_size = 128;
+    // ...with that many batches in flight per segment.
+    static constexpr size_t max_batches_in_flight = 8;
+    // The above only cap the number of entries. What actually bounds the
+    // memory of the entries read by a shard, queued or in flight, across all
+    // of its segments, is this fraction of the shard's memory.
+    static constexpr size_t replay_memory_divisor = 20;
+
+    static size_t max_replay_memory() {
+        return memory::stats().total_memory() / replay_memory_divisor;
+    }
+
+    struct entry {
+        commitlog_entry_reader cer;
+        // Column mapping of the entry's schema version, owned by the
+        // reading shard's _column_mappings.
+        const column_mapping* src_cm;
+        replay_position rp;
+    };
+
+    // State of the replay of a single segment.
+    struct segment_state {
+        stats s;
+        std::vector<std::vector<entry>> batches;
+        // Bytes of the entries of each batch, charged against memory.
+        std::vector<size_t> batch_bytes;
+        semaphore batches_in_flight{max_batches_in_flight};
+        // Shared by all segments replayed by the shard.
+        semaphore& memory;
+        const size_t memory_limit;
+
+        segment_state(semaphore& memory, size_t memory_limit)
+            : batches(smp::count)
+            , batch_bytes(smp::count)
+            , memory(memory)
+            , memory_limit(memory_limit)
+        {}
+    };
+
+    future<> process(segment_state*, commitlog::buffer_and_replay_position buf_rp) const;
+    future<> dispatch(segment_state*, unsigned shard) const;
+    future<> dispatch_all(segment_state*) const;
+    future<stats> apply(database&, std::vector<entry>) const;
+    future<> apply(database&, entry&) const;
+    future<stats> recover(sstring file, const sstring& fname_prefix, semaphore& memory) const;
 
     typedef std::unordered_map<utils::UUID, replay_position> rp_map;
     typedef std::unordered_map<unsigned, rp_map> shard_rpm_map;
@@ -207,7 +264,7 @@ future<> db::commitlog_replayer::impl::init() {
 }
 
 future<db::commitlog_replayer::impl::stats>
-db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix) const {
+db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix, semaphore& memory) const {
     assert(_column_mappings.local_is_initialized());
 
     replay_position rp{commitlog::descriptor(file, fname_prefix)};
@@ -222,25 +279,131 @@ db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix)
         p = gp.pos;
     }
 
-    auto s = make_lw_shared<stats>();
+    auto st = make_lw_shared<segment_state>(memory, max_replay_memory());
     auto& exts = _db.local().extensions();
 
     return db::commitlog::read_log_file(file, fname_prefix, service::get_local_commitlog_priority(),
-            std::bind(&impl::process, this, s.get(), std::placeholders::_1),
-            p, &exts).then_wrapped([s](future<> f) {
+            std::bind(&impl::process, this, st.get(), std::placeholders::_1),
+            p, &exts).then_wrapped([st](future<> f) {
         try {
             f.get();
         } catch (commitlog::segment_data_corruption_error& e) {
-            s->corrupt_bytes += e.bytes();
+            st->s.corrupt_bytes += e.bytes();
         } catch (...) {
-            throw;
+            return make_exception_future<>(std::current_exception());
         }
-        return make_ready_future<stats>(*s);
+        return make_ready_future<>();
+    }).finally([this, st] {
+        // Send out what is left, and wait for all batches to be applied,
+        // even if reading failed, since they reference st.
+        return dispatch_all(st.get()).finally([st] {
+            return st->batches_in_flight.wait(max_batches_in_flight);
+        });
+    }).then([st] {
+        return make_ready_future<stats>(st->s);
+    });
+}
+
+future<> db::commitlog_replayer::impl::dispatch(segment_state* st, unsigned shard) const {
+    auto bytes = std::exchange(st->batch_bytes[shard], 0);
+    if (st->batches[shard].empty()) {
+        st->memory.signal(bytes);
+        return make_ready_future<>();
+    }
+    auto batch = std::exchange(st->batches[shard], {});
+    // Only wait for a free slot, so that reading and decoding the segment
+    // proceeds while the batch is being applied.
+    return get_units(st->batches_in_flight, 1).then([this, st, shard, bytes, batch = std::move(batch)] (auto units) mutable {
+        auto n = batch.size();
+        // Waited for through batches_in_flight in recover().
+        (void)_db.invoke_on(shard, [this, batch = std::move(batch)] (database& db) mutable {
+            return apply(db, std::move(batch));
+        }).then_wrapped([st, n, bytes, units = std::move(units)] (future<stats> f) {
+            // The entries are destroyed by the owning shard, so their memory
+            // is given back here, on the reading one.
+            st->memory.signal(bytes);
+            try {
+                auto s = f.get0();
+                st->s += s;
+                replay_progress.applied_mutations += s.applied_mutations;
+                replay_progress.invalid_mutations += s.invalid_mutations;
+            } catch (...) {
+                st->s.invalid_mutations += n;
+                replay_progress.invalid_mutations += n;
+                rlogger.warn("error replaying: {}", std::current_exception());
+            }
+        });
+    });
+}
+
+future<> db::commitlog_replayer::impl::dispatch_all(segment_state* st) const {
+    return parallel_for_each(boost::irange(0u, smp::count), [this, st] (unsigned shard) {
+        return dispatch(st, shard);
+    });
+}
+
+future<db::commitlog_replayer::impl::stats>
+db::commitlog_replayer::impl::apply(database& db, std::vector<entry> batch) const {
+    return do_with(std::move(batch), stats(), [this, &db] (std::vector<entry>& batch, stats& s) {
+        return do_for_each(batch, [this, &db, &s] (entry& e) {
+            return futurize_apply([this, &db, &e] {
+                return apply(db, e);
+            }).then_wrapped([&s] (future<> f) {
+                try {
+                    f.get();
+                    s.applied_mutations++;
+                } catch (...) {
+                    s.invalid_mutations++;
+                    // TODO: write mutation to file like origin.
+                    rlogger.warn("error replaying: {}", std::current_exception());
+                }
+            });
+        }).then([&s] {
+            return s;
+        });
     });
 }
 
-future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_replay_position buf_rp) const {
+future<> db::commitlog_replayer::impl::apply(database& db, entry& e) const {
+    auto& fm = e.cer.mutation();
+    auto rp = e.rp;
+    // TODO: might need better verification that the deserialized mutation
+    // is schema compatible. My guess is that just applying the mutation
+    // will not do this.
+    auto& cf = db.find_column_family(fm.column_family_id());
+
+    if (rlogger.is_enabled(logging::log_level::debug)) {
+        rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
+                cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
+    }
+    // Removed forwarding "new" RP. Instead give none/empty.
+    // This is what origin does, and it should be fine.
+    // The end result should be that once sstables are flushed out
+    // their "replay_position" attribute will be empty, which is
+    // lower than anything the new session will produce.
+    if (cf.schema()->version() != fm.schema_version()) {
+        auto& local_cm = _column_mappings.local().map;
+        auto cm_it = local_cm.find(fm.schema_version());
+        if (cm_it == local_cm.end()) {
+            cm_it = local_cm.emplace(fm.schema_version(), *e.src_cm).first;
+        }
+        const column_mapping& cm = cm_it->second;
+        mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
+        converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
+        fm.partition().accept(cm, v);
+        return do_with(std::move(m), [&db, &cf] (mutation m) {
+            return db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
+        });
+    } else {
+        return do_with(std::move(e.cer).mutation(), [&](const frozen_mutation& m) {
+            return db.apply_in_memory(m, cf.schema(), db::rp_handle(), db::no_timeout);
+        });
+    }
+}
+
+future<> db::commitlog_replayer::impl::process(segment_state* st, commitlog::buffer_and_replay_position buf_rp) const {
     auto&& [buf, rp] = buf_rp;
+    auto s = &st->s;
     try {
 
         commitlog_entry_reader cer(buf);
@@ -261,6 +424,7 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
         if (rp < min_pos(shard_id)) {
             rlogger.trace("entry {} is less than global min position. skipping", rp);
             s->skipped_mutations++;
+            replay_progress.skipped_mutations++;
             return make_ready_future<>();
         }
 
@@ -269,58 +433,34 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
         if (rp <= cf_rp) {
             rlogger.trace("entry {} at {} is younger than recorded replay position {}. skipping", fm.column_family_id(), rp, cf_rp);
             s->skipped_mutations++;
+            replay_progress.skipped_mutations++;
             return make_ready_future<>();
         }
 
         auto shard = _db.local().shard_of(fm);
-        return _db.invoke_on(shard, [this, cer = std::move(cer), &src_cm, rp, shard, s] (database& db) mutable -> future<> {
-            auto& fm = cer.mutation();
-            // TODO: might need better verification that the deserialized mutation
-            // is schema compatible. My guess is that just applying the mutation
-            // will not do this.
-            auto& cf = db.find_column_family(fm.column_family_id());
-
-            if (rlogger.is_enabled(logging::log_level::debug)) {
-                rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
-                        cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
-            }
-            // Removed forwarding "new" RP. Instead give none/empty.
-            // This is what origin does, and it should be fine.
-            // The end result should be that once sstables are flushed out
-            // their "replay_position" attribute will be empty, which is
-            // lower than anything the new session will produce.
-            if (cf.schema()->version() != fm.schema_version()) {
-                auto& local_cm = _column_mappings.local().map;
-                auto cm_it = local_cm.find(fm.schema_version());
-                if (cm_it == local_cm.end()) {
-                    cm_it = local_cm.emplace(fm.schema_version(), src_cm).first;
-                }
-                const column_mapping& cm = cm_it->second;
-                mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
-                converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
-                fm.partition().accept(cm, v);
-                return do_with(std::move(m), [&db, &cf] (mutation m) {
-                    return db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
-                });
-            } else {
-                return do_with(std::move(cer).mutation(), [&](const frozen_mutation& m) {
-                    return db.apply_in_memory(m, cf.schema(), db::rp_handle(), db::no_timeout);
-                });
-            }
-        }).then_wrapped([s] (future<> f) {
-            try {
-                f.get();
-                s->applied_mutations++;
-            } catch (...) {
-                s->invalid_mutations++;
-                // TODO: write mutation to file like origin.
-                rlogger.warn("error replaying: {}", std::current_exception());
+        auto size = std::min(buf.size_bytes(), st->memory_limit);
+        auto f = make_ready_future<>();
+        if (st->memory.available_units() < ssize_t(size)) {
+            // Queued batches hold memory too, and may not fill up before
+            // it is available, so send them out before waiting.
+            f = dispatch_all(st);
+        }
+        return f.then([st, size] {
+            return st->memory.wait(size);
+        }).then([this, st, shard, size, e = entry{std::move(cer), &src_cm, rp}] () mutable {
+            st->batch_bytes[shard] += size;
+            auto& batch = st->batches[shard];
+            batch.push_back(std::move(e));
+            if (batch.size() >= batch_size) {
+                return dispatch(st, shard);
             }
+            return make_ready_future<>();
         });
     } catch (no_such_column_family&) {
         // No such CF now? Origin just ignores this.
     } catch (...) {
         s->invalid_mutations++;
+        replay_progress.invalid_mutations++;
         // TODO: write mutation to file like origin.
         rlogger.warn("error replaying: {}", std::current_exception());
     }
@@ -353,51 +493,83 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
 
     rlogger.info("Replaying {}", join(", ", files));
 
-    // pre-compute work per shard already.
-    auto map = ::make_lw_shared<shard_file_map>();
-    for (auto& f : files) {
-        commitlog::descriptor d(f, fname_prefix);
-        replay_position p = d;
-        map->emplace(p.shard_id() % smp::count, std::move(f));
-    }
+    return do_with(std::move(files), std::vector<uint64_t>(), std::move(fname_prefix),
+            [this] (std::vector<sstring>& files, std::vector<uint64_t>& sizes, sstring& fname_prefix) {
+        sizes.resize(files.size());
+        return parallel_for_each(boost::irange(size_t(0), files.size()), [&files, &sizes] (size_t i) {
+            return file_size(files[i]).then([&sizes, i] (uint64_t size) {
+                sizes[i] = size;
+            });
+        }).then([this, &files, &sizes, &fname_prefix] {
+            // pre-compute work per shard already. Which shard reads a segment
+            // does not matter, since entries are routed to their owning shard
+            // anyway, so spread the segments evenly (by size) across all shards,
+            // not only the ones that wrote them. The shard count may have changed.
+            auto map = ::make_lw_shared<shard_file_map>();
+            std::vector<size_t> order(files.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&sizes] (size_t a, size_t b) {
+                return sizes[a] > sizes[b];
+            });
+            std::vector<uint64_t> load(smp::count);
+            auto work = ::make_lw_shared<std::vector<progress>>(smp::count);
+            for (auto i : order) {
+                auto shard = std::min_element(load.begin(), load.end()) - load.begin();
+                load[shard] += sizes[i];
+                (*work)[shard].segments_total++;
+                (*work)[shard].bytes_total += sizes[i];
+                map->emplace(shard, files[i]);
+            }
+            auto sizes_by_name = ::make_lw_shared<std::unordered_map<sstring, uint64_t>>();
+            for (size_t i = 0; i < files.size(); ++i) {
+                sizes_by_name->emplace(files[i], sizes[i]);
+            }
 
-    return do_with(std::move(fname_prefix), [this, map] (sstring& fname_prefix) {
-        return _impl->start().then([this, map, &fname_prefix] {
-            return map_reduce(smp::all_cpus(), [this, map, &fname_prefix] (unsigned id) {
-                return smp::submit_to(id, [this, id, map, &fname_prefix] () {
-                    auto total = ::make_lw_shared<impl::stats>();
-                    // TODO: or something. For now, we do this serialized per shard,
-                    // to reduce mutation congestion. We could probably (says avi)
-                    // do 2 segments in parallel or something, but lets use this first.
-                    auto range = map->equal_range(id);
-                    return do_for_each(range.first, range.second, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
-                        auto&f = p.second;
-                        rlogger.debug("Replaying {}", f);
-                        return _impl->recover(f, fname_prefix).then([f, total](impl::stats stats) {
-                            if (stats.corrupt_bytes != 0) {
-                                rlogger.warn("Corrupted file: {}. {} bytes skipped.", f, stats.corrupt_bytes);
-                            }
-                            rlogger.debug("Log replay of {} complete, {} replayed mutations ({} invalid, {} skipped)"
-                                            , f
-                                            , stats.applied_mutations
-                                            , stats.invalid_mutations
-                                            , stats.skipped_mutations
-                            );
-                            *total += stats;
+            return _impl->start().then([this, map, sizes_by_name, work, &fname_prefix] {
+                return map_reduce(smp::all_cpus(), [this, map, sizes_by_name, work, &fname_prefix] (unsigned id) {
+                    return smp::submit_to(id, [this, id, map, sizes_by_name, w = (*work)[id], &fname_prefix] () {
+                        replay_progress = w;
+                        replay_progress.active = true;
+                        auto total = ::make_lw_shared<impl::stats>();
+                        auto range = map->equal_range(id);
+                        return do_with(semaphore(impl::max_concurrent_segments), semaphore(impl::max_replay_memory()),
+                                [this, range, sizes_by_name, total, &fname_prefix] (semaphore& sem, semaphore& memory) {
+                            return parallel_for_each(range.first, range.second, [this, sizes_by_name, total, &sem, &memory, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
+                                return with_semaphore(sem, 1, [this, &p, sizes_by_name, total, &memory, &fname_prefix] {
+                                    auto&f = p.second;
+                                    rlogger.debug("Replaying {}", f);
+                                    return _impl->recover(f, fname_prefix, memory).then([f, sizes_by_name, total](impl::stats stats) {
+                                        if (stats.corrupt_bytes != 0) {
+                                            rlogger.warn("Corrupted file: {}. {} bytes skipped.", f, stats.corrupt_bytes);
+                                        }
+                                        rlogger.debug("Log replay of {} complete, {} replayed mutations ({} invalid, {} skipped)"
+                                                        , f
+                                                        , stats.applied_mutations
+                                                        , stats.invalid_mutations
+                                                        , stats.skipped_mutations
+                                        );
+                                        *total += stats;
+                                        replay_progress.segments_replayed++;
+                                        replay_progress.bytes_replayed += sizes_by_name->at(f);
+                                    });
+                                });
+                            });
+                        }).then([total] {
+                            return make_ready_future<impl::stats>(*total);
+                        }).finally([] {
+                            replay_progress.active = false;
                         });
-                    }).then([total] {
-                        return make_ready_future<impl::stats>(*total);
                     });
+                }, impl::stats(), std::plus<impl::stats>()).then([](impl::stats totals) {
+                    rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped)"
+                                    , totals.applied_mutations
+                                    , totals.invalid_mutations
+                                    , totals.skipped_mutations
+                    );
                 });
-            }, impl::stats(), std::plus<impl::stats>()).then([](impl::stats totals) {
-                rlogger.info("Log replay complete, {} replayed mutations ({} invalid, {} skipped)"
-                                , totals.applied_mutations
-                                , totals.invalid_mutations
-                                , totals.skipped_mutations
-                );
+            }).finally([this] {
+                return _impl->stop();
             });
-        }).finally([this] {
-            return _impl->stop();
         });
     });
 }
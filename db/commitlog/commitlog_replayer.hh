@@ -61,6 +61,23 @@ class commitlog_replayer {
     future<> recover(std::vector<sstring> files, sstring fname_prefix);
     future<> recover(sstring file, sstring fname_prefix);
 
+    // Progress of the replay, as seen by one shard. Segments are counted
+    // on the shard reading them, mutations on the shard reading them
+    // rather than on the one applying them.
+    struct progress {
+        uint64_t segments_total = 0;
+        uint64_t segments_replayed = 0;
+        uint64_t bytes_total = 0;
+        uint64_t bytes_replayed = 0;
+        uint64_t applied_mutations = 0;
+        uint64_t skipped_mutations = 0;
+        uint64_t invalid_mutations = 0;
+        bool active = false;
+    };
+
+    // Returns the progress of the last (or current) replay on this shard.
+    static const progress& local_progress();
+
 private:
     commitlog_replayer(seastar::sharded<database>&);
 
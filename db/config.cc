@@ -199,6 +199,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
         "If set to true, enforce the min_threshold option for compactions strictly. If false (default), Scylla may decide to compact even if below min_threshold")
+    , tombstone_compaction_check_interval_in_s(this, "tombstone_compaction_check_interval_in_s", value_status::Used, 600,
+        "Interval at which sstables are checked for an estimated ratio of droppable tombstones above the tombstone_threshold compaction option of their table, to be rewritten on their own, regardless of the compaction strategy. Set to 0 to disable.")
+    , compaction_boost_sstable_count_threshold(this, "compaction_boost_sstable_count_threshold", value_status::Used, 0,
+        "Number of sstables of a table above which its compactions go ahead of those of other tables, regardless of the shares compaction option of the tables, and raise the shares of compaction. Set to 0 to disable.")
+    , compaction_boost_overlapping_sstables_threshold(this, "compaction_boost_overlapping_sstables_threshold", value_status::Used, 0,
+        "Number of sstables of a table overlapping one another, which is the number of sstables a single-partition read may have to go through, above which its compactions go ahead of those of other tables, regardless of the shares compaction option of the tables, and raise the shares of compaction. Set to 0 to disable.")
     /* Initialization properties */
     /* The minimal properties needed for configuring a cluster. */
     , cluster_name(this, "cluster_name", value_status::Used, "",
@@ -340,8 +346,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , commitlog_sync_period_in_ms(this, "commitlog_sync_period_in_ms", value_status::Used, 10000,
         "Controls how long the system waits for other writes before performing a sync in \"periodic\" mode.")
     /* Note: does not exist on the listing page other than in above comment, wtf? */
-    , commitlog_sync_batch_window_in_ms(this, "commitlog_sync_batch_window_in_ms", value_status::Used, 10000,
-        "Controls how long the system waits for other writes before performing a sync in \"batch\" mode.")
+    , commitlog_sync_batch_window_in_ms(this, "commitlog_sync_batch_window_in_ms", value_status::Used, 2,
+        "Controls how long the system may wait for other writes before performing a sync in \"batch\" mode. "
+        "The actual window adapts to the observed sync latency and the number of concurrent writes, this is its upper bound. 0 disables waiting.")
     , commitlog_total_space_in_mb(this, "commitlog_total_space_in_mb", value_status::Used, -1,
         "Total space used for commitlogs. If the used space goes above this value, Scylla rounds up to the next nearest segment multiple and flushes memtables to disk for the oldest commitlog segments, removing those log segments. This reduces the amount of data to replay on startup, and prevents infrequently-updated tables from indefinitely keeping commitlog segments. A small total commitlog space tends to cause more flush activity on less-active tables.\n"
         "Related information: Configuring memtable throughput")
@@ -349,6 +356,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Whether or not to re-use commitlog segments when finished instead of deleting them. Can improve commitlog latency on some file systems.\n")
     , commitlog_use_o_dsync(this, "commitlog_use_o_dsync", value_status::Used, true,
         "Whether or not to use O_DSYNC mode for commitlog segments IO. Can improve commitlog latency on some file systems.\n")
+    , commitlog_compression(this, "commitlog_compression", value_status::Used, "none",
+        "Compression of the entries written to commitlog segments, one of: none, lz4, zstd. Trades CPU for less commitlog I/O. "
+        "Existing segments can be replayed regardless of this setting.")
     /* Compaction settings */
     /* Related information: Configuring compaction */
     , compaction_preheat_key_cache(this, "compaction_preheat_key_cache", value_status::Unused, true,
@@ -720,6 +730,16 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , max_clustering_key_restrictions_per_query(this, "max_clustering_key_restrictions_per_query", liveness::LiveUpdate, value_status::Used, 100,
             "Maximum number of distinct clustering key restrictions per query. This limit places a bound on the size of IN tuples, "
             "especially when multiple clustering key columns have IN restrictions. Increasing this value can result in server instability.")
+    , range_scan_shard_concurrency(this, "range_scan_shard_concurrency", liveness::LiveUpdate, value_status::Used, 0,
+            "Number of shards which scan their part of a token range in parallel, when a replica serves a range scan. "
+            "0 reads the shards one at a time, reading ahead on more of them only when they have little data. "
+            "Higher values make large scans faster, at the cost of competing with other reads on more shards.")
+    , range_scan_querier_ttl_in_s(this, "range_scan_querier_ttl_in_s", value_status::Used, 60,
+            "Time for which a replica keeps the reader of a paged range scan between pages, unless it needs the memory "
+            "or the concurrency slot for other reads. Lower values than the TTL of other paged queries have no effect.")
+    , range_scan_read_ahead_in_kb(this, "range_scan_read_ahead_in_kb", value_status::Used, 256,
+            "Amount of data a replica reads in the background for the next page of a paged range scan, while the "
+            "client consumes the current page. 0 disables read-ahead.")
     , enable_3_1_0_compatibility_mode(this, "enable_3_1_0_compatibility_mode", value_status::Used, false,
         "Set to true if the cluster was initially installed from 3.1.0. If it was upgraded from an earlier version,"
         " or installed from a later version, leave this set to false. This adjusts the communication protocol to"
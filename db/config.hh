@@ -121,6 +121,9 @@ class config : public utils::config_file {
     named_value<float> memtable_flush_static_shares;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
+    named_value<uint32_t> tombstone_compaction_check_interval_in_s;
+    named_value<uint32_t> compaction_boost_sstable_count_threshold;
+    named_value<uint32_t> compaction_boost_overlapping_sstables_threshold;
     named_value<sstring> cluster_name;
     named_value<sstring> listen_address;
     named_value<sstring> listen_interface;
@@ -157,6 +160,7 @@ class config : public utils::config_file {
     named_value<int64_t> commitlog_total_space_in_mb;
     named_value<bool> commitlog_reuse_segments;
     named_value<bool> commitlog_use_o_dsync;
+    named_value<sstring> commitlog_compression;
     named_value<bool> compaction_preheat_key_cache;
     named_value<uint32_t> concurrent_compactors;
     named_value<uint32_t> in_memory_compaction_limit_in_mb;
@@ -300,6 +304,9 @@ class config : public utils::config_file {
     named_value<bool> abort_on_internal_error;
     named_value<uint32_t> max_partition_key_restrictions_per_query;
     named_value<uint32_t> max_clustering_key_restrictions_per_query;
+    named_value<uint32_t> range_scan_shard_concurrency;
+    named_value<uint32_t> range_scan_querier_ttl_in_s;
+    named_value<uint32_t> range_scan_read_ahead_in_kb;
     named_value<bool> enable_3_1_0_compatibility_mode;
     named_value<bool> enable_user_defined_functions;
     named_value<unsigned> user_defined_function_time_limit_ms;
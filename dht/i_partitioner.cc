@@ -125,6 +125,18 @@ int tri_compare(token_view t1, token_view t2) {
     return 0;
 }
 
+int64_t token_prefix(token_view t) {
+    switch (t._kind) {
+    case token_kind::before_all_keys:
+        return std::numeric_limits<int64_t>::min();
+    case token_kind::after_all_keys:
+        return std::numeric_limits<int64_t>::max();
+    case token_kind::key:
+        return global_partitioner().token_prefix(t);
+    }
+    abort();
+}
+
 std::ostream& operator<<(std::ostream& out, const token& t) {
     if (t._kind == token::kind::after_all_keys) {
         out << "maximum token";
@@ -153,6 +153,10 @@ token midpoint_unsigned(const token& t1, const token& t2);
 const token& minimum_token();
 const token& maximum_token();
 int tri_compare(token_view t1, token_view t2);
+// Returns a 64-bit integer which orders consistently with tokens:
+// token_prefix(t1) < token_prefix(t2) implies t1 < t2.
+// Tokens with equal prefixes have to be compared with tri_compare().
+int64_t token_prefix(token_view t);
 inline bool operator==(token_view t1, token_view t2) { return tri_compare(t1, t2) == 0; }
 inline bool operator<(token_view t1, token_view t2) { return tri_compare(t1, t2) < 0; }
 
@@ -363,6 +367,14 @@ class i_partitioner {
      * @return < 0 if if t1's _data array is less, t2's. 0 if they are equal, and > 0 otherwise. _kind comparison should be done separately.
      */
     virtual int tri_compare(token_view t1, token_view t2) const = 0;
+    /**
+     * @return 64-bit integer such that token_prefix(t1) < token_prefix(t2) implies t1 < t2.
+     * Only called for tokens of kind key. The default implementation returns a constant,
+     * which forces all comparisons to go through tri_compare().
+     */
+    virtual int64_t token_prefix(token_view t) const {
+        return 0;
+    }
     /**
      * @return true if t1's _data array is equal t2's. _kind comparison should be done separately.
      */
@@ -168,6 +168,10 @@ int murmur3_partitioner::tri_compare(token_view t1, token_view t2) const {
     }
 }
 
+int64_t murmur3_partitioner::token_prefix(token_view t) const {
+    return long_token(t);
+}
+
 // Assuming that x>=y, return the positive difference x-y.
 // The return type is an unsigned type, as the difference may overflow
 // a signed type (e.g., consider very positive x and very negative y).
@@ -45,6 +45,7 @@ class murmur3_partitioner final : public i_partitioner {
     virtual std::map<token, float> describe_ownership(const std::vector<token>& sorted_tokens) override;
     virtual data_type get_token_validator() override;
     virtual int tri_compare(token_view t1, token_view t2) const override;
+    virtual int64_t token_prefix(token_view t) const override;
     virtual token midpoint(const token& t1, const token& t2) const override;
     virtual sstring to_sstring(const dht::token& t) const override;
     virtual dht::token from_sstring(const sstring& t) const override;
@@ -515,10 +515,11 @@ flat_mutation_reader_from_mutations(std::vector<mutation> mutations, const dht::
             }
         }
         void destroy_mutations() noexcept {
-            // After unlink_leftmost_without_rebalance() was called on a bi::set
-            // we need to complete destroying the tree using that function.
-            // clear_and_dispose() used by mutation_partition destructor won't
-            // work properly.
+            // After unlink_leftmost_without_rebalance() was called on the bi::set
+            // of range tombstones we need to complete destroying it using that
+            // function. clear_and_dispose() used by mutation_partition destructor
+            // won't work properly. The rows tree stays balanced after unlinking,
+            // but is emptied the same way for simplicity.
 
             _cur = _mutations.begin();
             while (_cur != _end) {
@@ -478,6 +478,9 @@ class flat_mutation_reader final {
     mutation_fragment pop_mutation_fragment() { return _impl->pop_mutation_fragment(); }
     void unpop_mutation_fragment(mutation_fragment mf) { _impl->unpop_mutation_fragment(std::move(mf)); }
     const schema_ptr& schema() const { return _impl->_schema; }
+    size_t max_buffer_size() const {
+        return _impl->max_buffer_size_in_bytes;
+    }
     void set_max_buffer_size(size_t size) {
         _impl->max_buffer_size_in_bytes = size;
     }
@@ -52,4 +52,11 @@ class read_command {
     bool is_first_page [[version 2.2]] = false;
 };
 
+struct partial_aggregate {
+    sstring function_keyspace;
+    sstring function_name;
+    std::vector<sstring> argument_types;
+    std::vector<bytes> argument_columns;
+};
+
 }
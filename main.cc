@@ -76,6 +76,7 @@
 #include "redis/service.hh"
 #include "cdc/cdc.hh"
 #include "alternator/tags_extension.hh"
+#include "db/bloom_filter_format_extension.hh"
 
 namespace fs = std::filesystem;
 
@@ -435,6 +436,9 @@ int main(int ac, char** av) {
     ext->add_schema_extension(alternator::tags_extension::NAME, [](db::extensions::schema_ext_config cfg) {
         return std::visit([](auto v) { return ::make_shared<alternator::tags_extension>(v); }, cfg);
     });
+    ext->add_schema_extension(db::bloom_filter_format_extension::NAME, [](db::extensions::schema_ext_config cfg) {
+        return std::visit([](auto v) { return ::make_shared<db::bloom_filter_format_extension>(v); }, cfg);
+    });
 
     auto cfg = make_lw_shared<db::config>(ext);
     auto init = app.get_options_description().add_options();
@@ -869,6 +873,8 @@ int main(int ac, char** av) {
             supervisor::notify("setting up system keyspace");
             db::system_keyspace::setup(db, qp, service::get_storage_service()).get();
             supervisor::notify("starting commit log");
+            // Registered before replay, so that its progress can be followed.
+            api::set_server_commitlog(ctx).get();
             auto cl = db.local().commitlog();
             if (cl != nullptr) {
                 auto paths = cl->get_segments_to_replay();
@@ -28,6 +28,7 @@
 #include "memtable.hh"
 #include "sstables/shared_sstable.hh"
 #include "sstables/progress_monitor.hh"
+#include "compress.hh"
 #include <seastar/core/future.hh>
 #include <seastar/core/file.hh>
 #include <seastar/core/thread.hh>
@@ -39,7 +40,8 @@ write_memtable_to_sstable(memtable& mt,
         sstables::write_monitor& mon,
         bool backup = false,
         const io_priority_class& pc = default_priority_class(),
-        bool leave_unsealed = false);
+        bool leave_unsealed = false,
+        compressor_ptr compression_dictionary = {});
 
 future<>
 write_memtable_to_sstable(memtable& mt,
@@ -117,7 +117,6 @@ memtable::memtable(schema_ptr schema, dirty_memory_manager& dmm, table_stats& ta
         , _cleaner(*this, no_cache_tracker, table_stats.memtable_app_stats, compaction_scheduling_group)
         , _memtable_list(memtable_list)
         , _schema(std::move(schema))
-        , partitions(memtable_entry::compare(_schema))
         , _table_stats(table_stats) {
 }
 
@@ -207,11 +206,11 @@ memtable::find_or_create_partition(const dht::decorated_key& key) {
     // call lower_bound so we have a hint for the insert, just in case.
     auto i = partitions.lower_bound(key, memtable_entry::compare(_schema));
     if (i == partitions.end() || !key.equal(*_schema, i->key())) {
-        memtable_entry* entry = current_allocator().construct<memtable_entry>(
-            _schema, dht::decorated_key(key), mutation_partition(_schema));
-        partitions.insert_before(i, *entry);
+        auto entry = alloc_strategy_unique_ptr<memtable_entry>(current_allocator().construct<memtable_entry>(
+            _schema, dht::decorated_key(key), mutation_partition(_schema)));
+        partitions.insert_before(i, *entry, memtable_entry::compare(_schema));
         ++_table_stats.memtable_partition_insertions;
-        return entry->partition();
+        return entry.release()->partition();
     } else {
         ++_table_stats.memtable_partition_hits;
         upgrade_entry(*i);
@@ -219,6 +218,14 @@ memtable::find_or_create_partition(const dht::decorated_key& key) {
     return i->partition();
 }
 
+bool
+memtable::contains(const dht::decorated_key& key) {
+    return _read_section(*this, [&] {
+        managed_bytes::linearization_context_guard lcg;
+        return partitions.find(key, memtable_entry::compare(_schema)) != partitions.end();
+    });
+}
+
 boost::iterator_range<memtable::partitions_type::const_iterator>
 memtable::slice(const dht::partition_range& range) const {
     if (query::is_single_partition(range)) {
@@ -758,15 +765,11 @@ size_t memtable::partition_count() const {
 }
 
 memtable_entry::memtable_entry(memtable_entry&& o) noexcept
-    : _link()
+    : _link(std::move(o._link))
     , _schema(std::move(o._schema))
     , _key(std::move(o._key))
     , _pe(std::move(o._pe))
-{
-    using container_type = memtable::partitions_type;
-    container_type::node_algorithms::replace_node(o._link.this_ptr(), _link.this_ptr());
-    container_type::node_algorithms::init(o._link.this_ptr());
-}
+{ }
 
 stop_iteration memtable_entry::clear_gently() noexcept {
     return _pe.clear_gently(no_cache_tracker);
@@ -33,6 +33,7 @@
 #include "db/commitlog/rp_set.hh"
 #include "utils/extremum_tracking.hh"
 #include "utils/logalloc.hh"
+#include "utils/bptree.hh"
 #include "partition_version.hh"
 #include "flat_mutation_reader.hh"
 #include "mutation_cleaner.hh"
@@ -44,7 +45,7 @@ class frozen_mutation;
 namespace bi = boost::intrusive;
 
 class memtable_entry {
-    bi::set_member_hook<> _link;
+    bplus::member_hook _link;
     schema_ptr _schema;
     dht::decorated_key _key;
     partition_entry _pe;
@@ -115,6 +116,19 @@ class memtable_entry {
         bool operator()(const dht::ring_position& k1, const memtable_entry& k2) const {
             return _c(k1, k2._key);
         }
+
+        // See bplus::tree.
+        int64_t prefix(const memtable_entry& e) const {
+            return dht::token_prefix(e._key.token());
+        }
+
+        int64_t prefix(const dht::decorated_key& k) const {
+            return dht::token_prefix(k.token());
+        }
+
+        int64_t prefix(const dht::ring_position& p) const {
+            return dht::token_prefix(p.token());
+        }
     };
 
     friend std::ostream& operator<<(std::ostream&, const memtable_entry&);
@@ -126,9 +140,7 @@ struct table_stats;
 // Managed by lw_shared_ptr<>.
 class memtable final : public enable_lw_shared_from_this<memtable>, private logalloc::region {
 public:
-    using partitions_type = bi::set<memtable_entry,
-        bi::member_hook<memtable_entry, bi::set_member_hook<>, &memtable_entry::_link>,
-        bi::compare<memtable_entry::compare>>;
+    using partitions_type = bplus::tree<memtable_entry, &memtable_entry::_link>;
 private:
     dirty_memory_manager& _dirty_mgr;
     mutation_cleaner _cleaner;
@@ -266,6 +278,8 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
     mutation_source as_data_source();
 
     bool empty() const { return partitions.empty(); }
+    // Returns true if the memtable holds data of the given partition.
+    bool contains(const dht::decorated_key&);
     void mark_flushed(mutation_source) noexcept;
     bool is_flushed() const;
     void on_detach_from_region_group() noexcept;
@@ -452,6 +452,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::PAXOS_PREPARE:
     case messaging_verb::PAXOS_ACCEPT:
     case messaging_verb::PAXOS_LEARN:
+    case messaging_verb::PARTIAL_AGGREGATES:
         return 0;
     // GET_SCHEMA_VERSION is sent from read/mutate verbs so should be
     // sent on a different connection to avoid potential deadlocks
@@ -1294,4 +1295,16 @@ future<> messaging_service::send_hint_mutation(msg_addr id, clock_type::time_poi
         std::move(reply_to), shard, std::move(response_id), std::move(trace_info));
 }
 
+void messaging_service::register_partial_aggregates(std::function<future<std::vector<bytes_opt>> (const rpc::client_info&, rpc::opt_time_point timeout,
+        query::read_command cmd, dht::partition_range_vector ranges, std::vector<query::partial_aggregate> aggregates)>&& func) {
+    register_handler(this, netw::messaging_verb::PARTIAL_AGGREGATES, std::move(func));
+}
+future<> messaging_service::unregister_partial_aggregates() {
+    return unregister_handler(netw::messaging_verb::PARTIAL_AGGREGATES);
+}
+future<std::vector<bytes_opt>> messaging_service::send_partial_aggregates(msg_addr id, clock_type::time_point timeout, const query::read_command& cmd,
+        const dht::partition_range_vector& ranges, const std::vector<query::partial_aggregate>& aggregates) {
+    return send_message_timeout<future<std::vector<bytes_opt>>>(this, messaging_verb::PARTIAL_AGGREGATES, std::move(id), timeout, cmd, ranges, aggregates);
+}
+
 } // namespace net
@@ -139,7 +139,8 @@ enum class messaging_verb : int32_t {
     PAXOS_ACCEPT = 40,
     PAXOS_LEARN = 41,
     HINT_MUTATION = 42,
-    LAST = 43,
+    PARTIAL_AGGREGATES = 43,
+    LAST = 44,
 };
 
 } // namespace netw
@@ -499,6 +500,13 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> send_hint_mutation(msg_addr id, clock_type::time_point timeout, const frozen_mutation& fm, std::vector<inet_address> forward,
         inet_address reply_to, unsigned shard, response_id_type response_id, std::optional<tracing::trace_info> trace_info = std::nullopt);
 
+    // Wrapper for PARTIAL_AGGREGATES
+    void register_partial_aggregates(std::function<future<std::vector<bytes_opt>> (const rpc::client_info&, rpc::opt_time_point timeout,
+        query::read_command cmd, dht::partition_range_vector ranges, std::vector<query::partial_aggregate> aggregates)>&& func);
+    future<> unregister_partial_aggregates();
+    future<std::vector<bytes_opt>> send_partial_aggregates(msg_addr id, clock_type::time_point timeout, const query::read_command& cmd,
+        const dht::partition_range_vector& ranges, const std::vector<query::partial_aggregate>& aggregates);
+
     void foreach_server_connection_stats(std::function<void(const rpc::client_info&, const rpc::stats&)>&& f) const;
 private:
     bool remove_rpc_client_one(clients_map& clients, msg_addr id, bool dead_only);
@@ -580,11 +580,15 @@ static future<reconcilable_result> do_query_mutations(
         tracing::trace_state_ptr trace_state,
         db::timeout_clock::time_point timeout,
         query::result_memory_accounter&& accounter) {
+    auto concurrency = multishard_reader_concurrency{};
+    if (auto shards = db.local().get_config().range_scan_shard_concurrency()) {
+        concurrency = multishard_reader_concurrency::parallel(shards);
+    }
     return do_with(seastar::make_shared<read_context>(db, s, cmd, ranges, trace_state), [s, &cmd, &ranges, trace_state, timeout,
-            accounter = std::move(accounter)] (shared_ptr<read_context>& ctx) mutable {
+            accounter = std::move(accounter), concurrency] (shared_ptr<read_context>& ctx) mutable {
         return ctx->lookup_readers().then([&ctx, s = std::move(s), &cmd, &ranges, trace_state, timeout,
-                accounter = std::move(accounter)] () mutable {
-            auto ms = mutation_source([&] (schema_ptr s,
+                accounter = std::move(accounter), concurrency] () mutable {
+            auto ms = mutation_source([&, concurrency] (schema_ptr s,
                     reader_permit permit,
                     const dht::partition_range& pr,
                     const query::partition_slice& ps,
@@ -592,7 +596,8 @@ static future<reconcilable_result> do_query_mutations(
                     tracing::trace_state_ptr trace_state,
                     streamed_mutation::forwarding,
                     mutation_reader::forwarding fwd_mr) {
-                return make_multishard_combining_reader(ctx, dht::global_partitioner(), std::move(s), pr, ps, pc, std::move(trace_state), fwd_mr);
+                return make_multishard_combining_reader(ctx, dht::global_partitioner(), std::move(s), pr, ps, pc, std::move(trace_state), fwd_mr,
+                        concurrency);
             });
             auto reader = make_flat_multi_range_reader(s, std::move(ms), ranges, cmd.slice,
                     service::get_local_sstable_query_read_priority(), trace_state, mutation_reader::forwarding::no);
@@ -31,7 +31,8 @@
 /// Run the mutation query on all shards.
 ///
 /// Under the hood it uses a multishard_combining_reader for reading the
-/// range(s) from all shards.
+/// range(s) from all shards. When the `range_scan_shard_concurrency` config
+/// option is set, that many shards scan their subranges in parallel.
 ///
 /// The query uses paging. The read will stop after reaching one of the page
 /// size limits. Page size is determined by the read_command (row and partition
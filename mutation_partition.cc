@@ -21,6 +21,7 @@
 
 #include <boost/range/adaptor/reversed.hpp>
 #include <seastar/util/defer.hh>
+#include <seastar/core/byteorder.hh>
 #include "mutation_partition.hh"
 #include "converting_mutation_partition_applier.hh"
 #include "partition_builder.hh"
@@ -31,7 +32,6 @@
 #include "mutation_query.hh"
 #include "service/priority_manager.hh"
 #include "mutation_compactor.hh"
-#include "intrusive_set_external_comparator.hh"
 #include "counters.hh"
 #include "row_cache.hh"
 #include "view_info.hh"
@@ -176,7 +176,9 @@ mutation_partition::mutation_partition(const mutation_partition& x, const schema
     try {
         for(auto&& r : ck_ranges) {
             for (const rows_entry& e : x.range(schema, r)) {
-                _rows.insert(_rows.end(), *current_allocator().construct<rows_entry>(schema, e), rows_entry::compare(schema));
+                auto ce = alloc_strategy_unique_ptr<rows_entry>(current_allocator().construct<rows_entry>(schema, e));
+                _rows.insert(_rows.end(), *ce, rows_entry::compare(schema));
+                ce.release();
             }
             for (auto&& rt : x._row_tombstones.slice(schema, r)) {
                 _row_tombstones.apply(schema, rt);
@@ -243,8 +245,10 @@ mutation_partition::operator=(mutation_partition&& x) noexcept {
 void mutation_partition::ensure_last_dummy(const schema& s) {
     check_schema(s);
     if (_rows.empty() || !_rows.rbegin()->is_last_dummy()) {
-        _rows.insert_before(_rows.end(),
-            *current_allocator().construct<rows_entry>(s, rows_entry::last_dummy_tag(), is_continuous::yes));
+        auto e = alloc_strategy_unique_ptr<rows_entry>(
+            current_allocator().construct<rows_entry>(s, rows_entry::last_dummy_tag(), is_continuous::yes));
+        _rows.insert_before(_rows.end(), *e, rows_entry::compare(s));
+        e.release();
     }
 }
 
@@ -331,8 +335,10 @@ stop_iteration mutation_partition::apply_monotonically(const schema& s, mutation
             i = _rows.lower_bound(src_e, less);
         }
         if (i == _rows.end() || less(src_e, *i)) {
-            p_i = p._rows.erase(p_i);
-            auto src_i = _rows.insert_before(i, src_e);
+            // Moves the entry from p._rows. Leaves both trees intact if allocation of nodes fails.
+            auto next_p_i = std::next(p_i);
+            auto src_i = _rows.insert_before(i, src_e, less);
+            p_i = next_p_i;
             // When falling into a continuous range, preserve continuity.
             if (i != _rows.end() && i->continuous()) {
                 src_e.set_continuous(true);
@@ -1090,6 +1096,60 @@ void deletable_row::apply_monotonically(const schema& s, deletable_row&& src) {
     _deleted_at.apply(src._deleted_at, _marker);
 }
 
+static int64_t first_component_prefix(const schema& s, bytes_view v) {
+    if (v.empty()) {
+        // Empty values sort before all other values of the type.
+        return s.clustering_prefix_reversed() ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::min();
+    }
+    auto p = reinterpret_cast<const char*>(v.data());
+    int64_t r = 0;
+    switch (s.clustering_prefix_kind()) {
+    case clustering_prefix_kind::none:
+        return 0;
+    case clustering_prefix_kind::int32:
+        r = read_be<int32_t>(p);
+        break;
+    case clustering_prefix_kind::int64:
+        r = read_be<int64_t>(p);
+        break;
+    case clustering_prefix_kind::byte_order: {
+        char buf[8] = {};
+        std::copy_n(p, std::min<size_t>(v.size(), sizeof(buf)), buf);
+        r = int64_t(read_be<uint64_t>(buf) ^ (uint64_t(1) << 63));
+        break;
+    }
+    case clustering_prefix_kind::timeuuid:
+        // Same order of timestamp bytes as in timeuuid_type_impl::compare().
+        r = (int64_t(uint8_t(p[6]) & 0xf) << 56) | (int64_t(uint8_t(p[7])) << 48)
+            | (int64_t(uint8_t(p[4])) << 40) | (int64_t(uint8_t(p[5])) << 32)
+            | (int64_t(uint8_t(p[0])) << 24) | (int64_t(uint8_t(p[1])) << 16)
+            | (int64_t(uint8_t(p[2])) << 8) | int64_t(uint8_t(p[3]));
+        break;
+    }
+    return s.clustering_prefix_reversed() ? ~r : r;
+}
+
+int64_t rows_entry::tri_compare::prefix(clustering_key_view key) const {
+    const schema& s = _s;
+    auto i = key.begin(s);
+    if (i == key.end(s)) {
+        return std::numeric_limits<int64_t>::min();
+    }
+    return first_component_prefix(s, *i);
+}
+
+int64_t rows_entry::tri_compare::prefix(position_in_partition_view p) const {
+    if (!p.has_clustering_key()) {
+        return p.region() < partition_region::clustered ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+    }
+    const schema& s = _s;
+    if (p.key().is_empty(s)) {
+        // An empty prefix with positive weight is after all keys.
+        return p.get_bound_weight() == bound_weight::after_all_prefixed ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::min();
+    }
+    return prefix(p.key().view());
+}
+
 bool
 rows_entry::equal(const schema& s, const rows_entry& other) const {
     return equal(s, other, s);
@@ -2171,9 +2231,13 @@ future<> data_query(
     }
 
     auto querier_opt = cache_ctx.lookup_data_querier(*s, range, slice, trace_ptr);
-    auto q = querier_opt
-            ? std::move(*querier_opt)
-            : query::data_querier(source, s, range, slice, service::get_local_sstable_query_read_priority(), trace_ptr);
+    auto make_querier = [&] {
+        // The result only holds the values of the selected columns.
+        auto data_slice = slice;
+        data_slice.options.set<query::partition_slice::option::skip_unselected_values>();
+        return query::data_querier(source, s, range, std::move(data_slice), service::get_local_sstable_query_read_priority(), trace_ptr);
+    };
+    auto q = querier_opt ? std::move(*querier_opt) : make_querier();
 
     return do_with(std::move(q), [=, &builder, trace_ptr = std::move(trace_ptr), cache_ctx = std::move(cache_ctx)] (query::data_querier& q) mutable {
         auto qrb = query_result_builder(*s, builder);
@@ -2346,8 +2410,10 @@ mutation_partition::mutation_partition(mutation_partition::incomplete_tag, const
     , _schema_version(s.version())
 #endif
 {
-    _rows.insert_before(_rows.end(),
-        *current_allocator().construct<rows_entry>(s, rows_entry::last_dummy_tag(), is_continuous::no));
+    auto e = alloc_strategy_unique_ptr<rows_entry>(
+        current_allocator().construct<rows_entry>(s, rows_entry::last_dummy_tag(), is_continuous::no));
+    _rows.insert_before(_rows.end(), *e, rows_entry::compare(s));
+    e.release();
 }
 
 bool mutation_partition::is_fully_continuous() const {
@@ -2384,13 +2450,18 @@ void mutation_partition::set_continuity(const schema& s, const position_range& p
 
     auto end = _rows.lower_bound(pr.end(), less);
     if (end == _rows.end() || less(pr.end(), end->position())) {
-        end = _rows.insert_before(end, *current_allocator().construct<rows_entry>(s, pr.end(), is_dummy::yes,
+        auto e = alloc_strategy_unique_ptr<rows_entry>(current_allocator().construct<rows_entry>(s, pr.end(), is_dummy::yes,
             end == _rows.end() ? is_continuous::yes : end->continuous()));
+        end = _rows.insert_before(end, *e, less);
+        e.release();
     }
 
     auto i = _rows.lower_bound(pr.start(), less);
     if (less(pr.start(), i->position())) {
-        i = _rows.insert_before(i, *current_allocator().construct<rows_entry>(s, pr.start(), is_dummy::yes, i->continuous()));
+        auto e = alloc_strategy_unique_ptr<rows_entry>(
+            current_allocator().construct<rows_entry>(s, pr.start(), is_dummy::yes, i->continuous()));
+        i = _rows.insert_before(i, *e, less);
+        e.release();
     }
 
     assert(i != end);
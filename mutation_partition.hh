@@ -44,7 +44,7 @@
 #include "hashing_partition_visitor.hh"
 #include "range_tombstone_list.hh"
 #include "clustering_key_filter.hh"
-#include "intrusive_set_external_comparator.hh"
+#include "utils/bptree.hh"
 #include "utils/with_relational_operators.hh"
 #include "utils/preempt.hh"
 #include "utils/managed_ref.hh"
@@ -1002,7 +1002,7 @@ class rows_entry {
     using lru_link_type = bi::list_member_hook<bi::link_mode<bi::auto_unlink>>;
     friend class cache_tracker;
     friend class size_calculator;
-    intrusive_set_external_comparator_member_hook _link;
+    bplus::member_hook _link;
     clustering_key _key;
     deletable_row _row;
     lru_link_type _lru_link;
@@ -1089,7 +1089,20 @@ class rows_entry {
     }
     struct tri_compare {
         position_in_partition::tri_compare _c;
-        explicit tri_compare(const schema& s) : _c(s) {}
+        std::reference_wrapper<const schema> _s;
+        explicit tri_compare(const schema& s) : _c(s), _s(s) {}
+
+        // Returns a key consistent with the clustering order of positions, that is
+        // prefix(p1) < prefix(p2) implies p1 < p2. Used by bplus::tree to avoid
+        // full key comparisons. See clustering_prefix_kind.
+        int64_t prefix(position_in_partition_view p) const;
+        int64_t prefix(clustering_key_view key) const;
+        int64_t prefix(const clustering_key& key) const {
+            return prefix(position_in_partition_view::for_key(key));
+        }
+        int64_t prefix(const rows_entry& e) const {
+            return prefix(e.position());
+        }
         int operator()(const rows_entry& e1, const rows_entry& e2) const {
             return _c(e1.position(), e2.position());
         }
@@ -1112,6 +1125,10 @@ class rows_entry {
     struct compare {
         tri_compare _c;
         explicit compare(const schema& s) : _c(s) {}
+        template<typename K>
+        int64_t prefix(const K& k) const {
+            return _c.prefix(k);
+        }
         bool operator()(const rows_entry& e1, const rows_entry& e2) const {
             return _c(e1, e2) < 0;
         }
@@ -1206,7 +1223,7 @@ struct mutation_application_stats {
 // in the doc in partition_version.hh.
 class mutation_partition final {
 public:
-    using rows_type = intrusive_set_external_comparator<rows_entry, &rows_entry::_link>;
+    using rows_type = bplus::tree<rows_entry, &rows_entry::_link>;
     friend class rows_entry;
     friend class size_calculator;
 private:
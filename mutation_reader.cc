@@ -28,6 +28,7 @@
 #include <seastar/core/future-util.hh>
 #include "flat_mutation_reader.hh"
 #include "schema_registry.hh"
+#include "utils/tournament_tree.hh"
 
 
 static constexpr size_t merger_small_vector_size = 4;
@@ -171,8 +172,10 @@ class mutation_reader_merger {
     // reader in order to enter gallop mode. Must be greater than one.
     static constexpr int gallop_mode_entering_threshold = 3;
 private:
-    struct reader_heap_compare;
-    struct fragment_heap_compare;
+    struct reader_less_compare;
+    struct fragment_less_compare;
+    using reader_heap_type = utils::tournament_tree<reader_and_fragment, reader_less_compare, merger_small_vector_size>;
+    using fragment_heap_type = utils::tournament_tree<reader_and_fragment, fragment_less_compare, merger_small_vector_size>;
 
     struct needs_merge_tag { };
     using needs_merge = bool_class<needs_merge_tag>;
@@ -190,10 +193,12 @@ class mutation_reader_merger {
     // Readers positioned at a partition, different from the one we are
     // reading from now. For these readers the attached fragment is
     // always partition_start. Used to pick the next partition.
-    merger_vector<reader_and_fragment> _reader_heap;
+    // Both "heaps" are tournament trees, which need fewer comparisons
+    // than a binary heap when merging many readers.
+    reader_heap_type _reader_heap;
     // Readers and their current fragments, belonging to the current
     // partition.
-    merger_vector<reader_and_fragment> _fragment_heap;
+    fragment_heap_type _fragment_heap;
     merger_vector<reader_and_last_fragment_kind> _next;
     // Readers that reached EOS.
     merger_vector<reader_and_last_fragment_kind> _halted_readers;
@@ -204,6 +209,12 @@ class mutation_reader_merger {
     // end, a call to next_partition() or a call to
     // fast_forward_to(dht::partition_range).
     reader_and_last_fragment_kind _single_reader;
+    // The reader which was the _single_reader of the partition which just
+    // ended. If its next partition also comes before those of all other
+    // readers, it becomes the _single_reader again without going through
+    // _reader_heap. Common when the readers hold runs of partitions, e.g.
+    // sstables of different tiers of a size-tiered table.
+    reader_iterator _single_reader_run{};
     // Holds a reference to the reader that previously contributed a fragment.
     // When a reader consecutively contributes a certain number of fragments,
     // gallop mode becomes enabled. In this mode, it is assumed that
@@ -224,6 +235,9 @@ class mutation_reader_merger {
     future<needs_merge> prepare_one(db::timeout_clock::time_point timeout, reader_and_last_fragment_kind rk, reader_galloping reader_galloping);
     future<needs_merge> advance_galloping_reader(db::timeout_clock::time_point timeout);
     future<> prepare_next(db::timeout_clock::time_point timeout);
+    // Tries to continue reading the next partition from _single_reader_run alone.
+    // Returns false if the merging logic is needed.
+    bool continue_single_reader_run();
     // Collect all forwardable readers into _next, and remove them from
     // their previous containers (_halted_readers and _fragment_heap).
     void prepare_forwardable_readers();
@@ -298,31 +312,31 @@ void mutation_reader_merger::add_readers(std::vector<flat_mutation_reader> new_r
         _all_readers.emplace_back(std::move(new_reader));
         _next.emplace_back(std::prev(_all_readers.end()), mutation_fragment::kind::partition_end);
     }
+    _reader_heap.reserve(_all_readers.size());
+    _fragment_heap.reserve(_all_readers.size());
 }
 
-struct mutation_reader_merger::reader_heap_compare {
+struct mutation_reader_merger::reader_less_compare {
     const schema& s;
 
-    explicit reader_heap_compare(const schema& s)
+    explicit reader_less_compare(const schema& s)
         : s(s) {
     }
 
-    bool operator()(const mutation_reader_merger::reader_and_fragment& a, const mutation_reader_merger::reader_and_fragment& b) {
-        // Invert comparison as this is a max-heap.
-        return b.fragment.as_partition_start().key().less_compare(s, a.fragment.as_partition_start().key());
+    bool operator()(const mutation_reader_merger::reader_and_fragment& a, const mutation_reader_merger::reader_and_fragment& b) const {
+        return a.fragment.as_partition_start().key().less_compare(s, b.fragment.as_partition_start().key());
     }
 };
 
-struct mutation_reader_merger::fragment_heap_compare {
+struct mutation_reader_merger::fragment_less_compare {
     position_in_partition::less_compare cmp;
 
-    explicit fragment_heap_compare(const schema& s)
+    explicit fragment_less_compare(const schema& s)
         : cmp(s) {
     }
 
-    bool operator()(const mutation_reader_merger::reader_and_fragment& a, const mutation_reader_merger::reader_and_fragment& b) {
-        // Invert comparison as this is a max-heap.
-        return cmp(b.fragment.position(), a.fragment.position());
+    bool operator()(const mutation_reader_merger::reader_and_fragment& a, const mutation_reader_merger::reader_and_fragment& b) const {
+        return cmp(a.fragment.position(), b.fragment.position());
     }
 };
 
@@ -338,7 +352,7 @@ void mutation_reader_merger::maybe_add_readers_at_partition_boundary() {
         if (_reader_heap.empty()) {
             maybe_add_readers(std::nullopt);
         } else {
-            maybe_add_readers(_reader_heap.front().fragment.as_partition_start().key());
+            maybe_add_readers(_reader_heap.top().fragment.as_partition_start().key());
         }
     }
 }
@@ -364,13 +378,12 @@ future<mutation_reader_merger::needs_merge> mutation_reader_merger::prepare_one(
     return (*rk.reader)(timeout).then([this, rk, reader_galloping] (mutation_fragment_opt mfo) {
         if (mfo) {
             if (mfo->is_partition_start()) {
-                _reader_heap.emplace_back(rk.reader, std::move(*mfo));
-                boost::push_heap(_reader_heap, reader_heap_compare(*_schema));
+                _reader_heap.push(reader_and_fragment(rk.reader, std::move(*mfo)));
             } else {
                 if (reader_galloping) {
                     // Optimization: assume that galloping reader will keep winning, and compare directly with the heap front.
                     // If this assumption is correct, we do one key comparison instead of pushing to/popping from the heap.
-                    if (_fragment_heap.empty() || position_in_partition::less_compare(*_schema)(mfo->position(), _fragment_heap.front().fragment.position())) {
+                    if (_fragment_heap.empty() || position_in_partition::less_compare(*_schema)(mfo->position(), _fragment_heap.top().fragment.position())) {
                         _current.clear();
                         _current.push_back(std::move(*mfo));
                         _galloping_reader.last_kind = _current.back().mutation_fragment_kind();
@@ -380,8 +393,7 @@ future<mutation_reader_merger::needs_merge> mutation_reader_merger::prepare_one(
                     _gallop_mode_hits = 0;
                 }
 
-                _fragment_heap.emplace_back(rk.reader, std::move(*mfo));
-                boost::range::push_heap(_fragment_heap, fragment_heap_compare(*_schema));
+                _fragment_heap.push(reader_and_fragment(rk.reader, std::move(*mfo)));
             }
         } else if (_fwd_sm == streamed_mutation::forwarding::yes && rk.last_kind != mutation_fragment::kind::partition_end) {
             // When in streamed_mutation::forwarding mode we need
@@ -417,13 +429,16 @@ void mutation_reader_merger::prepare_forwardable_readers() {
     if (_single_reader.reader != reader_iterator{}) {
         _next.emplace_back(std::exchange(_single_reader.reader, {}), _single_reader.last_kind);
     }
+    if (_single_reader_run != reader_iterator{}) {
+        _next.emplace_back(std::exchange(_single_reader_run, {}), mutation_fragment::kind::partition_end);
+    }
     if (in_gallop_mode()) {
         _next.emplace_back(_galloping_reader);
         _gallop_mode_hits = 0;
     }
-    for (auto& df : _fragment_heap) {
+    _fragment_heap.for_each([this] (reader_and_fragment& df) {
         _next.emplace_back(df.reader, df.fragment.mutation_fragment_kind());
-    }
+    });
 
     _halted_readers.clear();
     _fragment_heap.clear();
@@ -434,12 +449,34 @@ mutation_reader_merger::mutation_reader_merger(schema_ptr schema,
         streamed_mutation::forwarding fwd_sm,
         mutation_reader::forwarding fwd_mr)
     : _selector(std::move(selector))
+    , _reader_heap(reader_less_compare(*schema))
+    , _fragment_heap(fragment_less_compare(*schema))
     , _schema(std::move(schema))
     , _fwd_sm(fwd_sm)
     , _fwd_mr(fwd_mr) {
     maybe_add_readers(std::nullopt);
 }
 
+bool mutation_reader_merger::continue_single_reader_run() {
+    auto& reader = *_single_reader_run;
+    if (reader.is_buffer_empty() || !reader.peek_buffer().is_partition_start()
+            || !_next.empty() || !_halted_readers.empty() || !_fragment_heap.empty()) {
+        return false;
+    }
+    auto& key = reader.peek_buffer().as_partition_start().key();
+    if (!_reader_heap.empty() && !key.less_compare(*_schema, _reader_heap.top().fragment.as_partition_start().key())) {
+        return false;
+    }
+    if (_selector->has_new_readers(dht::ring_position_view(key))) {
+        return false;
+    }
+    _single_reader = { std::exchange(_single_reader_run, {}), mutation_fragment::kind::partition_start };
+    _current.clear();
+    _current.emplace_back(_single_reader.reader->pop_mutation_fragment());
+    _gallop_mode_hits = 0;
+    return true;
+}
+
 future<mutation_reader_merger::mutation_fragment_batch> mutation_reader_merger::operator()(db::timeout_clock::time_point timeout) {
     // Avoid merging-related logic if we know that only a single reader owns
     // current partition.
@@ -455,11 +492,21 @@ future<mutation_reader_merger::mutation_fragment_batch> mutation_reader_merger::
         _current.emplace_back(_single_reader.reader->pop_mutation_fragment());
         _single_reader.last_kind = _current.back().mutation_fragment_kind();
         if (_current.back().is_end_of_partition()) {
-            _next.emplace_back(std::exchange(_single_reader.reader, {}), mutation_fragment::kind::partition_end);
+            _single_reader_run = std::exchange(_single_reader.reader, {});
         }
         return make_ready_future<mutation_fragment_batch>(_current);
     }
 
+    if (_single_reader_run != reader_iterator{}) {
+        if (_single_reader_run->is_buffer_empty() && !_single_reader_run->is_end_of_stream()) {
+            return _single_reader_run->fill_buffer(timeout).then([this, timeout] { return operator()(timeout); });
+        }
+        if (continue_single_reader_run()) {
+            return make_ready_future<mutation_fragment_batch>(_current);
+        }
+        _next.emplace_back(std::exchange(_single_reader_run, {}), mutation_fragment::kind::partition_end);
+    }
+
     if (in_gallop_mode()) {
         return advance_galloping_reader(timeout).then([this, timeout] (needs_merge needs_merge) {
             if (!needs_merge) {
@@ -484,37 +531,32 @@ future<mutation_reader_merger::mutation_fragment_batch> mutation_reader_merger::
             return make_ready_future<mutation_fragment_batch>(_current);
         }
 
-        auto key = [] (const merger_vector<reader_and_fragment>& heap) -> const dht::decorated_key& {
-            return heap.front().fragment.as_partition_start().key();
+        auto key = [] (const reader_and_fragment& rf) -> const dht::decorated_key& {
+            return rf.fragment.as_partition_start().key();
         };
 
-        do {
-            boost::range::pop_heap(_reader_heap, reader_heap_compare(*_schema));
-            // All fragments here are partition_start so no need to
-            // heap-sort them.
-            _fragment_heap.emplace_back(std::move(_reader_heap.back()));
-            _reader_heap.pop_back();
-        }
-        while (!_reader_heap.empty() && key(_fragment_heap).equal(*_schema, key(_reader_heap)));
-        if (_fragment_heap.size() == 1) {
-            _single_reader = { _fragment_heap.back().reader, mutation_fragment::kind::partition_start };
-            _current.emplace_back(std::move(_fragment_heap.back().fragment));
-            _fragment_heap.clear();
+        auto first = _reader_heap.pop();
+        if (_reader_heap.empty() || !key(first).equal(*_schema, key(_reader_heap.top()))) {
+            _single_reader = { first.reader, mutation_fragment::kind::partition_start };
+            _current.emplace_back(std::move(first.fragment));
             _gallop_mode_hits = 0;
             return make_ready_future<mutation_fragment_batch>(_current);
         }
+        do {
+            _fragment_heap.push(_reader_heap.pop());
+        }
+        while (!_reader_heap.empty() && key(first).equal(*_schema, key(_reader_heap.top())));
+        _fragment_heap.push(std::move(first));
     }
 
     const auto equal = position_in_partition::equal_compare(*_schema);
     do {
-        boost::range::pop_heap(_fragment_heap, fragment_heap_compare(*_schema));
-        auto& n = _fragment_heap.back();
+        auto n = _fragment_heap.pop();
         const auto kind = n.fragment.mutation_fragment_kind();
         _current.emplace_back(std::move(n.fragment));
         _next.emplace_back(n.reader, kind);
-        _fragment_heap.pop_back();
     }
-    while (!_fragment_heap.empty() && equal(_current.back().position(), _fragment_heap.front().fragment.position()));
+    while (!_fragment_heap.empty() && equal(_current.back().position(), _fragment_heap.top().fragment.position()));
 
     if (_next.size() == 1 && _next.front().reader == _galloping_reader.reader) {
         ++_gallop_mode_hits;
@@ -540,6 +582,7 @@ void mutation_reader_merger::next_partition() {
 
 future<> mutation_reader_merger::fast_forward_to(const dht::partition_range& pr, db::timeout_clock::time_point timeout) {
     _single_reader = { };
+    _single_reader_run = { };
     _gallop_mode_hits = 0;
     _next.clear();
     _halted_readers.clear();
@@ -686,8 +729,7 @@ class restricting_mutation_reader : public flat_mutation_reader::impl {
         flat_mutation_reader reader;
     };
     std::variant<pending_state, admitted_state> _state;
-
-    static const ssize_t new_reader_base_cost{16 * 1024};
+    size_t _memory_cost;
 
     template<typename Function>
     GCC6_CONCEPT(
@@ -701,7 +743,7 @@ class restricting_mutation_reader : public flat_mutation_reader::impl {
             return fn(state->reader);
         }
 
-        return std::get<pending_state>(_state).semaphore.wait_admission(new_reader_base_cost,
+        return std::get<pending_state>(_state).semaphore.wait_admission(_memory_cost,
                 timeout).then([this, fn = std::move(fn)] (reader_permit permit) mutable {
             auto reader_factory = std::move(std::get<pending_state>(_state).reader_factory);
             _state.emplace<admitted_state>(admitted_state{reader_factory(std::move(permit))});
@@ -717,10 +759,12 @@ class restricting_mutation_reader : public flat_mutation_reader::impl {
             const io_priority_class& pc,
             tracing::trace_state_ptr trace_state,
             streamed_mutation::forwarding fwd,
-            mutation_reader::forwarding fwd_mr)
+            mutation_reader::forwarding fwd_mr,
+            size_t memory_cost)
         : impl(s)
         , _state(pending_state{semaphore,
-                mutation_source_and_params{std::move(ms), std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr}}) {
+                mutation_source_and_params{std::move(ms), std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr}})
+        , _memory_cost(memory_cost) {
     }
 
     virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
@@ -772,8 +816,10 @@ make_restricted_flat_reader(reader_concurrency_semaphore& semaphore,
                        const io_priority_class& pc,
                        tracing::trace_state_ptr trace_state,
                        streamed_mutation::forwarding fwd,
-                       mutation_reader::forwarding fwd_mr) {
-    return make_flat_mutation_reader<restricting_mutation_reader>(semaphore, std::move(ms), std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr);
+                       mutation_reader::forwarding fwd_mr,
+                       size_t memory_cost) {
+    return make_flat_mutation_reader<restricting_mutation_reader>(semaphore, std::move(ms), std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr,
+            memory_cost);
 }
 
 
@@ -1034,6 +1080,8 @@ class shard_reader : public enable_lw_shared_from_this<shard_reader>, public fla
         bool should_drop_fragment(const mutation_fragment& mf);
         future<> do_fill_buffer(flat_mutation_reader& reader, db::timeout_clock::time_point timeout);
         future<> fill_buffer(flat_mutation_reader& reader, circular_buffer<mutation_fragment>& buffer, db::timeout_clock::time_point timeout);
+        future<> fill_buffer(flat_mutation_reader& reader, circular_buffer<mutation_fragment>& buffer, size_t size,
+                db::timeout_clock::time_point timeout);
 
     public:
         remote_reader(
@@ -1044,7 +1092,8 @@ class shard_reader : public enable_lw_shared_from_this<shard_reader>, public fla
                 const io_priority_class& pc,
                 tracing::trace_state_ptr trace_state,
                 mutation_reader::forwarding fwd_mr);
-        future<fill_buffer_result> fill_buffer(const dht::partition_range& pr, bool pending_next_partition, db::timeout_clock::time_point timeout);
+        future<fill_buffer_result> fill_buffer(const dht::partition_range& pr, bool pending_next_partition, size_t size,
+                db::timeout_clock::time_point timeout);
         future<> fast_forward_to(const dht::partition_range& pr, db::timeout_clock::time_point timeout);
         reader_concurrency_semaphore::inactive_read_handle inactive_read_handle() && {
             return std::move(_irh);
@@ -1064,8 +1113,23 @@ class shard_reader : public enable_lw_shared_from_this<shard_reader>, public fla
     std::optional<future<>> _read_ahead;
     foreign_ptr<std::unique_ptr<remote_reader>> _reader;
 
+    // The amount of data read from the remote shard in a single round trip.
+    // It grows when the multishard reader has to wait for the remote shard,
+    // that is when it consumes the data faster than the round trips deliver
+    // it, and shrinks when the read-ahead is found ready several times in a
+    // row. It is never less than a few fragments, so that shards with large
+    // fragments don't pay a round trip for each of them.
+    static constexpr size_t min_fill_size = 8 * 1024;
+    static constexpr size_t max_fill_size = 128 * 1024;
+    static constexpr size_t min_fragments_per_fill = 4;
+    static constexpr unsigned ready_fills_before_shrinking = 8;
+    size_t _fill_size = min_fill_size;
+    size_t _avg_fragment_size = 0;
+    unsigned _ready_fills = 0;
+
 private:
     future<> do_fill_buffer(db::timeout_clock::time_point timeout);
+    void update_fill_size(size_t fill_size);
 
 public:
     shard_reader(
@@ -1105,6 +1169,8 @@ class shard_reader : public enable_lw_shared_from_this<shard_reader>, public fla
     bool done() const {
         return _reader && is_buffer_empty() && is_end_of_stream();
     }
+    // Starts filling the buffer in the background, if it is less than half
+    // full, so that the next round trip overlaps with consuming the buffer.
     void read_ahead(db::timeout_clock::time_point timeout);
     bool is_read_ahead_in_progress() const {
         return _read_ahead.has_value();
@@ -1340,20 +1406,50 @@ shard_reader::remote_reader::remote_reader(
     , _tri_cmp(*_schema) {
 }
 
-future<shard_reader::fill_buffer_result> shard_reader::remote_reader::fill_buffer(const dht::partition_range& pr, bool pending_next_partition,
+future<> shard_reader::remote_reader::fill_buffer(flat_mutation_reader& reader, circular_buffer<mutation_fragment>& buffer, size_t size,
         db::timeout_clock::time_point timeout) {
+    return fill_buffer(reader, buffer, timeout).then([this, &reader, &buffer, size, timeout] {
+        size_t buffer_size = 0;
+        for (const auto& mf : buffer) {
+            buffer_size += mf.memory_usage(*_schema);
+        }
+        // Each fill ends on a fragment which is safe to stop at, so keep
+        // appending fills until the buffer has the requested size.
+        return do_with(buffer_size, circular_buffer<mutation_fragment>{},
+                [this, &reader, &buffer, size, timeout] (size_t& buffer_size, circular_buffer<mutation_fragment>& more) {
+            return do_until([&reader, &buffer_size, size] { return buffer_size >= size || (reader.is_end_of_stream() && reader.is_buffer_empty()); },
+                    [this, &reader, &buffer, &buffer_size, &more, timeout] {
+                return fill_buffer(reader, more, timeout).then([this, &buffer, &buffer_size, &more] {
+                    if (more.empty()) {
+                        // Nothing more to read, stop.
+                        buffer_size = std::numeric_limits<size_t>::max();
+                        return;
+                    }
+                    for (auto& mf : more) {
+                        buffer_size += mf.memory_usage(*_schema);
+                        buffer.emplace_back(std::move(mf));
+                    }
+                    more.clear();
+                });
+            });
+        });
+    });
+}
+
+future<shard_reader::fill_buffer_result> shard_reader::remote_reader::fill_buffer(const dht::partition_range& pr, bool pending_next_partition,
+        size_t size, db::timeout_clock::time_point timeout) {
     // We could have missed a `fast_forward_to()` if the reader wasn't created yet.
     _pr = &pr;
     if (pending_next_partition) {
         _next_position_in_partition = position_in_partition::for_partition_start();
     }
     return do_with(resume_or_create_reader(), circular_buffer<mutation_fragment>{},
-            [this, pending_next_partition, timeout] (flat_mutation_reader& reader, circular_buffer<mutation_fragment>& buffer) mutable {
+            [this, pending_next_partition, size, timeout] (flat_mutation_reader& reader, circular_buffer<mutation_fragment>& buffer) mutable {
         if (pending_next_partition) {
             reader.next_partition();
         }
 
-        return fill_buffer(reader, buffer, timeout).then([this, &reader, &buffer] {
+        return fill_buffer(reader, buffer, size, timeout).then([this, &reader, &buffer] {
             const auto eos = reader.is_end_of_stream() && reader.is_buffer_empty();
             _irh = _lifecycle_policy.pause(std::move(reader));
             return fill_buffer_result(std::move(buffer), eos);
@@ -1388,10 +1484,13 @@ future<> shard_reader::do_fill_buffer(db::timeout_clock::time_point timeout) {
         fill_buffer_result result;
     };
 
+    auto& stats = get_multishard_reader_stats();
+    ++stats.cross_shard_fills;
+
     if (!_reader) {
-        fill_buf_fut = smp::submit_to(_shard, [this, gs = global_schema_ptr(_schema), pending_next_partition, timeout] {
+        fill_buf_fut = smp::submit_to(_shard, [this, gs = global_schema_ptr(_schema), pending_next_partition, fill_size = _fill_size, timeout] {
             auto rreader = make_foreign(std::make_unique<remote_reader>(gs.get(), *_lifecycle_policy, *_pr, _ps, _pc, _trace_state, _fwd_mr));
-            auto f = rreader->fill_buffer(*_pr, pending_next_partition, timeout);
+            auto f = rreader->fill_buffer(*_pr, pending_next_partition, fill_size, timeout);
             return f.then([rreader = std::move(rreader)] (fill_buffer_result res) mutable {
                 return make_ready_future<reader_and_buffer_fill_result>(reader_and_buffer_fill_result{std::move(rreader), std::move(res)});
             });
@@ -1400,27 +1499,61 @@ future<> shard_reader::do_fill_buffer(db::timeout_clock::time_point timeout) {
             return std::move(res.result);
         });
     } else {
-        fill_buf_fut = smp::submit_to(_shard, [this, pending_next_partition, timeout] () mutable {
-            return _reader->fill_buffer(*_pr, pending_next_partition, timeout);
+        fill_buf_fut = smp::submit_to(_shard, [this, pending_next_partition, fill_size = _fill_size, timeout] () mutable {
+            return _reader->fill_buffer(*_pr, pending_next_partition, fill_size, timeout);
         });
     }
 
-    return fill_buf_fut.then([this, zis = shared_from_this()] (fill_buffer_result res) mutable {
+    return fill_buf_fut.then([this, &stats, zis = shared_from_this()] (fill_buffer_result res) mutable {
         _end_of_stream = res.end_of_stream;
+        size_t fill_size = 0;
         for (const auto& mf : *res.buffer) {
+            // next_partition() was called while this fill was in flight and
+            // emptied the buffer, skip what is left of the partition.
+            if (_pending_next_partition) {
+                if (!mf.is_partition_start()) {
+                    continue;
+                }
+                _pending_next_partition = false;
+            }
             push_mutation_fragment(mutation_fragment(*_schema, mf));
+            fill_size += buffer().back().memory_usage(*_schema);
+        }
+        stats.cross_shard_fill_bytes += fill_size;
+        if (!res.buffer->empty()) {
+            _avg_fragment_size = (_avg_fragment_size + fill_size / res.buffer->size()) / 2;
         }
     });
 }
 
+void shard_reader::update_fill_size(size_t fill_size) {
+    _fill_size = std::clamp(std::max(fill_size, min_fragments_per_fill * _avg_fragment_size), min_fill_size, max_fill_size);
+}
+
 future<> shard_reader::fill_buffer(db::timeout_clock::time_point timeout) {
-    if (_read_ahead) {
-        return *std::exchange(_read_ahead, std::nullopt);
-    }
     if (!is_buffer_empty()) {
         return make_ready_future<>();
     }
-    return do_fill_buffer(timeout);
+    if (_read_ahead && _read_ahead->available()) {
+        // Its fragments, if any, were already consumed.
+        auto f = std::move(*std::exchange(_read_ahead, std::nullopt));
+        if (f.failed()) {
+            return f;
+        }
+    }
+
+    // We have to wait for the remote shard. Unless this is the first fill,
+    // we are consuming faster than the shard delivers, read more at once.
+    if (_reader) {
+        _ready_fills = 0;
+        update_fill_size(_fill_size * 2);
+    }
+    auto& stats = get_multishard_reader_stats();
+    ++stats.cross_shard_stalls;
+    auto f = _read_ahead ? *std::exchange(_read_ahead, std::nullopt) : do_fill_buffer(timeout);
+    return f.finally([&stats, start = std::chrono::steady_clock::now()] {
+        stats.cross_shard_stall_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    });
 }
 
 void shard_reader::next_partition() {
@@ -1440,11 +1573,13 @@ future<> shard_reader::fast_forward_to(const dht::partition_range& pr, db::timeo
         return make_ready_future<>();
     }
 
-    _end_of_stream = false;
-    clear_buffer();
-
     auto f = _read_ahead ? *std::exchange(_read_ahead, std::nullopt) : make_ready_future<>();
     return f.then([this, &pr, timeout] {
+        // Only clear the buffer after the read-ahead (if any) is done, so
+        // that fragments of the previous range are not left in it.
+        _end_of_stream = false;
+        _pending_next_partition = false;
+        clear_buffer();
         return smp::submit_to(_shard, [this, &pr, timeout] {
             return _reader->fast_forward_to(pr, timeout);
         });
@@ -1456,7 +1591,19 @@ future<> shard_reader::fast_forward_to(position_range, db::timeout_clock::time_p
 }
 
 void shard_reader::read_ahead(db::timeout_clock::time_point timeout) {
-    if (_read_ahead || is_end_of_stream() || !is_buffer_empty()) {
+    if (_read_ahead) {
+        if (!_read_ahead->available() || _read_ahead->failed()) {
+            return;
+        }
+        // The previous read-ahead completed before its fragments were
+        // needed, see whether it can do with less.
+        _read_ahead.reset();
+        if (++_ready_fills == ready_fills_before_shrinking) {
+            _ready_fills = 0;
+            update_fill_size(_fill_size / 2);
+        }
+    }
+    if (is_end_of_stream() || buffer_size() >= _fill_size / 2) {
         return;
     }
 
@@ -1465,6 +1612,11 @@ void shard_reader::read_ahead(db::timeout_clock::time_point timeout) {
 
 } // anonymous namespace
 
+multishard_reader_stats& get_multishard_reader_stats() {
+    static thread_local multishard_reader_stats stats;
+    return stats;
+}
+
 // See make_multishard_combining_reader() for description.
 class multishard_combining_reader : public flat_mutation_reader::impl {
     struct shard_and_token {
@@ -1485,10 +1637,15 @@ class multishard_combining_reader : public flat_mutation_reader::impl {
     std::vector<shard_and_token> _shard_selection_min_heap;
     unsigned _current_shard;
     bool _crossed_shards;
-    unsigned _concurrency = 1;
+    unsigned _concurrency;
+    const unsigned _max_concurrency;
+    // Keep the next _concurrency - 1 shards reading ahead, regardless of
+    // whether we found an empty buffer.
+    const bool _parallel;
 
     void on_partition_range_change(const dht::partition_range& pr);
     bool maybe_move_to_next_shard(const dht::token* const t = nullptr);
+    void read_ahead_next_shards(db::timeout_clock::time_point timeout);
     future<> handle_empty_reader_buffer(db::timeout_clock::time_point timeout);
 
 public:
@@ -1500,7 +1657,8 @@ class multishard_combining_reader : public flat_mutation_reader::impl {
             const query::partition_slice& ps,
             const io_priority_class& pc,
             tracing::trace_state_ptr trace_state,
-            mutation_reader::forwarding fwd_mr);
+            mutation_reader::forwarding fwd_mr,
+            multishard_reader_concurrency concurrency);
 
     ~multishard_combining_reader();
 
@@ -1556,6 +1714,12 @@ bool multishard_combining_reader::maybe_move_to_next_shard(const dht::token* con
     return true;
 }
 
+void multishard_combining_reader::read_ahead_next_shards(db::timeout_clock::time_point timeout) {
+    for (unsigned i = 1; i < _concurrency; ++i) {
+        _shard_readers[(_current_shard + i) % _partitioner.shard_count()]->read_ahead(timeout);
+    }
+}
+
 future<> multishard_combining_reader::handle_empty_reader_buffer(db::timeout_clock::time_point timeout) {
     auto& reader = *_shard_readers[_current_shard];
 
@@ -1573,14 +1737,12 @@ future<> multishard_combining_reader::handle_empty_reader_buffer(db::timeout_clo
         // double concurrency so the next time we cross shards we will have
         // more chances of hitting the reader's buffer.
         if (_crossed_shards) {
-            _concurrency = std::min(_concurrency * 2, _partitioner.shard_count());
+            _concurrency = std::min(_concurrency * 2, _max_concurrency);
 
             // If concurrency > 1 we kick-off concurrency-1 read-aheads in the
             // background. They will be brought to the foreground when we move
             // to their respective shard.
-            for (unsigned i = 1; i < _concurrency; ++i) {
-                _shard_readers[(_current_shard + i) % _partitioner.shard_count()]->read_ahead(timeout);
-            }
+            read_ahead_next_shards(timeout);
         }
         return reader.fill_buffer(timeout);
     }
@@ -1594,9 +1756,13 @@ multishard_combining_reader::multishard_combining_reader(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr)
+        mutation_reader::forwarding fwd_mr,
+        multishard_reader_concurrency concurrency)
     : impl(std::move(s))
-    , _partitioner(partitioner) {
+    , _partitioner(partitioner)
+    , _max_concurrency(std::clamp(concurrency.max, 1u, _partitioner.shard_count()))
+    , _parallel(concurrency.initial > 1 && _max_concurrency > 1) {
+    _concurrency = std::clamp(concurrency.initial, 1u, _max_concurrency);
 
     on_partition_range_change(pr);
 
@@ -1614,6 +1780,9 @@ multishard_combining_reader::~multishard_combining_reader() {
 
 future<> multishard_combining_reader::fill_buffer(db::timeout_clock::time_point timeout) {
     _crossed_shards = false;
+    if (_parallel) {
+        read_ahead_next_shards(timeout);
+    }
     return do_until([this] { return is_buffer_full() || is_end_of_stream(); }, [this, timeout] {
         auto& reader = *_shard_readers[_current_shard];
 
@@ -1627,6 +1796,8 @@ future<> multishard_combining_reader::fill_buffer(db::timeout_clock::time_point
             }
             push_mutation_fragment(reader.pop_mutation_fragment());
         }
+        // Fetch the next fragments of this shard while ours are consumed.
+        reader.read_ahead(timeout);
         return make_ready_future<>();
     });
 }
@@ -1702,9 +1873,10 @@ flat_mutation_reader make_multishard_combining_reader(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state,
-        mutation_reader::forwarding fwd_mr) {
+        mutation_reader::forwarding fwd_mr,
+        multishard_reader_concurrency concurrency) {
     return make_flat_mutation_reader<multishard_combining_reader>(std::move(lifecycle_policy), partitioner, std::move(schema), pr, ps, pc,
-            std::move(trace_state), fwd_mr);
+            std::move(trace_state), fwd_mr, concurrency);
 }
 
 class queue_reader final : public flat_mutation_reader::impl {
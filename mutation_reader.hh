@@ -22,6 +22,9 @@
 #pragma once
 
 #include <vector>
+#include <limits>
+#include <chrono>
+#include <algorithm>
 
 #include "mutation.hh"
 #include "clustering_key_filter.hh"
@@ -307,6 +310,9 @@ class snapshot_source {
 mutation_source make_empty_mutation_source();
 snapshot_source make_empty_snapshot_source();
 
+// The memory a small read is expected to consume.
+constexpr size_t restricted_reader_base_cost = 16 * 1024;
+
 // Creates a restricted reader whose resource usages will be tracked
 // during it's lifetime. If there are not enough resources (dues to
 // existing readers) to create the new reader, it's construction will
@@ -316,6 +322,9 @@ snapshot_source make_empty_snapshot_source();
 // a semaphore to track and limit the memory usage of readers. It also
 // contains a timeout and a maximum queue size for inactive readers
 // whose construction is blocked.
+// The reader is admitted with memory_cost, the memory it is expected to
+// consume, which should be the cost of a small read unless the caller has
+// a better estimate (see reader_concurrency_semaphore::wait_admission()).
 flat_mutation_reader make_restricted_flat_reader(reader_concurrency_semaphore& semaphore,
         mutation_source ms,
         schema_ptr s,
@@ -324,7 +333,8 @@ flat_mutation_reader make_restricted_flat_reader(reader_concurrency_semaphore& s
         const io_priority_class& pc = default_priority_class(),
         tracing::trace_state_ptr trace_state = nullptr,
         streamed_mutation::forwarding fwd = streamed_mutation::forwarding::no,
-        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::yes);
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::yes,
+        size_t memory_cost = restricted_reader_base_cost);
 
 inline flat_mutation_reader make_restricted_flat_reader(reader_concurrency_semaphore& semaphore,
                                               mutation_source ms,
@@ -465,6 +475,36 @@ class reader_lifecycle_policy {
     flat_mutation_reader_opt try_resume(reader_concurrency_semaphore::inactive_read_handle irh);
 };
 
+/// Statistics of the multishard_combining_readers of the local shard.
+struct multishard_reader_stats {
+    /// Round trips made to shards to fill shard reader buffers.
+    uint64_t cross_shard_fills = 0;
+    /// The size of the fragments received in them.
+    uint64_t cross_shard_fill_bytes = 0;
+    /// Round trips the reader had to wait for, because the read-ahead did
+    /// not keep up with it.
+    uint64_t cross_shard_stalls = 0;
+    std::chrono::microseconds cross_shard_stall_time{0};
+};
+
+multishard_reader_stats& get_multishard_reader_stats();
+
+/// The number of shards a multishard_combining_reader reads concurrently.
+struct multishard_reader_concurrency {
+    /// The concurrency the read starts with. Values greater than one make
+    /// the read parallel.
+    unsigned initial = 1;
+    /// The concurrency is never increased above this, nor above the number
+    /// of shards.
+    unsigned max = std::numeric_limits<unsigned>::max();
+
+    /// Reads max shards (at least one) in parallel.
+    static multishard_reader_concurrency parallel(unsigned max) {
+        max = std::max(max, 1u);
+        return multishard_reader_concurrency{max, max};
+    }
+};
+
 /// Make a multishard_combining_reader.
 ///
 /// multishard_combining_reader takes care of reading a range from all shards
@@ -479,8 +519,18 @@ class reader_lifecycle_policy {
 /// has to move between shards often. When concurrency is > 1, the reader
 /// issues background read-aheads to the next shards so that by the time it
 /// needs to move to them they have the data ready.
-/// For dense tables (where we rarely cross shards) we rely on the
-/// foreign_reader to issue sufficient read-aheads on its own to avoid blocking.
+/// For dense tables (where we rarely cross shards) the reader of the current
+/// shard reads ahead once its buffer is half consumed. The amount of data
+/// read from a shard in a single round trip adapts to how fast the shard's
+/// data is consumed: it grows each time the reader has to wait for the shard
+/// and shrinks when the read-ahead keeps completing before it is needed.
+/// See multishard_reader_stats for how often the reader waits.
+///
+/// Large scans can instead be read in parallel, by starting with a
+/// concurrency greater than one (see multishard_reader_concurrency). The
+/// reader then keeps the next concurrency - 1 shards reading ahead all the
+/// time, not only after finding an empty buffer, so that all of them scan
+/// their subranges while the reader merges their output.
 ///
 /// The readers' life-cycles are managed through the supplied lifecycle policy.
 flat_mutation_reader make_multishard_combining_reader(
@@ -491,7 +541,8 @@ flat_mutation_reader make_multishard_combining_reader(
         const query::partition_slice& ps,
         const io_priority_class& pc,
         tracing::trace_state_ptr trace_state = nullptr,
-        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no);
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::no,
+        multishard_reader_concurrency concurrency = {});
 
 class queue_reader;
 
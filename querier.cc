@@ -183,19 +183,35 @@ static can_use can_be_used_for_page(const Querier& q, const schema& s, const dht
 // The time-to-live of a cache-entry.
 const std::chrono::seconds querier_cache::default_entry_ttl{10};
 
+static bool is_range_scan(dht::partition_ranges_view ranges) {
+    return ranges.size() > 1 || !ranges.front().is_singular();
+}
+
 void querier_cache::scan_cache_entries() {
     const auto now = lowres_clock::now();
 
+    // Range scans may expire later than entries inserted after them, so
+    // entries are not ordered by expiry.
     auto it = _entries.begin();
     const auto end = _entries.end();
-    while (it != end && it->is_expired(now)) {
+    while (it != end) {
+        if (!it->is_expired(now)) {
+            ++it;
+            continue;
+        }
         ++_stats.time_based_evictions;
         --_stats.population;
+        _stats.memory_usage -= it->memory_usage();
         _sem.unregister_inactive_read(std::move(*it).get_inactive_handle());
         it = _entries.erase(it);
     }
 }
 
+lowres_clock::time_point querier_cache::expiry_of(dht::partition_ranges_view ranges) const {
+    const auto ttl = is_range_scan(ranges) ? std::max(_entry_ttl, _range_scan_entry_ttl) : _entry_ttl;
+    return lowres_clock::now() + ttl;
+}
+
 static querier_cache::entries::iterator find_querier(querier_cache::entries& entries, querier_cache::index& index, utils::UUID key,
         dht::partition_ranges_view ranges, tracing::trace_state_ptr trace_state) {
     const auto queriers = index.equal_range(key);
@@ -237,12 +253,35 @@ class querier_inactive_read : public reader_concurrency_semaphore::inactive_read
         , _stats(stats) {
     }
     virtual void evict() override {
+        _stats.memory_usage -= _pos->memory_usage();
         _entries.erase(_pos);
         ++_stats.resource_based_evictions;
         --_stats.population;
     }
 };
 
+template <emit_only_live_rows OnlyLive>
+static void maybe_read_ahead(querier<OnlyLive>& q, reader_concurrency_semaphore& sem, seastar::gate& gate, size_t size,
+        lowres_clock::time_point expires, querier_cache::stats& stats) {
+    if (!q.is_range_scan() || size <= q.memory_usage()) {
+        return;
+    }
+    try {
+        q.read_ahead(gate, sem, size, expires);
+    } catch (const seastar::gate_closed_exception&) {
+        return;
+    }
+    if (q.is_reading_ahead()) {
+        ++stats.read_aheads;
+    }
+}
+
+// The reader of a shard_mutation_querier is a part of a multishard reader,
+// which reads ahead on its own.
+static void maybe_read_ahead(shard_mutation_querier&, reader_concurrency_semaphore&, seastar::gate&, size_t, lowres_clock::time_point,
+        querier_cache::stats&) {
+}
+
 template <typename Querier>
 static void insert_querier(
         reader_concurrency_semaphore& sem,
@@ -250,6 +289,8 @@ static void insert_querier(
         querier_cache::index& index,
         querier_cache::stats& stats,
         size_t max_queriers_memory_usage,
+        size_t read_ahead_size,
+        seastar::gate& read_ahead_gate,
         utils::UUID key,
         Querier&& q,
         lowres_clock::time_point expires,
@@ -266,7 +307,7 @@ static void insert_querier(
 
     tracing::trace(trace_state, "Caching querier with key {}", key);
 
-    auto memory_usage = boost::accumulate(entries | boost::adaptors::transformed(std::mem_fn(&querier_cache::entry::memory_usage)), size_t(0));
+    size_t memory_usage = stats.memory_usage;
 
     // We add the memory-usage of the to-be added querier to the memory-usage
     // of all the cached queriers. We now need to makes sure this number is
@@ -279,6 +320,7 @@ static void insert_querier(
         auto it = entries.begin();
         while (it != entries.end() && memory_usage >= max_queriers_memory_usage) {
             memory_usage -= it->memory_usage();
+            stats.memory_usage -= it->memory_usage();
             sem.unregister_inactive_read(std::move(*it).get_inactive_handle());
             it = entries.erase(it);
             --stats.population;
@@ -286,9 +328,17 @@ static void insert_querier(
         }
     }
 
+    // Read ahead only into memory which is left, it is not worth evicting
+    // other queriers for.
+    if (memory_usage < max_queriers_memory_usage) {
+        const auto headroom = max_queriers_memory_usage - memory_usage + q.memory_usage();
+        maybe_read_ahead(q, sem, read_ahead_gate, std::min(read_ahead_size, headroom), expires, stats);
+    }
+
     auto& e = entries.emplace_back(key, std::move(q), expires);
     e.set_pos(--entries.end());
     ++stats.population;
+    stats.memory_usage += e.memory_usage();
 
     if (auto irh = sem.register_inactive_read(std::make_unique<querier_inactive_read>(entries, e.pos(), stats))) {
         e.set_inactive_handle(std::move(irh));
@@ -297,18 +347,21 @@ static void insert_querier(
 }
 
 void querier_cache::insert(utils::UUID key, data_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(_sem, _entries, _data_querier_index, _stats, _max_queriers_memory_usage, key, std::move(q), lowres_clock::now() + _entry_ttl,
-            std::move(trace_state));
+    const auto expires = expiry_of(q.ranges());
+    insert_querier(_sem, _entries, _data_querier_index, _stats, _max_queriers_memory_usage, _read_ahead_size, _read_ahead_gate, key, std::move(q),
+            expires, std::move(trace_state));
 }
 
 void querier_cache::insert(utils::UUID key, mutation_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(_sem, _entries, _mutation_querier_index, _stats, _max_queriers_memory_usage, key, std::move(q), lowres_clock::now() + _entry_ttl,
-            std::move(trace_state));
+    const auto expires = expiry_of(q.ranges());
+    insert_querier(_sem, _entries, _mutation_querier_index, _stats, _max_queriers_memory_usage, _read_ahead_size, _read_ahead_gate, key, std::move(q),
+            expires, std::move(trace_state));
 }
 
 void querier_cache::insert(utils::UUID key, shard_mutation_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(_sem, _entries, _shard_mutation_querier_index, _stats, _max_queriers_memory_usage, key, std::move(q), lowres_clock::now() + _entry_ttl,
-            std::move(trace_state));
+    const auto expires = expiry_of(q.ranges());
+    insert_querier(_sem, _entries, _shard_mutation_querier_index, _stats, _max_queriers_memory_usage, _read_ahead_size, _read_ahead_gate, key, std::move(q),
+            expires, std::move(trace_state));
 }
 
 template <typename Querier>
@@ -331,6 +384,7 @@ static std::optional<Querier> lookup_querier(
 
     auto q = std::move(*it).template value<Querier>();
     sem.unregister_inactive_read(std::move(*it).get_inactive_handle());
+    stats.memory_usage -= it->memory_usage();
     entries.erase(it);
     --stats.population;
 
@@ -375,6 +429,25 @@ void querier_cache::set_entry_ttl(std::chrono::seconds entry_ttl) {
     _expiry_timer.rearm(lowres_clock::now() + _entry_ttl / 2, _entry_ttl / 2);
 }
 
+void querier_cache::set_range_scan_entry_ttl(std::chrono::seconds entry_ttl) {
+    _range_scan_entry_ttl = entry_ttl;
+}
+
+void querier_cache::set_read_ahead_size(size_t size) {
+    _read_ahead_size = size;
+}
+
+future<> querier_cache::stop() {
+    _expiry_timer.cancel();
+    for (auto& e : _entries) {
+        _sem.unregister_inactive_read(std::move(e).get_inactive_handle());
+    }
+    _entries.clear();
+    _stats.population = 0;
+    _stats.memory_usage = 0;
+    return _read_ahead_gate.close();
+}
+
 bool querier_cache::evict_one() {
     if (_entries.empty()) {
         return false;
@@ -382,6 +455,7 @@ bool querier_cache::evict_one() {
 
     ++_stats.resource_based_evictions;
     --_stats.population;
+    _stats.memory_usage -= _entries.front().memory_usage();
     _sem.unregister_inactive_read(std::move(_entries.front()).get_inactive_handle());
     _entries.pop_front();
 
@@ -394,6 +468,7 @@ void querier_cache::evict_all_for_table(const utils::UUID& schema_id) {
     while (it != end) {
         if (it->schema().id() == schema_id) {
             --_stats.population;
+            _stats.memory_usage -= it->memory_usage();
             _sem.unregister_inactive_read(std::move(*it).get_inactive_handle());
             it = _entries.erase(it);
         } else {
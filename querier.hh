@@ -25,6 +25,7 @@
 #include "mutation_reader.hh"
 
 #include <boost/intrusive/set.hpp>
+#include <seastar/core/gate.hh>
 
 #include <variant>
 
@@ -144,6 +145,51 @@ class querier {
     flat_mutation_reader _reader;
     lw_shared_ptr<compact_for_query_state<OnlyLive>> _compaction_state;
     std::optional<clustering_key_prefix> _last_ckey;
+    // State shared between the querier and its read-ahead. The querier may
+    // be moved while the read-ahead is running, so the read-ahead reaches
+    // the reader through here.
+    struct read_ahead_state {
+        flat_mutation_reader* reader;
+        // The memory of the read-ahead, taken from the semaphore when it
+        // starts, so admission sees it.
+        reader_permit permit;
+        size_t saved_max_buffer_size;
+        bool aborted = false;
+
+        read_ahead_state(flat_mutation_reader& rd, reader_permit permit)
+            : reader(&rd)
+            , permit(std::move(permit))
+            , saved_max_buffer_size(rd.max_buffer_size()) {
+        }
+    };
+
+    // The buffer is filled in steps of this size, so an aborted read-ahead
+    // stops after the current step.
+    static constexpr size_t read_ahead_step = 128 * 1024;
+
+    // The fill of the reader's buffer started by read_ahead(), if it wasn't
+    // waited for yet.
+    std::optional<future<>> _read_ahead;
+    lw_shared_ptr<read_ahead_state> _read_ahead_state;
+    seastar::gate* _read_ahead_gate = nullptr;
+    size_t _read_ahead_size = 0;
+
+    future<> wait_for_read_ahead() {
+        if (!_read_ahead) {
+            return make_ready_future<>();
+        }
+        auto f = std::move(*_read_ahead);
+        _read_ahead.reset();
+        return f.finally([this, gate = std::exchange(_read_ahead_gate, nullptr)] {
+            auto state = std::exchange(_read_ahead_state, {});
+            _reader.set_max_buffer_size(state->saved_max_buffer_size);
+            _read_ahead_size = 0;
+            // The read-ahead buffer is consumed by the page now waiting for
+            // it, which is accounted for on its own.
+            state->permit.release();
+            gate->leave();
+        });
+    }
 
 public:
     querier(const mutation_source& ms,
@@ -160,10 +206,99 @@ class querier {
         , _compaction_state(make_lw_shared<compact_for_query_state<OnlyLive>>(*schema, gc_clock::time_point{}, *_slice, 0, 0)) {
     }
 
+    querier(querier&& o) noexcept
+        : _schema(std::move(o._schema))
+        , _range(std::move(o._range))
+        , _slice(std::move(o._slice))
+        , _reader(std::move(o._reader))
+        , _compaction_state(std::move(o._compaction_state))
+        , _last_ckey(std::move(o._last_ckey))
+        , _read_ahead(std::exchange(o._read_ahead, std::nullopt))
+        , _read_ahead_state(std::move(o._read_ahead_state))
+        , _read_ahead_gate(std::exchange(o._read_ahead_gate, nullptr))
+        , _read_ahead_size(o._read_ahead_size) {
+        if (_read_ahead_state) {
+            _read_ahead_state->reader = &_reader;
+        }
+    }
+
+    querier& operator=(querier&& o) noexcept {
+        if (this != &o) {
+            this->~querier();
+            new (this) querier(std::move(o));
+        }
+        return *this;
+    }
+
+    ~querier() {
+        if (_read_ahead) {
+            // Stop the read-ahead after its current step and give its memory
+            // back to the semaphore right away, the querier is most likely
+            // destroyed because it was evicted to make room for other reads.
+            // The reader is moved out below, so the read-ahead mustn't reach
+            // it through the state anymore.
+            _read_ahead_state->aborted = true;
+            _read_ahead_state->reader = nullptr;
+            _read_ahead_state->permit.release();
+            // The reader, and the range and slice it reads, have to outlive
+            // the read-ahead.
+            (void)_read_ahead->then_wrapped([reader = std::move(_reader), range = std::move(_range), slice = std::move(_slice),
+                    gate = _read_ahead_gate] (future<> f) mutable {
+                f.ignore_ready_future();
+                {
+                    auto rd = std::move(reader);
+                }
+                gate->leave();
+            });
+        }
+    }
+
     bool is_reversed() const {
         return _slice->options.contains(query::partition_slice::option::reversed);
     }
 
+    bool is_range_scan() const {
+        return !_range->is_singular();
+    }
+
+    /// Fills the reader's buffer with up to `size` bytes in the background.
+    ///
+    /// The memory is taken from `sem` up front. The read-ahead is optional,
+    /// so it is not started when that would make other reads wait.
+    /// The next consume_page() waits for the read-ahead to complete. `gate`
+    /// is held until then or, if the querier is destroyed before, until the
+    /// read-ahead stops.
+    void read_ahead(seastar::gate& gate, reader_concurrency_semaphore& sem, size_t size, db::timeout_clock::time_point timeout) {
+        if (_read_ahead || _reader.is_end_of_stream() || _reader.buffer_size() >= size) {
+            return;
+        }
+        const auto resources = reader_resources(0, ssize_t(size - _reader.buffer_size()));
+        if (sem.waiters() || !(sem.available_resources() >= resources)) {
+            return;
+        }
+        gate.enter();
+        _read_ahead_gate = &gate;
+        _read_ahead_size = size;
+        _read_ahead_state = make_lw_shared<read_ahead_state>(_reader, sem.consume_resources(resources));
+        _read_ahead = repeat([state = _read_ahead_state, size, timeout] {
+            if (state->aborted) {
+                return make_ready_future<stop_iteration>(stop_iteration::yes);
+            }
+            auto& rd = *state->reader;
+            if (rd.is_end_of_stream() || rd.buffer_size() >= size) {
+                return make_ready_future<stop_iteration>(stop_iteration::yes);
+            }
+            rd.set_max_buffer_size(std::min(size, rd.buffer_size() + read_ahead_step));
+            return rd.fill_buffer(timeout).then([] {
+                return stop_iteration::no;
+            });
+        });
+    }
+
+    bool is_reading_ahead() const {
+        return bool(_read_ahead);
+    }
+
     bool are_limits_reached() const {
         return  _compaction_state->are_limits_reached();
     }
@@ -177,8 +312,10 @@ class querier {
             uint32_t partition_limit,
             gc_clock::time_point query_time,
             db::timeout_clock::time_point timeout) {
-        return ::query::consume_page(_reader, _compaction_state, *_slice, std::move(consumer), row_limit, partition_limit, query_time,
-                timeout).then([this] (auto&& results) {
+        return wait_for_read_ahead().then([this, consumer = std::move(consumer), row_limit, partition_limit, query_time, timeout] () mutable {
+            return ::query::consume_page(_reader, _compaction_state, *_slice, std::move(consumer), row_limit, partition_limit, query_time,
+                    timeout);
+        }).then([this] (auto&& results) {
             _last_ckey = std::get<std::optional<clustering_key>>(std::move(results));
             constexpr auto size = std::tuple_size<std::decay_t<decltype(results)>>::value;
             static_assert(size <= 2);
@@ -191,8 +328,9 @@ class querier {
         });
     }
 
+    // Includes the memory the read-ahead may use.
     size_t memory_usage() const {
-        return _reader.buffer_size();
+        return std::max(_reader.buffer_size(), _read_ahead_size);
     }
 
     schema_ptr schema() const {
@@ -296,6 +434,12 @@ class shard_mutation_querier {
 ///     that is before the end position of the previous page. lookup() will
 ///     recognize these cases and drop the previous querier and create a new one.
 ///
+/// Range scans can be kept longer than other queriers, see
+/// set_range_scan_entry_ttl(), and can read ahead: after they are inserted
+/// they fill their buffer in the background up to the read-ahead size, as
+/// far as the memory limit allows, so that the next page starts with data
+/// which is already read.
+///
 /// Inserted queriers will have a TTL. When this expires the querier is
 /// evicted. This is to avoid excess and unnecessary resource usage due to
 /// abandoned queriers.
@@ -328,6 +472,11 @@ class querier_cache {
         uint64_t memory_based_evictions = 0;
         // The number of queriers currently in the cache.
         uint64_t population = 0;
+        // The memory used by the queriers currently in the cache, as of their
+        // insertion.
+        uint64_t memory_usage = 0;
+        // The number of inserted queriers which started reading ahead.
+        uint64_t read_aheads = 0;
     };
 
     class entry : public boost::intrusive::set_base_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>> {
@@ -335,6 +484,7 @@ class querier_cache {
         std::list<entry>::iterator _pos;
         const utils::UUID _key;
         const lowres_clock::time_point _expires;
+        const size_t _memory_usage;
         std::variant<data_querier, mutation_querier, shard_mutation_querier> _value;
         reader_concurrency_semaphore::inactive_read_handle _handle;
 
@@ -343,6 +493,7 @@ class querier_cache {
         entry(utils::UUID key, Querier q, lowres_clock::time_point expires)
             : _key(key)
             , _expires(expires)
+            , _memory_usage(q.memory_usage())
             , _value(std::move(q)) {
         }
 
@@ -383,9 +534,7 @@ class querier_cache {
         }
 
         size_t memory_usage() const {
-            return std::visit([] (auto& q) {
-                return q.memory_usage();
-            }, _value);
+            return _memory_usage;
         }
 
         template <typename Querier>
@@ -416,10 +565,14 @@ class querier_cache {
     index _shard_mutation_querier_index;
     timer<lowres_clock> _expiry_timer;
     std::chrono::seconds _entry_ttl;
+    std::chrono::seconds _range_scan_entry_ttl{0};
     stats _stats;
     size_t _max_queriers_memory_usage;
+    size_t _read_ahead_size = 0;
+    seastar::gate _read_ahead_gate;
 
     void scan_cache_entries();
+    lowres_clock::time_point expiry_of(dht::partition_ranges_view ranges) const;
 
 public:
     explicit querier_cache(reader_concurrency_semaphore& sem, size_t max_cache_size = 1'000'000, std::chrono::seconds entry_ttl = default_entry_ttl);
@@ -476,6 +629,21 @@ class querier_cache {
 
     void set_entry_ttl(std::chrono::seconds entry_ttl);
 
+    /// Keep queriers of range scans for at least `entry_ttl`, if more than
+    /// the TTL of other queriers.
+    ///
+    /// Pages of range scans are usually requested back-to-back, so their
+    /// queriers are evicted by the memory limit or when the semaphore needs
+    /// resources before they would expire.
+    void set_range_scan_entry_ttl(std::chrono::seconds entry_ttl);
+
+    /// Make queriers of range scans read up to `size` bytes of the next page
+    /// in the background after they are inserted. 0 disables read-ahead.
+    void set_read_ahead_size(size_t size);
+
+    /// Evict all queriers and wait for their read-aheads to complete.
+    future<> stop();
+
     /// Evict a querier.
     ///
     /// Return true if a querier was evicted and false otherwise (if the cache
@@ -500,6 +668,10 @@ class querier_cache_context {
 public:
     querier_cache_context() = default;
     querier_cache_context(querier_cache& cache, utils::UUID key, bool is_first_page);
+    // Returns true if lookups may find a querier saved by the previous page.
+    bool may_have_querier() const {
+        return _cache && _key != utils::UUID{} && !_is_first_page;
+    }
     void insert(data_querier&& q, tracing::trace_state_ptr trace_state);
     void insert(mutation_querier&& q, tracing::trace_state_ptr trace_state);
     void insert(shard_mutation_querier&& q, tracing::trace_state_ptr trace_state);
@@ -139,6 +139,10 @@ class partition_slice {
         // key restrictions and the partition doesn't have any rows matching
         // the restrictions, see #589. This flag overrides this behavior.
         always_return_static_content,
+        // Set by the replica on the slice of reads which only feed a data
+        // query (query::result). Such reads only need the liveness of cells
+        // of unselected columns, not their values. Never sent to other nodes.
+        skip_unselected_values,
     };
     using option_set = enum_set<super_enum<option,
         option::send_clustering_key,
@@ -152,7 +156,8 @@ class partition_slice {
         option::allow_short_read,
         option::with_digest,
         option::bypass_cache,
-        option::always_return_static_content>>;
+        option::always_return_static_content,
+        option::skip_unselected_values>>;
     clustering_row_ranges _row_ranges;
 public:
     column_id_vector static_columns; // TODO: consider using bitmap
@@ -258,4 +263,16 @@ class read_command {
     friend std::ostream& operator<<(std::ostream& out, const read_command& r);
 };
 
+// An aggregate function applied to columns of the queried table, whose
+// partial results are computed by the replicas over the rows they own.
+// See storage_proxy::query_partial_aggregates().
+// The function is identified by name and argument types, so that each
+// node can look it up.
+struct partial_aggregate {
+    sstring function_keyspace;
+    sstring function_name;
+    std::vector<sstring> argument_types; // Names of the argument types, see abstract_type::name().
+    std::vector<bytes> argument_columns; // Names of the argument columns.
+};
+
 }
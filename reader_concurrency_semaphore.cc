@@ -31,17 +31,37 @@ reader_permit::impl::impl(reader_concurrency_semaphore& semaphore, reader_resour
 }
 
 reader_permit::impl::~impl() {
+    // Memory units keep the permit alive, so there is no tracked memory left.
     semaphore.signal(base_cost);
 }
 
-reader_permit::memory_units::memory_units(reader_concurrency_semaphore* semaphore, ssize_t memory) : _semaphore(semaphore), _memory(memory) {
-    if (_semaphore && _memory) {
-        _semaphore->consume_memory(_memory);
+size_t reader_permit::impl::memory_above_base_cost() const {
+    const auto base_memory = size_t(std::max(base_cost.memory, ssize_t(0)));
+    return tracked_memory > base_memory ? tracked_memory - base_memory : 0;
+}
+
+void reader_permit::impl::consume_memory(size_t memory) {
+    const auto before = memory_above_base_cost();
+    tracked_memory += memory;
+    semaphore.consume_memory(memory_above_base_cost() - before);
+}
+
+void reader_permit::impl::signal_memory(size_t memory) {
+    const auto before = memory_above_base_cost();
+    tracked_memory -= memory;
+    if (const auto released = before - memory_above_base_cost()) {
+        semaphore.signal_memory(released);
+    }
+}
+
+reader_permit::memory_units::memory_units(lw_shared_ptr<impl> permit, ssize_t memory) : _permit(std::move(permit)), _memory(memory) {
+    if (_permit && _memory) {
+        _permit->consume_memory(_memory);
     }
 }
 
 reader_permit::memory_units::memory_units(memory_units&& o)
-    : _semaphore(std::exchange(o._semaphore, nullptr))
+    : _permit(std::move(o._permit))
     , _memory(std::exchange(o._memory, 0)) {
 }
 
@@ -51,14 +71,14 @@ reader_permit::memory_units::~memory_units() {
 
 reader_permit::memory_units& reader_permit::memory_units::operator=(memory_units&& o) {
     reset();
-    _semaphore = std::exchange(o._semaphore, nullptr);
+    _permit = std::move(o._permit);
     _memory = std::exchange(o._memory, 0);
     return *this;
 }
 
 void reader_permit::memory_units::increase(size_t memory) {
-    if (_semaphore) {
-        _semaphore->consume_memory(memory);
+    if (_permit) {
+        _permit->consume_memory(memory);
     }
     _memory += memory;
 }
@@ -67,16 +87,16 @@ void reader_permit::memory_units::decrease(size_t memory) {
     if (memory > _memory) {
         on_internal_error(rcslog, "reader_permit::memory_units::decrease(): memory underflow");
     }
-    if (_semaphore) {
-        _semaphore->signal_memory(memory);
+    if (_permit) {
+        _permit->signal_memory(memory);
     }
     _memory -= memory;
 }
 
 void reader_permit::memory_units::reset(size_t memory) {
-    if (_semaphore) {
-        _semaphore->signal_memory(_memory);
-        _semaphore->consume_memory(memory);
+    if (_permit) {
+        _permit->signal_memory(_memory);
+        _permit->consume_memory(memory);
     }
     _memory = memory;
 }
@@ -86,10 +106,14 @@ reader_permit::reader_permit(reader_concurrency_semaphore& semaphore, reader_res
 }
 
 reader_permit::memory_units reader_permit::get_memory_units(size_t memory) {
-    return memory_units(_impl ? &_impl->semaphore : nullptr, memory);
+    return memory_units(_impl, memory);
 }
 
 void reader_permit::release() {
+    // Tracked memory covered by the base cost has to be taken from the
+    // semaphore now.
+    const auto covered = std::min(_impl->tracked_memory, size_t(std::max(_impl->base_cost.memory, ssize_t(0))));
+    _impl->semaphore.consume_memory(covered);
     _impl->semaphore.signal(_impl->base_cost);
     _impl->base_cost = {};
 }
@@ -108,6 +108,7 @@ class reader_concurrency_semaphore {
     };
 
 private:
+    const resources _initial_resources;
     resources _resources;
 
     expiring_fifo<entry, expiry_handler, db::timeout_clock> _wait_list;
@@ -145,7 +146,8 @@ class reader_concurrency_semaphore {
             sstring name,
             size_t max_queue_length = std::numeric_limits<size_t>::max(),
             std::function<void()> prethrow_action = nullptr)
-        : _resources(count, memory)
+        : _initial_resources(count, memory)
+        , _resources(count, memory)
         , _wait_list(expiry_handler(name))
         , _name(std::move(name))
         , _max_queue_length(max_queue_length)
@@ -199,11 +201,20 @@ class reader_concurrency_semaphore {
         return _inactive_read_stats;
     }
 
+    /// Wait until there are enough resources for a new read.
+    ///
+    /// \param memory the memory the read is expected to consume. Memory
+    ///     tracked through the permit is accounted against it, the read
+    ///     only takes more from the semaphore once it exceeds the estimate.
     future<reader_permit> wait_admission(size_t memory, db::timeout_clock::time_point timeout = db::no_timeout);
 
     /// Consume the specific amount of resources without waiting.
     reader_permit consume_resources(resources r);
 
+    const resources initial_resources() const {
+        return _initial_resources;
+    }
+
     const resources available_resources() const {
         return _resources;
     }
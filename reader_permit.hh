@@ -60,24 +60,35 @@ struct reader_resources {
 class reader_concurrency_semaphore;
 
 class reader_permit {
+    // The memory of the base cost is an estimate of what the read will
+    // consume, taken from the semaphore on admission. Tracked memory
+    // (see memory_units) is first accounted against the estimate and only
+    // the part exceeding it is taken from the semaphore, so the read holds
+    // max(estimate, tracked memory) in total.
     struct impl {
         reader_concurrency_semaphore& semaphore;
         reader_resources base_cost;
+        size_t tracked_memory = 0;
 
         impl(reader_concurrency_semaphore& semaphore, reader_resources base_cost);
         ~impl();
+
+        void consume_memory(size_t memory);
+        void signal_memory(size_t memory);
+    private:
+        size_t memory_above_base_cost() const;
     };
 
     friend reader_permit no_reader_permit();
 
 public:
     class memory_units {
-        reader_concurrency_semaphore* _semaphore = nullptr;
+        lw_shared_ptr<impl> _permit;
         size_t _memory = 0;
 
         friend class reader_permit;
     private:
-        memory_units(reader_concurrency_semaphore* semaphore, ssize_t memory);
+        memory_units(lw_shared_ptr<impl> permit, ssize_t memory);
     public:
         memory_units(const memory_units&) = delete;
         memory_units(memory_units&&);
@@ -125,6 +125,7 @@ cache_tracker::setup_metrics() {
         sm::make_gauge("rows", sm::description("total number of cached rows"), _stats.rows),
         sm::make_derive("reads", sm::description("number of started reads"), _stats.reads),
         sm::make_derive("reads_with_misses", sm::description("number of reads which had to read from sstables"), _stats.reads_with_misses),
+        sm::make_derive("reads_without_reader", sm::description("number of single-partition reads served from a cached partition without creating a reader"), _stats.reads_without_reader),
         sm::make_gauge("active_reads", sm::description("number of currently active reads"), [this] { return _stats.active_reads(); }),
         sm::make_derive("sstable_reader_recreations", sm::description("number of times sstable reader was recreated due to memtable flush"), _stats.underlying_recreations),
         sm::make_derive("sstable_partition_skips", sm::description("number of times sstable reader was fast forwarded across partitions"), _stats.underlying_partition_skips),
@@ -377,11 +378,12 @@ class single_partition_populating_reader final : public flat_mutation_reader::im
                             dht::decorated_key dk = _read_context->range().start()->value().as_decorated_key();
                             _cache.do_find_or_create_entry(dk, nullptr, [&] (auto i) {
                                 mutation_partition mp(_cache._schema);
-                                cache_entry* entry = current_allocator().construct<cache_entry>(
-                                    _cache._schema, std::move(dk), std::move(mp));
-                                _cache._tracker.insert(*entry);
+                                auto entry = alloc_strategy_unique_ptr<cache_entry>(current_allocator().construct<cache_entry>(
+                                    _cache._schema, std::move(dk), std::move(mp)));
                                 entry->set_continuous(i->continuous());
-                                return _cache._partitions.insert_before(i, *entry);
+                                i = _cache._partitions.insert_before(i, *entry, cache_entry::compare(_cache._schema));
+                                _cache._tracker.insert(*entry.release());
+                                return i;
                             }, [&] (auto i) {
                                 _cache._tracker.on_miss_already_populated();
                             });
@@ -778,6 +780,72 @@ row_cache::make_reader(schema_ptr s,
     }
 }
 
+mutation_opt
+row_cache::read_if_continuous(const schema_ptr& s, const dht::decorated_key& dk, const query::partition_slice& slice, size_t max_rows) {
+    bool partition_hit = false;
+    uint32_t rows_hit = 0;
+    auto m = _read_section(_tracker.region(), [&] {
+        return with_linearized_managed_bytes([&] () -> mutation_opt {
+            partition_hit = false;
+            rows_hit = 0;
+            cache_entry::compare cmp(_schema);
+            auto i = _partitions.lower_bound(dk, cmp);
+            if (i == _partitions.end() || cmp(dk, *i)) {
+                if (i != _partitions.end() && i->continuous()) {
+                    return mutation(s, dk);
+                }
+                return { };
+            }
+            cache_entry& e = *i;
+            upgrade_entry(e);
+            partition_entry& pe = e.partition();
+            // The rows are copied from the latest version, which is complete
+            // only when it is the only one.
+            if (e.schema()->version() != s->version() || pe.is_locked() || pe.version()->next()) {
+                return { };
+            }
+            mutation_partition& mp = pe.version()->partition();
+            if (s->has_static_columns() && !mp.static_row_continuous()) {
+                return { };
+            }
+            auto ck_ranges = query::clustering_key_filter_ranges::get_ranges(*s, slice, dk.key());
+            size_t rows = 0;
+            for (auto&& range : ck_ranges) {
+                if (!mp.fully_continuous(*s, position_range::from_range(range))) {
+                    return { };
+                }
+                for (rows_entry& re : mp.range(*s, range)) {
+                    if (++rows > max_rows) {
+                        return { };
+                    }
+                    if (!re.dummy()) {
+                        ++rows_hit;
+                    }
+                }
+            }
+            for (auto&& range : ck_ranges) {
+                for (rows_entry& re : mp.range(*s, range)) {
+                    _tracker.touch(re);
+                }
+            }
+            partition_hit = true;
+            return mutation(s, dk, mutation_partition(mp, *s, std::move(ck_ranges)));
+        });
+    });
+    if (m) {
+        ++_tracker._stats.reads;
+        ++_tracker._stats.reads_done;
+        ++_tracker._stats.reads_without_reader;
+        _stats.reads_with_no_misses.mark();
+        if (partition_hit) {
+            on_partition_hit();
+        }
+        for (uint32_t i = 0; i < rows_hit; ++i) {
+            on_row_hit();
+        }
+    }
+    return m;
+}
 
 row_cache::~row_cache() {
     with_allocator(_tracker.allocator(), [this] {
@@ -838,9 +906,11 @@ cache_entry& row_cache::do_find_or_create_entry(const dht::decorated_key& key,
 
 cache_entry& row_cache::find_or_create(const dht::decorated_key& key, tombstone t, row_cache::phase_type phase, const previous_entry_pointer* previous) {
     return do_find_or_create_entry(key, previous, [&] (auto i) { // create
-        auto entry = current_allocator().construct<cache_entry>(cache_entry::incomplete_tag{}, _schema, key, t);
-        _tracker.insert(*entry);
-        return _partitions.insert_before(i, *entry);
+        auto entry = alloc_strategy_unique_ptr<cache_entry>(current_allocator().construct<cache_entry>(
+            cache_entry::incomplete_tag{}, _schema, key, t));
+        i = _partitions.insert_before(i, *entry, cache_entry::compare(_schema));
+        _tracker.insert(*entry.release());
+        return i;
     }, [&] (auto i) { // visit
         _tracker.on_miss_already_populated();
         cache_entry& e = *i;
@@ -852,11 +922,11 @@ cache_entry& row_cache::find_or_create(const dht::decorated_key& key, tombstone
 void row_cache::populate(const mutation& m, const previous_entry_pointer* previous) {
   _populate_section(_tracker.region(), [&] {
     do_find_or_create_entry(m.decorated_key(), previous, [&] (auto i) {
-        cache_entry* entry = current_allocator().construct<cache_entry>(
-                m.schema(), m.decorated_key(), m.partition());
-        _tracker.insert(*entry);
+        auto entry = alloc_strategy_unique_ptr<cache_entry>(current_allocator().construct<cache_entry>(
+                m.schema(), m.decorated_key(), m.partition()));
         entry->set_continuous(i->continuous());
-        i = _partitions.insert_before(i, *entry);
+        i = _partitions.insert_before(i, *entry, cache_entry::compare(_schema));
+        _tracker.insert(*entry.release());
         upgrade_entry(*i);
         return i;
     }, [&] (auto i) {
@@ -1019,12 +1089,13 @@ future<> row_cache::update(external_updater eu, memtable& m) {
                    || with_allocator(standard_allocator(), [&] { return is_present(mem_e.key()); })
                       == partition_presence_checker_result::definitely_doesnt_exist) {
             // Partition is absent in underlying. First, insert a neutral partition entry.
-            cache_entry* entry = current_allocator().construct<cache_entry>(cache_entry::evictable_tag(),
+            auto entry_ptr = alloc_strategy_unique_ptr<cache_entry>(current_allocator().construct<cache_entry>(cache_entry::evictable_tag(),
                 _schema, dht::decorated_key(mem_e.key()),
-                partition_entry::make_evictable(*_schema, mutation_partition(_schema)));
-            entry->set_continuous(cache_i->continuous());
+                partition_entry::make_evictable(*_schema, mutation_partition(_schema))));
+            entry_ptr->set_continuous(cache_i->continuous());
+            _partitions.insert_before(cache_i, *entry_ptr, cache_entry::compare(_schema));
+            cache_entry* entry = entry_ptr.release();
             _tracker.insert(*entry);
-            _partitions.insert_before(cache_i, *entry);
             mem_e.upgrade_schema(_schema, _tracker.memtable_cleaner());
             return entry->partition().apply_to_incomplete(*_schema, std::move(mem_e.partition()), _tracker.memtable_cleaner(),
                 alloc, _tracker.region(), _tracker, _underlying_phase, acc);
@@ -1190,14 +1261,14 @@ void row_cache::invalidate_unwrapped(const dht::partition_range& range) {
 row_cache::row_cache(schema_ptr s, snapshot_source src, cache_tracker& tracker, is_continuous cont)
     : _tracker(tracker)
     , _schema(std::move(s))
-    , _partitions(cache_entry::compare(_schema))
     , _underlying(src())
     , _snapshot_source(std::move(src))
 {
     with_allocator(_tracker.allocator(), [this, cont] {
-        cache_entry* entry = current_allocator().construct<cache_entry>(cache_entry::dummy_entry_tag());
-        _partitions.insert_before(_partitions.end(), *entry);
+        auto entry = alloc_strategy_unique_ptr<cache_entry>(current_allocator().construct<cache_entry>(cache_entry::dummy_entry_tag()));
         entry->set_continuous(bool(cont));
+        _partitions.insert_before(_partitions.end(), *entry, cache_entry::compare(_schema));
+        entry.release();
     });
 }
 
@@ -1206,13 +1277,8 @@ cache_entry::cache_entry(cache_entry&& o) noexcept
     , _key(std::move(o._key))
     , _pe(std::move(o._pe))
     , _flags(o._flags)
-    , _cache_link()
+    , _cache_link(std::move(o._cache_link))
 {
-    {
-        using container_type = row_cache::partitions_type;
-        container_type::node_algorithms::replace_node(o._cache_link.this_ptr(), _cache_link.this_ptr());
-        container_type::node_algorithms::init(o._cache_link.this_ptr());
-    }
 }
 
 cache_entry::~cache_entry() {
@@ -1227,7 +1293,7 @@ void row_cache::set_schema(schema_ptr new_schema) noexcept {
 }
 
 void cache_entry::on_evicted(cache_tracker& tracker) noexcept {
-    auto it = row_cache::partitions_type::s_iterator_to(*this);
+    auto it = row_cache::partitions_type::iterator_to(*this);
     std::next(it)->set_continuous(false);
     evict(tracker);
     current_deleter<cache_entry>()(this);
@@ -1252,7 +1318,7 @@ void rows_entry::on_evicted(cache_tracker& tracker) noexcept {
     if (mutation_partition::rows_type::is_only_member(*it)) {
         assert(it->is_last_dummy());
         partition_version& pv = partition_version::container_of(mutation_partition::container_of(
-            mutation_partition::rows_type::container_of_only_member(*it)));
+            mutation_partition::rows_type::container_of(*it)));
         if (pv.is_referenced_from_entry()) {
             partition_entry& pe = partition_entry::container_of(pv);
             if (!pe.is_locked()) {
@@ -32,6 +32,7 @@
 #include "mutation_reader.hh"
 #include "mutation_partition.hh"
 #include "utils/logalloc.hh"
+#include "utils/bptree.hh"
 #include "utils/phased_barrier.hh"
 #include "utils/histogram.hh"
 #include "partition_version.hh"
@@ -61,10 +62,10 @@ class lsa_manager;
 //
 // TODO: Make memtables use this format too.
 class cache_entry {
-    // We need auto_unlink<> option on the _cache_link because when entry is
+    // The hook unlinks itself on destruction, because when entry is
     // evicted from cache via LRU we don't have a reference to the container
     // and don't want to store it with each entry.
-    using cache_link_type = bi::set_member_hook<bi::link_mode<bi::auto_unlink>>;
+    using cache_link_type = bplus::member_hook;
 
     schema_ptr _schema;
     dht::decorated_key _key;
@@ -178,6 +179,19 @@ class cache_entry {
         bool operator()(dht::ring_position_view k1, dht::ring_position_view k2) const {
             return _c(k1, k2);
         }
+
+        // See bplus::tree.
+        int64_t prefix(const cache_entry& e) const {
+            return dht::token_prefix(e.position().token());
+        }
+
+        int64_t prefix(const dht::decorated_key& k) const {
+            return dht::token_prefix(k.token());
+        }
+
+        int64_t prefix(dht::ring_position_view p) const {
+            return dht::token_prefix(p.token());
+        }
     };
 
     friend std::ostream& operator<<(std::ostream&, cache_entry&);
@@ -221,6 +235,7 @@ class cache_tracker final {
         uint64_t reads;
         uint64_t reads_with_misses;
         uint64_t reads_done;
+        uint64_t reads_without_reader;
         uint64_t pinned_dirty_memory_overload;
 
         uint64_t active_reads() const {
@@ -315,10 +330,7 @@ void cache_tracker::insert(partition_entry& pe) noexcept {
 class row_cache final {
 public:
     using phase_type = utils::phased_barrier::phase_type;
-    using partitions_type = bi::set<cache_entry,
-        bi::member_hook<cache_entry, cache_entry::cache_link_type, &cache_entry::_cache_link>,
-        bi::constant_time_size<false>, // we need this to have bi::auto_unlink on hooks
-        bi::compare<cache_entry::compare>>;
+    using partitions_type = bplus::tree<cache_entry, &cache_entry::_cache_link>;
     friend class cache::autoupdating_underlying_reader;
     friend class single_partition_populating_reader;
     friend class cache_entry;
@@ -503,6 +515,17 @@ class row_cache final {
         return make_reader(std::move(s), range, full_slice);
     }
 
+    // Reads the part of the partition which is selected by the slice without
+    // creating a reader, if the cache can provide it on its own, i.e. the entry
+    // is continuous in the static row and in all clustering ranges of the slice.
+    // A partition which cache knows to be absent is returned as an empty mutation.
+    //
+    // Returns a disengaged optional if the read has to go through make_reader():
+    // when the entry is incomplete, undergoing an update or has more than one
+    // version, or when the selected part has more than max_rows rows, as it is
+    // copied without preemption.
+    mutation_opt read_if_continuous(const schema_ptr&, const dht::decorated_key&, const query::partition_slice&, size_t max_rows);
+
     const stats& stats() const { return _stats; }
 public:
     // Populate cache from given mutation, which must be fully continuous.
@@ -201,6 +201,34 @@ void schema::rebuild() {
     _partition_key_type = make_lw_shared<compound_type<>>(get_column_types(partition_key_columns()));
     _clustering_key_type = make_lw_shared<compound_prefix>(get_column_types(clustering_key_columns()));
     _clustering_key_size = column_offset(column_kind::static_column) - column_offset(column_kind::clustering_key);
+    _clustering_prefix_kind = ::clustering_prefix_kind::none;
+    _clustering_prefix_reversed = false;
+    if (_clustering_key_size) {
+        auto type = clustering_key_columns().begin()->type->underlying_type();
+        _clustering_prefix_reversed = clustering_key_columns().begin()->type->is_reversed();
+        switch (type->get_kind()) {
+        case abstract_type::kind::int32:
+            _clustering_prefix_kind = ::clustering_prefix_kind::int32;
+            break;
+        case abstract_type::kind::long_kind:
+        case abstract_type::kind::timestamp:
+        case abstract_type::kind::time:
+            _clustering_prefix_kind = ::clustering_prefix_kind::int64;
+            break;
+        case abstract_type::kind::ascii:
+        case abstract_type::kind::utf8:
+        case abstract_type::kind::bytes:
+        case abstract_type::kind::inet:
+        case abstract_type::kind::date:
+            _clustering_prefix_kind = ::clustering_prefix_kind::byte_order;
+            break;
+        case abstract_type::kind::timeuuid:
+            _clustering_prefix_kind = ::clustering_prefix_kind::timeuuid;
+            break;
+        default:
+            break;
+        }
+    }
     _regular_column_count = _raw._columns.size() - column_offset(column_kind::regular_column);
     _static_column_count = column_offset(column_kind::regular_column) - column_offset(column_kind::static_column);
     _columns_by_name.clear();
@@ -567,6 +567,16 @@ class schema_extension {
     }
 };
 
+// Describes how a 64-bit integer consistent with the clustering order can be
+// computed from the first clustering key component, see rows_entry::tri_compare::prefix().
+enum class clustering_prefix_kind : uint8_t {
+    none,       // Not supported for the type, all prefixes are equal
+    int32,      // Big-endian signed 32-bit integer
+    int64,      // Big-endian signed 64-bit integer
+    byte_order, // Compared with compare_unsigned()
+    timeuuid,   // Ordered by the embedded timestamp first
+};
+
 /*
  * Effectively immutable.
  * Not safe to access across cores because of shared_ptr's.
@@ -648,6 +658,8 @@ class schema final : public enable_lw_shared_from_this<schema> {
     column_mapping _column_mapping;
     shared_ptr<query::partition_slice> _full_slice;
     column_count_type _clustering_key_size;
+    ::clustering_prefix_kind _clustering_prefix_kind = ::clustering_prefix_kind::none;
+    bool _clustering_prefix_reversed = false;
     column_count_type _regular_column_count;
     column_count_type _static_column_count;
 
@@ -831,6 +843,9 @@ class schema final : public enable_lw_shared_from_this<schema> {
     column_count_type columns_count(column_kind kind) const;
     column_count_type partition_key_size() const;
     column_count_type clustering_key_size() const { return _clustering_key_size; }
+    ::clustering_prefix_kind clustering_prefix_kind() const { return _clustering_prefix_kind; }
+    // True iff the first clustering column has a reversed type.
+    bool clustering_prefix_reversed() const { return _clustering_prefix_reversed; }
     column_count_type static_columns_count() const { return _static_column_count; }
     column_count_type regular_columns_count() const { return _regular_column_count; }
     column_count_type all_columns_count() const { return _raw._columns.size(); }
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/range/adaptor/transformed.hpp>
+
+#include "service/partial_aggregates.hh"
+#include "service/priority_manager.hh"
+#include "cql3/functions/functions.hh"
+#include "db/marshal/type_parser.hh"
+#include "mutation_compactor.hh"
+#include "querier.hh"
+#include "database.hh"
+
+namespace service {
+
+partial_aggregates::partial_aggregates(const schema& s, const std::vector<query::partial_aggregate>& aggregates,
+        cql_serialization_format sf)
+    : _sf(sf) {
+    _aggregates.reserve(aggregates.size());
+    for (auto&& a : aggregates) {
+        auto arg_types = boost::copy_range<std::vector<data_type>>(a.argument_types | boost::adaptors::transformed([] (const sstring& name) {
+            return db::marshal::type_parser::parse(name);
+        }));
+        auto name = cql3::functions::function_name(a.function_keyspace, a.function_name);
+        auto function = dynamic_pointer_cast<cql3::functions::aggregate_function>(cql3::functions::functions::find(name, arg_types));
+        if (!function) {
+            throw std::runtime_error(format("Unknown aggregate function {}", name));
+        }
+        aggregate agg;
+        agg.impl = function->new_aggregate();
+        agg.impl->reset();
+        for (auto&& column : a.argument_columns) {
+            auto def = s.get_column_definition(column);
+            if (!def) {
+                throw std::runtime_error(format("Unknown column {} of {}.{} in aggregate {}", utf8_type->to_string(column),
+                        s.ks_name(), s.cf_name(), name));
+            }
+            agg.arguments.push_back(def);
+        }
+        agg.values.resize(agg.arguments.size());
+        _aggregates.push_back(std::move(agg));
+    }
+}
+
+void partial_aggregates::merge(const std::vector<bytes_opt>& states) {
+    if (states.size() != _aggregates.size()) {
+        throw std::runtime_error(format("Expected {:d} aggregate states, got {:d}", _aggregates.size(), states.size()));
+    }
+    for (size_t i = 0; i < states.size(); ++i) {
+        _aggregates[i].impl->merge_state(_sf, states[i]);
+    }
+}
+
+std::vector<bytes_opt> partial_aggregates::get_states() {
+    return boost::copy_range<std::vector<bytes_opt>>(_aggregates | boost::adaptors::transformed([this] (aggregate& a) {
+        return a.impl->get_state(_sf);
+    }));
+}
+
+std::vector<bytes_opt> partial_aggregates::compute() {
+    return boost::copy_range<std::vector<bytes_opt>>(_aggregates | boost::adaptors::transformed([this] (aggregate& a) {
+        return a.impl->compute(_sf);
+    }));
+}
+
+namespace {
+
+// Feeds the live rows of a data query to partial aggregates, as
+// result_set_builder::visitor would build them from the query::result:
+// a partition without live rows contributes a row of its static columns,
+// unless the query restricts the clustering key.
+class partial_aggregates_builder {
+    const schema& _schema;
+    const query::partition_slice& _slice;
+    partial_aggregates& _aggregates;
+    std::vector<bytes> _partition_key;
+    std::optional<static_row> _static_row;
+    uint32_t _live_rows = 0;
+    bool _return_static_content_on_partition_with_no_rows = false;
+private:
+    static bytes_opt cell_value(const row& cells, const column_definition& def) {
+        auto cell = cells.find_cell(def.id);
+        if (!cell) {
+            return std::nullopt;
+        }
+        auto c = cell->as_atomic_cell(def);
+        if (!c.is_live()) {
+            return std::nullopt;
+        }
+        return c.value().linearize();
+    }
+    bytes_opt static_value(const column_definition& def) const {
+        return _static_row ? cell_value(_static_row->cells(), def) : std::nullopt;
+    }
+public:
+    partial_aggregates_builder(const schema& s, const query::partition_slice& slice, partial_aggregates& aggregates)
+        : _schema(s)
+        , _slice(slice)
+        , _aggregates(aggregates) {
+    }
+
+    void consume_new_partition(const dht::decorated_key& dk) {
+        _partition_key = dk.key().explode(_schema);
+        _static_row.reset();
+        _live_rows = 0;
+        _return_static_content_on_partition_with_no_rows =
+            _slice.options.contains(query::partition_slice::option::always_return_static_content) ||
+            !has_ck_selector(_slice.row_ranges(_schema, dk.key()));
+    }
+
+    void consume(tombstone) {
+    }
+
+    stop_iteration consume(static_row&& sr, tombstone, bool is_live) {
+        if (is_live) {
+            _static_row = std::move(sr);
+        }
+        return stop_iteration::no;
+    }
+
+    stop_iteration consume(clustering_row&& cr, row_tombstone, bool) {
+        ++_live_rows;
+        std::optional<std::vector<bytes>> clustering_key;
+        _aggregates.add_row([&] (const column_definition& def) -> bytes_opt {
+            switch (def.kind) {
+            case column_kind::partition_key:
+                return _partition_key[def.component_index()];
+            case column_kind::clustering_key:
+                if (!clustering_key) {
+                    clustering_key = cr.key().explode(_schema);
+                }
+                if (clustering_key->size() > def.component_index()) {
+                    return (*clustering_key)[def.component_index()];
+                }
+                return std::nullopt;
+            case column_kind::static_column:
+                return static_value(def);
+            case column_kind::regular_column:
+                return cell_value(cr.cells(), def);
+            default:
+                assert(0);
+            }
+        });
+        return stop_iteration::no;
+    }
+
+    stop_iteration consume(range_tombstone&&) {
+        return stop_iteration::no;
+    }
+
+    stop_iteration consume_end_of_partition() {
+        if (!_live_rows && _static_row && _return_static_content_on_partition_with_no_rows) {
+            _aggregates.add_row([&] (const column_definition& def) -> bytes_opt {
+                if (def.is_partition_key()) {
+                    return _partition_key[def.component_index()];
+                } else if (def.is_static()) {
+                    return static_value(def);
+                }
+                return std::nullopt;
+            });
+        }
+        return stop_iteration::no;
+    }
+
+    void consume_end_of_stream() {
+    }
+};
+
+}
+
+future<std::vector<bytes_opt>> query_partial_aggregates_on_shard(database& db, schema_ptr s, const query::read_command& cmd,
+        const dht::partition_range_vector& ranges, const std::vector<query::partial_aggregate>& aggregates,
+        tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout) {
+    auto& cf = db.find_column_family(cmd.cf_id);
+    auto aggs = partial_aggregates(*s, aggregates, cmd.slice.cql_format());
+    return do_with(std::move(aggs), std::move(s), std::move(trace_state), cf.read_in_progress(),
+            [&cf, &cmd, &ranges, timeout] (partial_aggregates& aggs, schema_ptr& s, tracing::trace_state_ptr& trace_state, utils::phased_barrier::operation&) {
+        return do_for_each(ranges, [&cf, &cmd, &aggs, &s, &trace_state, timeout] (const dht::partition_range& range) {
+            auto q = make_lw_shared<query::data_querier>(cf.as_mutation_source(), s, range, cmd.slice,
+                    get_local_sstable_query_read_priority(), trace_state);
+            return q->consume_page(partial_aggregates_builder(*s, cmd.slice, aggs), cmd.row_limit, cmd.partition_limit,
+                    cmd.timestamp, timeout).finally([q] { });
+        }).then([&aggs] {
+            return aggs.get_states();
+        });
+    });
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "query-request.hh"
+#include "cql3/functions/aggregate_function.hh"
+#include "db/timeout_clock.hh"
+#include "tracing/trace_state.hh"
+
+class database;
+
+namespace service {
+
+// The aggregates of a query which are computed piecewise: each replica
+// shard aggregates the rows it owns and the coordinator combines the
+// states of the shard aggregates into the final result.
+//
+// Aggregates are described by query::partial_aggregate, so that they can be
+// sent to other nodes. They can only be applied to atomic, non-counter
+// columns.
+class partial_aggregates {
+    struct aggregate {
+        std::unique_ptr<cql3::functions::aggregate_function::aggregate> impl;
+        std::vector<const column_definition*> arguments;
+        std::vector<bytes_opt> values;
+    };
+    cql_serialization_format _sf;
+    std::vector<aggregate> _aggregates;
+public:
+    partial_aggregates(const schema& s, const std::vector<query::partial_aggregate>& aggregates, cql_serialization_format sf);
+
+    size_t size() const {
+        return _aggregates.size();
+    }
+
+    // Adds a row to all aggregates. value_of(const column_definition&)
+    // returns the value of a column in the row.
+    template <typename ValueOf>
+    void add_row(ValueOf&& value_of) {
+        for (auto& a : _aggregates) {
+            for (size_t i = 0; i < a.arguments.size(); ++i) {
+                a.values[i] = value_of(*a.arguments[i]);
+            }
+            a.impl->add_input(_sf, a.values);
+        }
+    }
+
+    // Combines the states returned by get_states() of other partial
+    // aggregates of the same query with the state of this one.
+    void merge(const std::vector<bytes_opt>& states);
+
+    std::vector<bytes_opt> get_states();
+
+    // The final values of the aggregates.
+    std::vector<bytes_opt> compute();
+};
+
+// Computes the states of the aggregates over the rows within ranges
+// owned by the local shard.
+future<std::vector<bytes_opt>> query_partial_aggregates_on_shard(database& db, schema_ptr s, const query::read_command& cmd,
+        const dht::partition_range_vector& ranges, const std::vector<query::partial_aggregate>& aggregates,
+        tracing::trace_state_ptr trace_state, db::timeout_clock::time_point timeout);
+
+}
@@ -88,6 +88,7 @@
 #include "database.hh"
 #include "db/consistency_level_validations.hh"
 #include "cdc/cdc.hh"
+#include "service/partial_aggregates.hh"
 
 namespace bi = boost::intrusive;
 
@@ -1520,6 +1521,10 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of transaction preconditions that did not match current values"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
 
+        sm::make_total_operations("partial_aggregate_queries", partial_aggregate_queries,
+                       sm::description("number of aggregate queries computed by the replicas, which only sent back partial aggregate states"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
         sm::make_histogram("cas_read_contention", sm::description("how many contended reads were encountered"),
                        {storage_proxy_stats::current_scheduling_group_label()},
                        [this]{ return cas_read_contention.get_histogram(1, 8);}),
@@ -4090,6 +4095,107 @@ storage_proxy::do_query(schema_ptr s,
     }
 }
 
+future<std::vector<bytes_opt>>
+storage_proxy::query_partial_aggregates(schema_ptr s,
+    lw_shared_ptr<query::read_command> cmd,
+    dht::partition_range_vector&& partition_ranges,
+    std::vector<query::partial_aggregate> aggregates,
+    db::consistency_level cl,
+    storage_proxy::clock_type::duration timeout,
+    tracing::trace_state_ptr trace_state)
+{
+    // Vnodes aggregated by a single request, whose scan has to fit in the timeout.
+    static constexpr unsigned max_vnodes_per_request = 16;
+
+    ++get_stats().partial_aggregate_queries;
+    auto result = make_lw_shared<partial_aggregates>(*s, aggregates, cmd->slice.cql_format());
+    auto& slice = cmd->slice;
+    if (partition_ranges.empty() ||
+            (slice.default_row_ranges().empty() && !slice.get_specific_ranges())) {
+        return make_ready_future<std::vector<bytes_opt>>(result->get_states());
+    }
+
+    keyspace& ks = _db.local().find_keyspace(s->ks_name());
+    auto& cf = _db.local().find_column_family(s);
+    auto pcf = _db.local().get_config().cache_hit_rate_read_balancing() ? &cf : nullptr;
+    query_ranges_to_vnodes_generator ranges_to_vnodes(s, std::move(partition_ranges),
+            ks.get_replication_strategy().get_type() == locator::replication_strategy_type::local);
+
+    // Each vnode is aggregated by the closest live replica, on all of its
+    // shards. Vnodes of a replica are sent in batches of up to
+    // max_vnodes_per_request.
+    struct vnode_batch {
+        dht::partition_range_vector ranges;
+        unsigned vnodes = 0;
+    };
+    std::unordered_map<gms::inet_address, std::vector<vnode_batch>> batches_per_endpoint;
+    std::optional<gms::inet_address> last_endpoint;
+    // Whether range b starts where range a, split from the same range, ends.
+    auto adjacent = [&s] (const dht::partition_range& a, const dht::partition_range& b) {
+        return a.end() && a.end()->is_inclusive() && b.start() && !b.start()->is_inclusive()
+                && a.end()->value().equal(*s, b.start()->value());
+    };
+    while (!ranges_to_vnodes.empty()) {
+        for (auto&& range : ranges_to_vnodes(1024)) {
+            std::vector<gms::inet_address> live_endpoints = get_live_sorted_endpoints(ks, end_token(range));
+            std::vector<gms::inet_address> filtered_endpoints = filter_for_query(cl, ks, live_endpoints, {}, pcf);
+            try {
+                db::assure_sufficient_live_nodes(cl, ks, filtered_endpoints);
+            } catch(exceptions::unavailable_exception& ex) {
+                slogger.debug("Read unavailable: cl={} required {} alive {}", ex.consistency, ex.required, ex.alive);
+                get_stats().range_slice_unavailables.mark();
+                throw;
+            }
+            auto& batches = batches_per_endpoint[filtered_endpoints.front()];
+            if (batches.empty() || batches.back().vnodes == max_vnodes_per_request) {
+                batches.emplace_back();
+            }
+            auto& batch = batches.back();
+            if (last_endpoint == filtered_endpoints.front() && !batch.ranges.empty() && adjacent(batch.ranges.back(), range)) {
+                // Consecutive vnodes of the same replica are read as one range.
+                batch.ranges.back() = dht::partition_range(batch.ranges.back().start(), range.end());
+            } else {
+                batch.ranges.push_back(std::move(range));
+            }
+            ++batch.vnodes;
+            last_endpoint = filtered_endpoints.front();
+        }
+    }
+
+    utils::latency_counter lc;
+    lc.start();
+    auto p = shared_from_this();
+    return do_with(std::move(batches_per_endpoint), std::move(aggregates), [p, s = std::move(s), cmd, result, timeout, trace_state = std::move(trace_state)] (
+            std::unordered_map<gms::inet_address, std::vector<vnode_batch>>& batches_per_endpoint,
+            std::vector<query::partial_aggregate>& aggregates) mutable {
+        return parallel_for_each(batches_per_endpoint, [p, s, cmd, result, timeout, trace_state, &aggregates] (auto& endpoint_and_batches) {
+            auto& [ep, batches] = endpoint_and_batches;
+            return do_for_each(batches, [p, s, cmd, result, timeout, trace_state, &aggregates, ep = ep] (const vnode_batch& batch) {
+                tracing::trace(trace_state, "partial_aggregates: querying {:d} ranges on /{}", batch.ranges.size(), ep);
+                auto request_timeout = clock_type::now() + timeout;
+                auto f = fbu::is_me(ep)
+                        ? p->query_partial_aggregates_locally(s, cmd, batch.ranges, aggregates, trace_state, request_timeout)
+                        : netw::get_local_messaging_service().send_partial_aggregates(netw::messaging_service::msg_addr{ep, 0},
+                                request_timeout, *cmd, batch.ranges, aggregates);
+                return f.then([result, trace_state, ep] (std::vector<bytes_opt> states) {
+                    tracing::trace(trace_state, "partial_aggregates: got response from /{}", ep);
+                    result->merge(states);
+                });
+            });
+        });
+    }).then([result] {
+        return result->get_states();
+    }).handle_exception([p] (std::exception_ptr eptr) {
+        p->handle_read_error(eptr, true);
+        return make_exception_future<std::vector<bytes_opt>>(eptr);
+    }).finally([lc, p] () mutable {
+        p->get_stats().range.mark(lc.stop().latency());
+        if (lc.is_start()) {
+            p->get_stats().estimated_range.add(lc.latency(), p->get_stats().range.hist.count);
+        }
+    });
+}
+
 // WARNING: the function should be called on a shard that owns the key that is been read
 future<storage_proxy::coordinator_query_result>
 storage_proxy::do_query_with_paxos(schema_ptr s,
@@ -4771,6 +4877,27 @@ void storage_proxy::init_messaging_service() {
             });
         });
     });
+    ms.register_partial_aggregates([] (const rpc::client_info& cinfo, rpc::opt_time_point t, query::read_command cmd,
+            dht::partition_range_vector ranges, std::vector<query::partial_aggregate> aggregates) {
+        tracing::trace_state_ptr trace_state_ptr;
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        if (cmd.trace_info) {
+            trace_state_ptr = tracing::tracing::get_local_tracing_instance().create_session(*cmd.trace_info);
+            tracing::begin(trace_state_ptr);
+            tracing::trace(trace_state_ptr, "partial_aggregates: message received from /{}", src_addr.addr);
+        }
+        return do_with(std::move(ranges), std::move(aggregates), get_local_shared_storage_proxy(), std::move(trace_state_ptr),
+                [cmd = make_lw_shared<query::read_command>(std::move(cmd)), src_addr = std::move(src_addr), t] (dht::partition_range_vector& ranges,
+                        std::vector<query::partial_aggregate>& aggregates, shared_ptr<storage_proxy>& p, tracing::trace_state_ptr& trace_state_ptr) mutable {
+            auto src_ip = src_addr.addr;
+            return get_schema_for_read(cmd->schema_version, std::move(src_addr)).then([cmd, &ranges, &aggregates, &p, &trace_state_ptr, t] (schema_ptr s) {
+                auto timeout = t ? *t : db::no_timeout;
+                return p->query_partial_aggregates_locally(std::move(s), cmd, ranges, aggregates, trace_state_ptr, timeout);
+            }).finally([&trace_state_ptr, src_ip] () mutable {
+                tracing::trace(trace_state_ptr, "partial_aggregates handling is done, sending a response to /{}", src_ip);
+            });
+        });
+    });
     ms.register_truncate([this](sstring ksname, sstring cfname) {
         return do_with(utils::make_joinpoint([] { return db_clock::now();}),
                         [this, ksname, cfname](auto& tsf) {
@@ -4847,6 +4974,7 @@ future<> storage_proxy::uninit_messaging_service() {
         ms.unregister_read_data(),
         ms.unregister_read_mutation_data(),
         ms.unregister_read_digest(),
+        ms.unregister_partial_aggregates(),
         ms.unregister_truncate(),
         ms.unregister_paxos_prepare(),
         ms.unregister_paxos_accept(),
@@ -4884,6 +5012,28 @@ storage_proxy::query_mutations_locally(schema_ptr s, lw_shared_ptr<query::read_c
     }
 }
 
+future<std::vector<bytes_opt>>
+storage_proxy::query_partial_aggregates_locally(schema_ptr s,
+                                                lw_shared_ptr<query::read_command> cmd,
+                                                const dht::partition_range_vector& prs,
+                                                const std::vector<query::partial_aggregate>& aggregates,
+                                                tracing::trace_state_ptr trace_state,
+                                                storage_proxy::clock_type::time_point timeout) {
+    // Shards only read the data they own, so each of them reads all ranges.
+    // Pass the command by reference, copying the lw_shared_ptr on other
+    // shards is not safe.
+    auto result = partial_aggregates(*s, aggregates, cmd->slice.cql_format());
+    return _db.map_reduce0([gs = global_schema_ptr(s), &c = *cmd, &prs, &aggregates, timeout,
+            gt = tracing::global_trace_state_ptr(std::move(trace_state))] (database& db) {
+        return query_partial_aggregates_on_shard(db, gs, c, prs, aggregates, gt, timeout);
+    }, std::move(result), [] (partial_aggregates result, std::vector<bytes_opt> states) {
+        result.merge(states);
+        return result;
+    }).then([cmd] (partial_aggregates result) {
+        return result.get_states();
+    });
+}
+
 future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>>
 storage_proxy::query_nonsingular_mutations_locally(schema_ptr s,
                                                    lw_shared_ptr<query::read_command> cmd,
@@ -373,6 +373,9 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
     future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> query_nonsingular_mutations_locally(
             schema_ptr s, lw_shared_ptr<query::read_command> cmd, const dht::partition_range_vector&& pr, tracing::trace_state_ptr trace_state,
             uint64_t max_size, clock_type::time_point timeout);
+    future<std::vector<bytes_opt>> query_partial_aggregates_locally(schema_ptr s, lw_shared_ptr<query::read_command> cmd,
+            const dht::partition_range_vector& pr, const std::vector<query::partial_aggregate>& aggregates,
+            tracing::trace_state_ptr trace_state, clock_type::time_point timeout);
 
     future<> mutate_counters_on_leader(std::vector<frozen_mutation_and_schema> mutations, db::consistency_level cl, clock_type::time_point timeout,
                                        tracing::trace_state_ptr trace_state, service_permit permit);
@@ -515,6 +518,21 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
         db::consistency_level cl,
         coordinator_query_options optional_params);
 
+    // Computes the aggregates of the rows selected by cmd on the replicas,
+    // see service::partial_aggregates, and returns their combined states.
+    // Each vnode is aggregated by a single replica, so cl must be one which
+    // requires a single replica to respond.
+    // Replicas are sent a request per batch of vnodes, one after another, and
+    // each request gets its own timeout, so that the timeout doesn't have to
+    // cover a scan of the whole table.
+    future<std::vector<bytes_opt>> query_partial_aggregates(schema_ptr,
+        lw_shared_ptr<query::read_command> cmd,
+        dht::partition_range_vector&& partition_ranges,
+        std::vector<query::partial_aggregate> aggregates,
+        db::consistency_level cl,
+        clock_type::duration timeout,
+        tracing::trace_state_ptr trace_state);
+
     future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> query_mutations_locally(
         schema_ptr, lw_shared_ptr<query::read_command> cmd, const dht::partition_range&,
         clock_type::time_point timeout,
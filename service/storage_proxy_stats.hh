@@ -177,6 +177,8 @@ struct stats : public write_stats {
 
     uint64_t cas_read_unfinished_commit = 0;
 
+    uint64_t partial_aggregate_queries = 0; // aggregates computed by the replicas
+
     // Data read attempts
     split_stats data_read_attempts;
     split_stats data_read_completed;
@@ -116,6 +116,9 @@ static const sstring CDC_FEATURE = "CDC";
 static const sstring NONFROZEN_UDTS_FEATURE = "NONFROZEN_UDTS";
 static const sstring HINTED_HANDOFF_SEPARATE_CONNECTION_FEATURE = "HINTED_HANDOFF_SEPARATE_CONNECTION";
 static const sstring LWT_FEATURE = "LWT";
+static const sstring PARTIAL_AGGREGATES_FEATURE = "PARTIAL_AGGREGATES";
+static const sstring COMPRESSION_DICTIONARIES_FEATURE = "COMPRESSION_DICTIONARIES";
+static const sstring SPLIT_BLOCK_BLOOM_FILTERS_FEATURE = "SPLIT_BLOCK_BLOOM_FILTERS";
 
 static const sstring SSTABLE_FORMAT_PARAM_NAME = "sstable_format";
 
@@ -180,6 +183,9 @@ storage_service::storage_service(abort_source& abort_source, distributed<databas
         , _nonfrozen_udts(_feature_service, NONFROZEN_UDTS_FEATURE)
         , _hinted_handoff_separate_connection(_feature_service, HINTED_HANDOFF_SEPARATE_CONNECTION_FEATURE)
         , _lwt_feature(_feature_service, LWT_FEATURE)
+        , _partial_aggregates_feature(_feature_service, PARTIAL_AGGREGATES_FEATURE)
+        , _compression_dictionaries_feature(_feature_service, COMPRESSION_DICTIONARIES_FEATURE)
+        , _split_block_bloom_filters_feature(_feature_service, SPLIT_BLOCK_BLOOM_FILTERS_FEATURE)
         , _la_feature_listener(*this, _feature_listeners_sem, sstables::sstable_version_types::la)
         , _mc_feature_listener(*this, _feature_listeners_sem, sstables::sstable_version_types::mc)
         , _replicate_action([this] { return do_replicate_to_all_cores(); })
@@ -241,7 +247,10 @@ void storage_service::enable_all_features() {
         std::ref(_cdc_feature),
         std::ref(_nonfrozen_udts),
         std::ref(_hinted_handoff_separate_connection),
-        std::ref(_lwt_feature)
+        std::ref(_lwt_feature),
+        std::ref(_partial_aggregates_feature),
+        std::ref(_compression_dictionaries_feature),
+        std::ref(_split_block_bloom_filters_feature)
     })
     {
         if (features.count(f.name())) {
@@ -349,6 +358,9 @@ std::set<sstring> storage_service::get_config_supported_features_set() {
         COMPUTED_COLUMNS_FEATURE,
         NONFROZEN_UDTS_FEATURE,
         HINTED_HANDOFF_SEPARATE_CONNECTION_FEATURE,
+        PARTIAL_AGGREGATES_FEATURE,
+        COMPRESSION_DICTIONARIES_FEATURE,
+        SPLIT_BLOCK_BLOOM_FILTERS_FEATURE,
     };
 
     // Do not respect config in the case database is not started
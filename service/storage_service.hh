@@ -347,6 +347,9 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
     gms::feature _nonfrozen_udts;
     gms::feature _hinted_handoff_separate_connection;
     gms::feature _lwt_feature;
+    gms::feature _partial_aggregates_feature;
+    gms::feature _compression_dictionaries_feature;
+    gms::feature _split_block_bloom_filters_feature;
 
     sstables::sstable_version_types _sstables_format = sstables::sstable_version_types::ka;
     seastar::named_semaphore _feature_listeners_sem = {1, named_semaphore_exception_factory{"feature listeners"}};
@@ -2389,6 +2392,18 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
         return bool(_lwt_feature);
     }
 
+    bool cluster_supports_partial_aggregates() const {
+        return bool(_partial_aggregates_feature);
+    }
+
+    bool cluster_supports_compression_dictionaries() const {
+        return bool(_compression_dictionaries_feature);
+    }
+
+    bool cluster_supports_split_block_bloom_filters() const {
+        return bool(_split_block_bloom_filters_feature);
+    }
+
     // Returns schema features which all nodes in the cluster advertise as supported.
     db::schema_features cluster_schema_features() const;
 
@@ -709,16 +709,7 @@ class regular_compaction : public compaction {
     }
 
     flat_mutation_reader make_sstable_reader() const override {
-        return ::make_local_shard_sstable_reader(_schema,
-                no_reader_permit(),
-                _compacting,
-                query::full_partition_range,
-                _schema->full_slice(),
-                service::get_local_compaction_priority(),
-                tracing::trace_state_ptr(),
-                ::streamed_mutation::forwarding::no,
-                ::mutation_reader::forwarding::no,
-                _monitor_generator);
+        return make_sstable_reader_for(query::full_partition_range, ::mutation_reader::forwarding::no);
     }
 
     void report_start(const sstring& formatted_msg) const override {
@@ -781,6 +772,19 @@ class regular_compaction : public compaction {
         }
         replace_remaining_exhausted_sstables();
     }
+protected:
+    flat_mutation_reader make_sstable_reader_for(const dht::partition_range& range, ::mutation_reader::forwarding fwd_mr) const {
+        return ::make_local_shard_sstable_reader(_schema,
+                no_reader_permit(),
+                _compacting,
+                range,
+                _schema->full_slice(),
+                service::get_local_compaction_priority(),
+                tracing::trace_state_ptr(),
+                ::streamed_mutation::forwarding::no,
+                fwd_mr,
+                _monitor_generator);
+    }
 private:
     void on_end_of_stream() {
         if (_weight_registration) {
@@ -869,12 +873,60 @@ class regular_compaction : public compaction {
 };
 
 class cleanup_compaction final : public regular_compaction {
-public:
-    cleanup_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator, replacer_fn replacer)
+    // Token ranges owned by the node.
+    dht::token_range_vector _node_ranges;
+    // Owned ranges which overlap the sstables. Only they are read, so that the index skips over
+    // the partitions which aren't owned, instead of them being read only to be filtered out.
+    dht::partition_range_vector _owned_ranges;
+private:
+    static dht::token_range_vector take_node_ranges(const column_family& cf, compaction_descriptor& descriptor) {
+        if (descriptor.owned_ranges) {
+            return std::move(*descriptor.owned_ranges);
+        }
+        return service::get_local_storage_service().get_local_ranges(cf.schema()->ks_name());
+    }
+
+    static dht::partition_range_vector get_owned_ranges(dht::token_range_vector owned_ranges, const std::vector<shared_sstable>& sstables) {
+        auto first = sstables.front()->get_first_decorated_key().token();
+        auto last = sstables.front()->get_last_decorated_key().token();
+        for (auto& sst : sstables) {
+            first = std::min(first, sst->get_first_decorated_key().token());
+            last = std::max(last, sst->get_last_decorated_key().token());
+        }
+        auto sstables_range = dht::token_range::make(first, last);
+
+        auto e = boost::range::remove_if(owned_ranges, [&] (const dht::token_range& r) {
+            return !r.overlaps(sstables_range, dht::token_comparator());
+        });
+        owned_ranges.erase(e, owned_ranges.end());
+        // The ranges are read by fast forwarding, so they have to be sorted and disjoint.
+        owned_ranges = dht::token_range::deoverlap(std::move(owned_ranges), dht::token_comparator());
+        return boost::copy_range<dht::partition_range_vector>(owned_ranges | boost::adaptors::transformed(dht::to_partition_range));
+    }
+
+    // The descriptor is only moved from once the node ranges are taken out of it.
+    cleanup_compaction(column_family& cf, dht::token_range_vector node_ranges, compaction_descriptor&& descriptor,
+            std::function<shared_sstable()> creator, replacer_fn replacer)
         : regular_compaction(cf, std::move(descriptor), std::move(creator), std::move(replacer))
+        , _node_ranges(std::move(node_ranges))
+        , _owned_ranges(get_owned_ranges(_node_ranges, _sstables))
     {
         _info->type = compaction_type::Cleanup;
     }
+public:
+    cleanup_compaction(column_family& cf, compaction_descriptor descriptor, std::function<shared_sstable()> creator, replacer_fn replacer)
+        : cleanup_compaction(cf, take_node_ranges(cf, descriptor), std::move(descriptor), std::move(creator), std::move(replacer))
+    {
+    }
+
+    flat_mutation_reader make_sstable_reader() const override {
+        auto source = mutation_source([this] (schema_ptr s, reader_permit, const dht::partition_range& range, const query::partition_slice&,
+                const io_priority_class&, tracing::trace_state_ptr, ::streamed_mutation::forwarding, ::mutation_reader::forwarding fwd_mr) {
+            return make_sstable_reader_for(range, fwd_mr);
+        });
+        return make_flat_multi_range_reader(_schema, std::move(source), _owned_ranges, _schema->full_slice(),
+                service::get_local_compaction_priority());
+    }
 
     void report_start(const sstring& formatted_msg) const override {
         clogger.info("Cleaning {}", formatted_msg);
@@ -885,15 +937,13 @@ class cleanup_compaction final : public regular_compaction {
     }
 
     flat_mutation_reader::filter make_partition_filter() const override {
-        dht::token_range_vector owned_ranges = service::get_local_storage_service().get_local_ranges(_schema->ks_name());
-
-        return [this, owned_ranges = std::move(owned_ranges)] (const dht::decorated_key& dk) {
+        return [this] (const dht::decorated_key& dk) {
             if (dht::shard_of(dk.token()) != engine().cpu_id()) {
                 clogger.trace("Token {} does not belong to CPU {}, skipping", dk.token(), engine().cpu_id());
                 return false;
             }
 
-            if (!belongs_to_current_node(dk.token(), owned_ranges)) {
+            if (!belongs_to_current_node(dk.token(), _node_ranges)) {
                 clogger.trace("Token {} does not belong to this node, skipping", dk.token());
                 return false;
             }
@@ -26,6 +26,7 @@
 #include "shared_sstable.hh"
 #include "gc_clock.hh"
 #include "compaction_weight_registration.hh"
+#include "dht/i_partitioner.hh"
 #include "utils/UUID.hh"
 #include <seastar/core/thread.hh>
 #include <functional>
@@ -46,6 +47,9 @@ namespace sstables {
         // Calls compaction manager's task for this compaction to release reference to exhausted sstables.
         std::function<void(const std::vector<shared_sstable>& exhausted_sstables)> release_exhausted;
         bool cleanup;
+        // Token ranges owned by the node, whose data a cleanup keeps. If not set, they are taken from
+        // the storage service.
+        std::optional<dht::token_range_vector> owned_ranges;
 
         compaction_descriptor() = default;
 
@@ -28,6 +28,7 @@
 #include "exceptions.hh"
 #include <cmath>
 #include <boost/range/algorithm/count_if.hpp>
+#include <boost/range/adaptor/map.hpp>
 
 static logging::logger cmlog("compaction_manager");
 using namespace std::chrono_literals;
@@ -175,7 +176,7 @@ int compaction_manager::trim_to_compact(column_family* cf, sstables::compaction_
     return weight;
 }
 
-bool compaction_manager::can_register_weight(column_family* cf, int weight) const {
+bool compaction_manager::can_register_weight(column_family* cf, int weight, bool boosted) const {
     auto has_cf_ongoing_compaction = [&] () -> bool {
         return boost::range::count_if(_tasks, [&] (const lw_shared_ptr<task>& task) {
             return task->compacting_cf == cf && task->compaction_running;
@@ -186,6 +187,12 @@ bool compaction_manager::can_register_weight(column_family* cf, int weight) cons
     if (!cf->get_compaction_strategy().parallel_compaction() && has_cf_ongoing_compaction()) {
         return false;
     }
+    // A boosted column family only competes with itself for weights.
+    if (boosted) {
+        return !boost::range::count_if(_tasks, [&] (const lw_shared_ptr<task>& task) {
+            return task->compacting_cf == cf && task->compaction_running && task->weight == weight;
+        });
+    }
     // TODO: Maybe allow only *smaller* compactions to start? That can be done
     // by returning true only if weight is not in the set and is lower than any
     // entry in the set.
@@ -202,7 +209,10 @@ void compaction_manager::register_weight(int weight) {
 }
 
 void compaction_manager::deregister_weight(int weight) {
-    _weight_tracker.erase(weight);
+    auto it = _weight_tracker.find(weight);
+    if (it != _weight_tracker.end()) {
+        _weight_tracker.erase(it);
+    }
     reevaluate_postponed_compactions();
 }
 
@@ -307,6 +317,87 @@ future<> compaction_manager::submit_major_compaction(column_family* cf) {
     return task->compaction_done.get_future().then([task] {});
 }
 
+std::vector<sstables::shared_sstable> compaction_manager::get_tombstone_compaction_candidates(const column_family& cf) {
+    auto& cs = cf.get_compaction_strategy();
+    auto gc_before = gc_clock::now() - cf.schema()->gc_grace_seconds();
+
+    // Overlapping sstables aren't checked here. Almost every sstable overlaps older ones by
+    // token range, while they rarely hold the deleted keys. Compaction checks each key against
+    // their bloom filters and keeps only the tombstones which may shadow data.
+    std::vector<std::pair<double, sstables::shared_sstable>> candidates;
+    for (auto& sst : get_candidates(cf)) {
+        if (cs.worth_dropping_tombstones(sst, gc_before)) {
+            candidates.emplace_back(sst->estimate_droppable_tombstone_ratio(gc_before), sst);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [] (const auto& i, const auto& j) {
+        return i.first > j.first;
+    });
+    return boost::copy_range<std::vector<sstables::shared_sstable>>(candidates
+        | boost::adaptors::transformed([] (auto& c) { return c.second; }));
+}
+
+future<> compaction_manager::submit_tombstone_compaction(column_family* cf) {
+    if (_stopped) {
+        return make_ready_future<>();
+    }
+    auto task = make_lw_shared<compaction_manager::task>();
+    task->compacting_cf = cf;
+    task->tombstone_compaction = true;
+    _tasks.push_back(task);
+
+    task->compaction_done = with_semaphore(_tombstone_compaction_sem, 1, [this, task, cf] {
+        if (!can_proceed(task)) {
+            return make_ready_future<>();
+        }
+        return do_with(get_tombstone_compaction_candidates(*cf), [this, task, cf] (std::vector<sstables::shared_sstable>& candidates) {
+            // Candidates may have been compacted away by the time the rewrite of earlier ones is done.
+            auto still_candidate = [this, task, cf] (const sstables::shared_sstable& sst) {
+                return can_proceed(task) && !_compacting_sstables.count(sst) && cf->get_sstables()->count(sst);
+            };
+            return do_for_each(candidates, [this, cf, still_candidate] (const sstables::shared_sstable& sst) {
+                if (!still_candidate(sst)) {
+                    return make_ready_future<>();
+                }
+                return with_lock(_compaction_locks[cf].for_read(), [this, cf, sst, still_candidate] {
+                    if (!still_candidate(sst)) {
+                        return make_ready_future<>();
+                    }
+                    // The output takes the place of the input in its level and run, which it doesn't
+                    // overlap, so the strategy sees the same sstables, only with less data.
+                    auto descriptor = sstables::compaction_descriptor({ sst }, sst->get_sstable_level(),
+                            sstables::compaction_descriptor::default_max_sstable_bytes, sst->run_identifier());
+                    auto compacting = make_lw_shared<compacting_sstable_registration>(this, descriptor.sstables);
+                    descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted_sstables) {
+                        compacting->release_compacting(exhausted_sstables);
+                    };
+                    cmlog.debug("Accepted tombstone compaction of {} for {}.{}", sst->get_filename(), cf->schema()->ks_name(), cf->schema()->cf_name());
+
+                    _stats.active_tasks++;
+                    return with_scheduling_group(_scheduling_group, [cf, descriptor = std::move(descriptor)] () mutable {
+                        return cf->run_compaction(std::move(descriptor));
+                    }).finally([this, compacting = std::move(compacting)] {
+                        _stats.active_tasks--;
+                    });
+                });
+            });
+        });
+    }).then_wrapped([this, task] (future<> f) {
+        _tasks.remove(task);
+        try {
+            f.get();
+            _stats.completed_tasks++;
+        } catch (sstables::compaction_stop_exception& e) {
+            cmlog.info("tombstone compaction stopped, reason: {}", e.what());
+            _stats.errors++;
+        } catch (...) {
+            cmlog.error("tombstone compaction failed, reason: {}", std::current_exception());
+            _stats.errors++;
+        }
+    });
+    return task->compaction_done.get_future().then([task] {});
+}
+
 future<> compaction_manager::run_resharding_job(column_family* cf, std::function<future<>()> job) {
     if (_stopped) {
         return make_ready_future<>();
@@ -383,6 +474,15 @@ compaction_manager::compaction_manager()
     : compaction_manager(seastar::default_scheduling_group(), default_priority_class(), 1)
 {}
 
+void compaction_manager::set_compaction_boost_thresholds(size_t sstable_count, size_t overlapping_sstables) {
+    _boost_sstable_count_threshold = sstable_count;
+    _boost_overlapping_sstables_threshold = overlapping_sstables;
+}
+
+void compaction_manager::set_tombstone_compaction_check_interval(std::chrono::seconds interval) {
+    _tombstone_compaction_check_interval = interval;
+}
+
 compaction_manager::~compaction_manager() {
     // Assert that compaction manager was explicitly stopped, if started.
     // Otherwise, fiber(s) will be alive after the object is destroyed.
@@ -402,6 +502,9 @@ void compaction_manager::start() {
     _stopped = false;
     register_metrics();
     _compaction_submission_timer.arm(periodic_compaction_submission_interval());
+    if (_tombstone_compaction_check_interval.count()) {
+        _tombstone_compaction_timer.arm_periodic(_tombstone_compaction_check_interval);
+    }
     postponed_compactions_reevaluation();
 }
 
@@ -413,6 +516,22 @@ std::function<void()> compaction_manager::compaction_submission_callback() {
     };
 }
 
+std::function<void()> compaction_manager::tombstone_compaction_submission_callback() {
+    return [this] () mutable {
+        auto cfs = boost::copy_range<std::vector<column_family*>>(_compaction_locks | boost::adaptors::map_keys);
+        for (auto cf : cfs) {
+            // A column family whose previous check is still going has nothing new to offer.
+            auto pending = std::any_of(_tasks.begin(), _tasks.end(), [cf] (const lw_shared_ptr<task>& task) {
+                return task->compacting_cf == cf && task->tombstone_compaction;
+            });
+            if (!pending) {
+                // Errors are logged by the task itself.
+                (void)submit_tombstone_compaction(cf);
+            }
+        }
+    };
+}
+
 void compaction_manager::postponed_compactions_reevaluation() {
     _waiting_reevalution = repeat([this] {
         return _postponed_reevaluation.wait().then([this] {
@@ -421,9 +540,10 @@ void compaction_manager::postponed_compactions_reevaluation() {
                 return stop_iteration::yes;
             }
             auto postponed = std::move(_postponed);
+            order_postponed_compactions(postponed);
             try {
-                for (auto& cf : postponed) {
-                    submit(cf);
+                for (auto& p : postponed) {
+                    submit(p.cf);
                 }
             } catch (...) {
                 _postponed = std::move(postponed);
@@ -437,8 +557,95 @@ void compaction_manager::reevaluate_postponed_compactions() {
     _postponed_reevaluation.signal();
 }
 
-void compaction_manager::postpone_compaction_for_column_family(column_family* cf) {
-    _postponed.push_back(cf);
+void compaction_manager::postpone_compaction_for_column_family(column_family* cf, int weight, bool boosted) {
+    _postponed.push_back(postponed_compaction{cf, weight, boosted});
+}
+
+void compaction_manager::order_postponed_compactions(std::vector<postponed_compaction>& postponed) const {
+    // Boosted column families first, then in the order of fair queueing.
+    std::stable_sort(postponed.begin(), postponed.end(), [this] (const postponed_compaction& a, const postponed_compaction& b) {
+        if (a.boosted != b.boosted) {
+            return a.boosted;
+        }
+        return compaction_start_tag(a.cf) < compaction_start_tag(b.cf);
+    });
+}
+
+double compaction_manager::compaction_start_tag(column_family* cf) const {
+    auto it = _compaction_finish_tags.find(cf);
+    if (it == _compaction_finish_tags.end()) {
+        return _compaction_virtual_time;
+    }
+    return std::max(it->second, _compaction_virtual_time);
+}
+
+void compaction_manager::charge_compaction(column_family* cf, uint64_t input_size) {
+    auto start = compaction_start_tag(cf);
+    _compaction_virtual_time = start;
+    _compaction_finish_tags[cf] = start + double(input_size) / cf->get_compaction_strategy().shares();
+}
+
+bool compaction_manager::must_yield_weight(column_family* cf, int weight, bool boosted) const {
+    if (boosted) {
+        return false;
+    }
+    auto start = compaction_start_tag(cf);
+    return std::any_of(_postponed.begin(), _postponed.end(), [&] (const postponed_compaction& p) {
+        return p.cf != cf && !p.boosted && p.weight == weight && compaction_start_tag(p.cf) < start && can_register_weight(p.cf, weight);
+    });
+}
+
+compaction_manager::job_admission compaction_manager::admit_compaction_job(column_family* cf, int weight, bool boosted, uint64_t input_size) {
+    if (!can_register_weight(cf, weight, boosted)) {
+        postpone_compaction_for_column_family(cf, weight, boosted);
+        return job_admission::refused;
+    }
+    if (must_yield_weight(cf, weight, boosted)) {
+        postpone_compaction_for_column_family(cf, weight, boosted);
+        reevaluate_postponed_compactions();
+        return job_admission::yielded;
+    }
+    charge_compaction(cf, input_size);
+    return job_admission::accepted;
+}
+
+lw_shared_ptr<compaction_backlog_tracker> compaction_manager::make_boosted_backlog_tracker() {
+    // A boosted compaction raises the shares of compaction like a user initiated one, so that the
+    // column family gets back below the thresholds soon.
+    auto tracker = make_lw_shared<compaction_backlog_tracker>(std::make_unique<user_initiated_backlog_tracker>(
+            _compaction_controller.backlog_of_shares(boosted_compaction_shares), _available_memory));
+    register_backlog_tracker(*tracker);
+    return tracker;
+}
+
+// The largest number of sstables whose token ranges overlap at some token, which is the largest
+// number of sstables a single partition read may have to go through.
+static size_t max_overlapping_sstables(const column_family& cf) {
+    std::vector<std::pair<dht::token, int>> bounds;
+    bounds.reserve(cf.sstables_count() * 2);
+    for (auto& sst : *cf.get_sstables()) {
+        bounds.emplace_back(sst->get_first_decorated_key().token(), 1);
+        bounds.emplace_back(sst->get_last_decorated_key().token(), -1);
+    }
+    // Start bounds go first at the same token, as token ranges of sstables are inclusive.
+    std::sort(bounds.begin(), bounds.end(), [] (const auto& a, const auto& b) {
+        return a.first < b.first || (a.first == b.first && a.second > b.second);
+    });
+    size_t overlapping = 0;
+    size_t max_overlapping = 0;
+    for (auto& b : bounds) {
+        overlapping += b.second;
+        max_overlapping = std::max(max_overlapping, overlapping);
+    }
+    return max_overlapping;
+}
+
+bool compaction_manager::needs_boost(const column_family& cf) const {
+    if (_boost_sstable_count_threshold && cf.sstables_count() > _boost_sstable_count_threshold) {
+        return true;
+    }
+    return _boost_overlapping_sstables_threshold && cf.sstables_count() > _boost_overlapping_sstables_threshold
+        && max_overlapping_sstables(cf) > _boost_overlapping_sstables_threshold;
 }
 
 future<> compaction_manager::stop() {
@@ -466,6 +673,7 @@ future<> compaction_manager::stop() {
     }).then([this] {
         _weight_tracker.clear();
         _compaction_submission_timer.cancel();
+        _tombstone_compaction_timer.cancel();
         cmlog.info("Stopped");
         return _compaction_controller.shutdown();
     });
@@ -521,33 +729,54 @@ void compaction_manager::submit(column_family* cf) {
             column_family& cf = *task->compacting_cf;
             sstables::compaction_strategy cs = cf.get_compaction_strategy();
             sstables::compaction_descriptor descriptor = cs.get_sstables_for_compaction(cf, get_candidates(cf));
-            int weight = trim_to_compact(&cf, descriptor);
+            bool boosted = needs_boost(cf);
+            // A boosted job doesn't wait for weights taken by other column families, so there's no need to trim it.
+            int weight = boosted ? calculate_weight(descriptor.sstables) : trim_to_compact(&cf, descriptor);
 
             if (descriptor.sstables.empty() || !can_proceed(task)) {
                 _stats.pending_tasks--;
                 return make_ready_future<stop_iteration>(stop_iteration::yes);
             }
-            if (!can_register_weight(&cf, weight)) {
+            uint64_t input_size = 0;
+            for (auto& sst : descriptor.sstables) {
+                input_size += sst->data_size();
+            }
+            switch (admit_compaction_job(&cf, weight, boosted, input_size)) {
+            case job_admission::refused:
                 _stats.pending_tasks--;
                 cmlog.debug("Refused compaction job ({} sstable(s)) of weight {} for {}.{}, postponing it...",
                     descriptor.sstables.size(), weight, cf.schema()->ks_name(), cf.schema()->cf_name());
-                postpone_compaction_for_column_family(&cf);
                 return make_ready_future<stop_iteration>(stop_iteration::yes);
+            case job_admission::yielded:
+                _stats.pending_tasks--;
+                cmlog.debug("Yielded weight {} of compaction job ({} sstable(s)) for {}.{} to a postponed job, postponing it...",
+                    weight, descriptor.sstables.size(), cf.schema()->ks_name(), cf.schema()->cf_name());
+                return make_ready_future<stop_iteration>(stop_iteration::yes);
+            case job_admission::accepted:
+                break;
             }
             auto compacting = make_lw_shared<compacting_sstable_registration>(this, descriptor.sstables);
             descriptor.weight_registration = compaction_weight_registration(this, weight);
             descriptor.release_exhausted = [compacting] (const std::vector<sstables::shared_sstable>& exhausted_sstables) {
                 compacting->release_compacting(exhausted_sstables);
             };
-            cmlog.debug("Accepted compaction job ({} sstable(s)) of weight {} for {}.{}",
+            cmlog.debug("Accepted {}compaction job ({} sstable(s)) of weight {} for {}.{}", boosted ? "boosted " : "",
                 descriptor.sstables.size(), weight, cf.schema()->ks_name(), cf.schema()->cf_name());
 
+            lw_shared_ptr<compaction_backlog_tracker> boosted_backlog;
+            if (boosted) {
+                boosted_backlog = make_boosted_backlog_tracker();
+            }
+
             _stats.pending_tasks--;
             _stats.active_tasks++;
             task->compaction_running = true;
-            return cf.run_compaction(std::move(descriptor)).then_wrapped([this, task, compacting = std::move(compacting)] (future<> f) mutable {
+            task->weight = weight;
+            return cf.run_compaction(std::move(descriptor)).then_wrapped([this, task, compacting = std::move(compacting),
+                    boosted_backlog = std::move(boosted_backlog)] (future<> f) mutable {
                 _stats.active_tasks--;
                 task->compaction_running = false;
+                task->weight = -1;
 
                 if (!can_proceed(task)) {
                     maybe_stop_on_error(std::move(f), stop_iteration::yes);
@@ -704,7 +933,8 @@ future<> compaction_manager::remove(column_family* cf) {
             task->stopping = true;
         }
     }
-    _postponed.erase(boost::remove(_postponed, cf), _postponed.end());
+    _postponed.erase(boost::remove_if(_postponed, [cf] (const postponed_compaction& p) { return p.cf == cf; }), _postponed.end());
+    _compaction_finish_tags.erase(cf);
 
     // Wait for the termination of an ongoing compaction on cf, if any.
     return do_for_each(*tasks_to_stop, [this, cf] (auto& task) {
@@ -61,7 +61,17 @@ class compaction_manager {
         exponential_backoff_retry compaction_retry = exponential_backoff_retry(std::chrono::seconds(5), std::chrono::seconds(300));
         bool stopping = false;
         bool cleanup = false;
+        bool tombstone_compaction = false;
         bool compaction_running = false;
+        // Weight of the running regular compaction, if any.
+        int weight = -1;
+    };
+
+    struct postponed_compaction {
+        column_family* cf;
+        // Weight of the compaction job which was refused.
+        int weight;
+        bool boosted;
     };
 
     // compaction manager may have N fibers to allow parallel compaction per shard.
@@ -82,10 +92,28 @@ class compaction_manager {
     future<> _waiting_reevalution = make_ready_future<>();
     condition_variable _postponed_reevaluation;
     // column families that wait for compaction but had its submission postponed due to ongoing compaction.
-    std::vector<column_family*> _postponed;
+    std::vector<postponed_compaction> _postponed;
     // tracks taken weights of ongoing compactions, only one compaction per weight is allowed.
     // weight is value assigned to a compaction job that is log base N of total size of all input sstables.
-    std::unordered_set<int> _weight_tracker;
+    // Boosted column families don't compete for weights with others, so a weight may be taken
+    // more than once.
+    std::unordered_multiset<int> _weight_tracker;
+
+    // Weights are given to the compaction jobs of column families in the order of start-time fair
+    // queueing. Each job is tagged with the virtual time at which its column family starts it,
+    // and pushes the virtual time of its column family forward by its input size divided by the
+    // compaction shares of the column family. A job yields its weight to a postponed job of another
+    // column family with an earlier start tag, which is then reevaluated first.
+    double _compaction_virtual_time = 0;
+    std::unordered_map<column_family*, double> _compaction_finish_tags;
+
+    // A column family with more sstables than this, or more sstables overlapping one another, is
+    // boosted: its compactions go ahead of those of other column families until it gets back below
+    // the thresholds. Zero disables a threshold.
+    size_t _boost_sstable_count_threshold = 0;
+    size_t _boost_overlapping_sstables_threshold = 0;
+    // Minimum shares of the compaction scheduling group while a boosted compaction runs.
+    static constexpr float boosted_compaction_shares = 200;
 
     // Purpose is to serialize major compaction across all column families, so as to
     // reduce disk space requirement.
@@ -95,16 +123,26 @@ class compaction_manager {
 
     semaphore _resharding_sem{1};
 
+    // Serializes tombstone compactions across all column families.
+    semaphore _tombstone_compaction_sem{1};
+
     std::function<void()> compaction_submission_callback();
     // all registered column families are submitted for compaction at a constant interval.
     // Submission is a NO-OP when there's nothing to do, so it's fine to call it regularly.
     timer<lowres_clock> _compaction_submission_timer = timer<lowres_clock>(compaction_submission_callback());
     static constexpr std::chrono::seconds periodic_compaction_submission_interval() { return std::chrono::seconds(3600); }
+
+    std::function<void()> tombstone_compaction_submission_callback();
+    // all registered column families are checked for sstables worth rewriting to drop their
+    // tombstones at this interval, regardless of their compaction strategy. Zero disables it.
+    std::chrono::seconds _tombstone_compaction_check_interval = std::chrono::seconds(0);
+    timer<lowres_clock> _tombstone_compaction_timer = timer<lowres_clock>(tombstone_compaction_submission_callback());
 private:
     future<> task_stop(lw_shared_ptr<task> task);
 
-    // Return true if weight is not registered.
-    bool can_register_weight(column_family* cf, int weight) const;
+    // Return true if weight is not registered, or if the column family is boosted and doesn't
+    // run a compaction of this weight itself.
+    bool can_register_weight(column_family* cf, int weight, bool boosted = false) const;
     // Register weight for a column family. Do that only if can_register_weight()
     // returned true.
     void register_weight(int weight);
@@ -139,7 +177,26 @@ class compaction_manager {
     void reevaluate_postponed_compactions();
     // Postpone compaction for a column family that couldn't be executed due to ongoing
     // similar-sized compaction.
-    void postpone_compaction_for_column_family(column_family* cf);
+    void postpone_compaction_for_column_family(column_family* cf, int weight, bool boosted);
+
+    // The virtual time at which the next compaction job of a column family starts.
+    double compaction_start_tag(column_family* cf) const;
+    // Charge a column family for a compaction job of input_size bytes it's starting.
+    void charge_compaction(column_family* cf, uint64_t input_size);
+    // Return true if the weight should go to a postponed job of another column family instead.
+    bool must_yield_weight(column_family* cf, int weight, bool boosted) const;
+    // Return true if a column family crossed one of the boost thresholds.
+    bool needs_boost(const column_family& cf) const;
+    // Order in which postponed jobs are reevaluated: those of boosted column families first, then
+    // by start tag.
+    void order_postponed_compactions(std::vector<postponed_compaction>& postponed) const;
+
+    enum class job_admission { accepted, refused, yielded };
+    // Decides whether a regular compaction job may take its weight now. An accepted job is charged
+    // to its column family, a refused or yielded one is postponed.
+    job_admission admit_compaction_job(column_family* cf, int weight, bool boosted, uint64_t input_size);
+    // Registers a backlog which raises the shares of compaction while a boosted compaction runs.
+    lw_shared_ptr<compaction_backlog_tracker> make_boosted_backlog_tracker();
 
     compaction_controller _compaction_controller;
     compaction_backlog_manager _backlog_manager;
@@ -157,6 +214,14 @@ class compaction_manager {
 
     void register_metrics();
 
+    // Sets the sstable count, and the number of sstables overlapping one another, above which
+    // the compactions of a column family are boosted. Zero disables a threshold.
+    void set_compaction_boost_thresholds(size_t sstable_count, size_t overlapping_sstables);
+
+    // Sets the interval at which column families are checked for sstables worth a tombstone
+    // compaction. Zero disables the checks. Takes effect on start().
+    void set_tombstone_compaction_check_interval(std::chrono::seconds interval);
+
     // Start compaction manager.
     void start();
 
@@ -180,6 +245,16 @@ class compaction_manager {
     // Submit a column family for major compaction.
     future<> submit_major_compaction(column_family* cf);
 
+    // Sstables of a column family whose estimated ratio of droppable tombstones exceeds the
+    // tombstone_threshold of its compaction strategy, highest ratio first. An sstable is left
+    // out if an overlapping sstable may hold data older than its tombstones, as they couldn't
+    // be dropped then.
+    std::vector<sstables::shared_sstable> get_tombstone_compaction_candidates(const column_family& cf);
+
+    // Submit a column family for tombstone compaction, which rewrites each of its tombstone
+    // compaction candidates on its own, whatever the compaction strategy.
+    future<> submit_tombstone_compaction(column_family* cf);
+
     // Run a resharding job for a given column family.
     // it completes when future returned by job is ready or returns immediately
     // if manager was asked to stop.
@@ -235,5 +310,6 @@ class compaction_manager {
 
     friend class compacting_sstable_registration;
     friend class compaction_weight_registration;
+    friend class compaction_manager_test;
 };
 
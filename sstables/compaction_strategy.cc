@@ -56,6 +56,7 @@
 #include "date_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
 #include "sstables/compaction_backlog_manager.hh"
 #include "sstables/size_tiered_backlog_tracker.hh"
 #include "mutation_source_metadata.hh"
@@ -205,6 +206,30 @@ sstable_set::make_incremental_selector() const {
     return incremental_selector(_impl->make_incremental_selector(), *_schema);
 }
 
+size_t probe_filters(std::vector<shared_sstable>& sstables, utils::hashed_key hk) {
+    for (auto&& sst : sstables) {
+        sst->prefetch_filter(hk);
+    }
+    auto end = std::remove_if(sstables.begin(), sstables.end(), [hk] (const shared_sstable& sst) {
+        return !sst->filter_has_key(hk);
+    });
+    size_t removed = sstables.end() - end;
+    sstables.erase(end, sstables.end());
+    return removed;
+}
+
+bool any_filter_has_key(const std::vector<shared_sstable>& sstables, utils::hashed_key hk) {
+    for (auto&& sst : sstables) {
+        sst->prefetch_filter(hk);
+    }
+    for (auto&& sst : sstables) {
+        if (sst->filter_has_key(hk)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // default sstable_set, not specialized for anything
 class bag_sstable_set : public sstable_set_impl {
     // erasing is slow, but select() is fast
@@ -674,6 +699,10 @@ compaction_backlog_tracker& get_null_backlog_tracker() {
 //
 class null_compaction_strategy : public compaction_strategy_impl {
 public:
+    null_compaction_strategy() {
+        _disable_tombstone_compaction = true;
+    }
+
     virtual compaction_descriptor get_sstables_for_compaction(column_family& cfs, std::vector<sstables::shared_sstable> candidates) override {
         return sstables::compaction_descriptor();
     }
@@ -852,6 +881,14 @@ int64_t compaction_strategy::estimated_pending_compactions(column_family& cf) co
     return _compaction_strategy_impl->estimated_pending_compactions(cf);
 }
 
+bool compaction_strategy::worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point gc_before) const {
+    return _compaction_strategy_impl->worth_dropping_tombstones(sst, gc_before);
+}
+
+unsigned compaction_strategy::shares() const {
+    return _compaction_strategy_impl->shares();
+}
+
 bool compaction_strategy::use_clustering_key_filter() const {
     return _compaction_strategy_impl->use_clustering_key_filter();
 }
@@ -895,6 +932,9 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = make_shared<time_window_compaction_strategy>(time_window_compaction_strategy(options));
         break;
+    case compaction_strategy_type::incremental:
+        impl = make_shared<incremental_compaction_strategy>(incremental_compaction_strategy(options));
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
@@ -39,14 +39,18 @@ class compaction_strategy_impl {
     static constexpr float DEFAULT_TOMBSTONE_THRESHOLD = 0.2f;
     // minimum interval needed to perform tombstone removal compaction in seconds, default 86400 or 1 day.
     static constexpr std::chrono::seconds DEFAULT_TOMBSTONE_COMPACTION_INTERVAL() { return std::chrono::seconds(86400); }
+    static constexpr unsigned DEFAULT_SHARES = 100;
+    static constexpr unsigned MAX_SHARES = 1000;
 protected:
     const sstring TOMBSTONE_THRESHOLD_OPTION = "tombstone_threshold";
     const sstring TOMBSTONE_COMPACTION_INTERVAL_OPTION = "tombstone_compaction_interval";
+    const sstring SHARES_OPTION = "shares";
 
     bool _use_clustering_key_filter = false;
     bool _disable_tombstone_compaction = false;
     float _tombstone_threshold = DEFAULT_TOMBSTONE_THRESHOLD;
     db_clock::duration _tombstone_compaction_interval = DEFAULT_TOMBSTONE_COMPACTION_INTERVAL();
+    unsigned _shares = DEFAULT_SHARES;
 public:
     static std::optional<sstring> get_value(const std::map<sstring, sstring>& options, const sstring& name) {
         auto it = options.find(name);
@@ -67,6 +71,13 @@ class compaction_strategy_impl {
         auto interval = property_definitions::to_long(TOMBSTONE_COMPACTION_INTERVAL_OPTION, tmp_value, DEFAULT_TOMBSTONE_COMPACTION_INTERVAL().count());
         _tombstone_compaction_interval = db_clock::duration(std::chrono::seconds(interval));
 
+        tmp_value = get_value(options, SHARES_OPTION);
+        auto shares = property_definitions::to_long(SHARES_OPTION, tmp_value, DEFAULT_SHARES);
+        if (shares < 1 || shares > MAX_SHARES) {
+            throw exceptions::configuration_exception(format("{} must be between 1 and {}, but was {}", SHARES_OPTION, MAX_SHARES, shares));
+        }
+        _shares = shares;
+
         // FIXME: validate options.
     }
 public:
@@ -86,6 +97,10 @@ class compaction_strategy_impl {
         return _use_clustering_key_filter;
     }
 
+    unsigned shares() const {
+        return _shares;
+    }
+
     virtual bool can_compact_partial_runs() const {
         return false;
     }
@@ -27,6 +27,7 @@
 #include <seastar/core/bitops.hh>
 #include <seastar/core/byteorder.hh>
 #include <seastar/core/fstream.hh>
+#include <seastar/core/future-util.hh>
 
 #include "../compress.hh"
 #include "compress.hh"
@@ -265,7 +266,7 @@ local_compression::local_compression(compressor_ptr p)
 local_compression::local_compression(const compression& c)
     : _compressor([&c] {
         sstring n(c.name.value.begin(), c.name.value.end());
-        return compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
+        auto p = compressor::create(n, [&c, &n](const sstring& key) -> compressor::opt_string {
             if (key == compression_parameters::CHUNK_LENGTH_KB || key == compression_parameters::CHUNK_LENGTH_KB_ERR) {
                 return to_sstring(c.chunk_len / 1024);
             }
@@ -279,6 +280,10 @@ local_compression::local_compression(const compression& c)
             }
             return std::nullopt;
         });
+        if (p && !c.dictionary().empty()) {
+            p = p->with_dictionary(c.dictionary());
+        }
+        return p;
     }())
 {}
 
@@ -358,10 +363,10 @@ class compressed_file_data_source_impl : public data_source_impl {
     uint64_t _end_pos;
 public:
     compressed_file_data_source_impl(file f, sstables::compression* cm,
-                uint64_t pos, size_t len, file_input_stream_options options)
+                uint64_t pos, size_t len, file_input_stream_options options, compressor_ptr c)
             : _compression_metadata(cm)
             , _offsets(_compression_metadata->offsets.get_accessor())
-            , _compression(*cm)
+            , _compression(c ? sstables::local_compression(std::move(c)) : sstables::local_compression(*cm))
     {
         _beg_pos = pos;
         if (pos > _compression_metadata->uncompressed_file_length()) {
@@ -459,9 +464,9 @@ GCC6_CONCEPT(
 class compressed_file_data_source : public data_source {
 public:
     compressed_file_data_source(file f, sstables::compression* cm,
-            uint64_t offset, size_t len, file_input_stream_options options)
+            uint64_t offset, size_t len, file_input_stream_options options, compressor_ptr c)
         : data_source(std::make_unique<compressed_file_data_source_impl<ChecksumType>>(
-                std::move(f), cm, offset, len, std::move(options)))
+                std::move(f), cm, offset, len, std::move(options), std::move(c)))
         {}
 };
 
@@ -471,10 +476,10 @@ GCC6_CONCEPT(
 )
 inline input_stream<char> make_compressed_file_input_stream(
         file f, sstables::compression *cm, uint64_t offset, size_t len,
-        file_input_stream_options options)
+        file_input_stream_options options, compressor_ptr c)
 {
     return input_stream<char>(compressed_file_data_source<ChecksumType>(
-            std::move(f), cm, offset, len, std::move(options)));
+            std::move(f), cm, offset, len, std::move(options), std::move(c)));
 }
 
 // For SSTables 2.x (formats 'ka' and 'la'), the full checksum is a combination of checksums of compressed chunks.
@@ -499,17 +504,82 @@ class compressed_file_data_sink_impl : public data_sink_impl {
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
+    // Chunks held back until a dictionary is trained on them.
+    std::vector<temporary_buffer<char>> _samples;
+    size_t _sample_size = 0;
+    size_t _wanted_sample_size = 0;
 public:
-    compressed_file_data_sink_impl(file f, sstables::compression* cm, sstables::local_compression lc, file_output_stream_options options)
+    compressed_file_data_sink_impl(file f, sstables::compression* cm, sstables::local_compression lc, file_output_stream_options options,
+                bool train_dictionary)
             : _out(make_file_output_stream(std::move(f), options))
             , _compression_metadata(cm)
             , _offsets(_compression_metadata->offsets.get_writer())
             , _compression(lc)
             , _full_checksum(ChecksumType::init_checksum())
-    {}
+    {
+        auto& c = _compression.compressor();
+        if (train_dictionary && c && c->dictionary_size() && c->dictionary().empty()) {
+            _wanted_sample_size = std::min(c->dictionary_size() * compressor::dictionary_sample_ratio,
+                    compressor::max_dictionary_sample_size);
+        }
+    }
 
     future<> put(net::packet data) { abort(); }
     virtual future<> put(temporary_buffer<char> buf) override {
+        if (_wanted_sample_size) {
+            _sample_size += buf.size();
+            _samples.push_back(std::move(buf));
+            if (_sample_size < _wanted_sample_size) {
+                return make_ready_future<>();
+            }
+            return flush_samples();
+        }
+        return do_put(std::move(buf));
+    }
+    virtual future<> close() override {
+        return flush_samples().then([this] {
+            return _out.close();
+        });
+    }
+private:
+    // Trains the dictionary on the chunks held back and writes them out.
+    future<> flush_samples() {
+        if (!_wanted_sample_size) {
+            return make_ready_future<>();
+        }
+        _wanted_sample_size = 0;
+        try {
+            train_dictionary();
+        } catch (...) {
+            return make_exception_future<>(std::current_exception());
+        }
+        return do_for_each(_samples, [this] (temporary_buffer<char>& buf) {
+            return do_put(std::move(buf));
+        }).then([this] {
+            _samples.clear();
+        });
+    }
+
+    void train_dictionary() {
+        bytes samples(bytes::initialized_later(), _sample_size);
+        std::vector<size_t> sample_sizes;
+        sample_sizes.reserve(_samples.size());
+        auto out = samples.begin();
+        for (auto&& buf : _samples) {
+            out = std::copy_n(buf.get(), buf.size(), out);
+            sample_sizes.push_back(buf.size());
+        }
+        auto& c = _compression.compressor();
+        auto dict = c->train_dictionary(samples, sample_sizes);
+        if (dict.empty()) {
+            // Compress without a dictionary.
+            return;
+        }
+        _compression = sstables::local_compression(c->with_dictionary(dict));
+        _compression_metadata->set_dictionary(std::move(dict));
+    }
+
+    future<> do_put(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -549,9 +619,6 @@ class compressed_file_data_sink_impl : public data_sink_impl {
         auto f = _out.write(compressed.get(), compressed.size());
         return f.then([compressed = std::move(compressed)] {});
     }
-    virtual future<> close() override {
-        return _out.close();
-    }
 };
 
 template <typename ChecksumType, compressed_checksum_mode mode>
@@ -560,9 +627,10 @@ GCC6_CONCEPT(
 )
 class compressed_file_data_sink : public data_sink {
 public:
-    compressed_file_data_sink(file f, sstables::compression* cm, sstables::local_compression lc, file_output_stream_options options)
+    compressed_file_data_sink(file f, sstables::compression* cm, sstables::local_compression lc, file_output_stream_options options,
+            bool train_dictionary)
         : data_sink(std::make_unique<compressed_file_data_sink_impl<ChecksumType, mode>>(
-                std::move(f), cm, std::move(lc), options)) {}
+                std::move(f), cm, std::move(lc), options, train_dictionary)) {}
 };
 
 template <typename ChecksumType, compressed_checksum_mode mode>
@@ -571,12 +639,20 @@ GCC6_CONCEPT(
 )
 inline output_stream<char> make_compressed_file_output_stream(file f, file_output_stream_options options,
          sstables::compression* cm,
-         const compression_parameters& cp) {
+         const compression_parameters& cp,
+         compressor_ptr dictionary_compressor,
+         bool use_dictionary) {
     // buffer of output stream is set to chunk length, because flush must
     // happen every time a chunk was filled up.
 
     auto p = cp.get_compressor();
     cm->set_compressor(p);
+    if (use_dictionary && p && p->dictionary_size() && dictionary_compressor
+            && dictionary_compressor->name() == p->name() && dictionary_compressor->options() == p->options()) {
+        auto dict = dictionary_compressor->dictionary();
+        cm->set_dictionary(bytes(dict.begin(), dict.end()));
+        p = std::move(dictionary_compressor);
+    }
     cm->set_uncompressed_chunk_length(cp.chunk_length());
     // FIXME: crc_check_chance can be configured by the user.
     // probability to verify the checksum of a compressed chunk we read.
@@ -584,35 +660,39 @@ inline output_stream<char> make_compressed_file_output_stream(file f, file_outpu
     cm->options.elements.push_back({"crc_check_chance", "1.0"});
 
     auto outer_buffer_size = cm->uncompressed_chunk_length();
-    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(f), cm, p, options), outer_buffer_size, true);
+    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(f), cm, p, options, use_dictionary),
+            outer_buffer_size, true);
 }
 
 input_stream<char> sstables::make_compressed_file_k_l_format_input_stream(file f,
         sstables::compression* cm, uint64_t offset, size_t len,
-        class file_input_stream_options options)
+        class file_input_stream_options options, compressor_ptr compressor)
 {
-    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options));
+    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options), std::move(compressor));
 }
 
 output_stream<char> sstables::make_compressed_file_k_l_format_output_stream(file f,
         file_output_stream_options options,
         sstables::compression* cm,
-        const compression_parameters& cp) {
+        const compression_parameters& cp,
+        compressor_ptr dictionary_compressor,
+        bool use_dictionary) {
     return make_compressed_file_output_stream<adler32_utils, compressed_checksum_mode::checksum_chunks_only>(
-            std::move(f), std::move(options), cm, cp);
+            std::move(f), std::move(options), cm, cp, std::move(dictionary_compressor), use_dictionary);
 }
 
 input_stream<char> sstables::make_compressed_file_m_format_input_stream(file f,
         sstables::compression *cm, uint64_t offset, size_t len,
-        class file_input_stream_options options) {
-    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options));
+        class file_input_stream_options options, compressor_ptr compressor) {
+    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options), std::move(compressor));
 }
 
 output_stream<char> sstables::make_compressed_file_m_format_output_stream(file f,
         file_output_stream_options options,
         sstables::compression* cm,
-        const compression_parameters& cp) {
+        const compression_parameters& cp,
+        compressor_ptr dictionary_compressor,
+        bool use_dictionary) {
     return make_compressed_file_output_stream<crc32_utils, compressed_checksum_mode::checksum_all>(
-            std::move(f), std::move(options), cm, cp);
+            std::move(f), std::move(options), cm, cp, std::move(dictionary_compressor), use_dictionary);
 }
-
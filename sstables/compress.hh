@@ -307,6 +307,8 @@ struct compression {
     // Variables *not* found in the "Compression Info" file (added by update()):
     uint64_t _compressed_file_length = 0;
     uint32_t _full_checksum = 0;
+    // Dictionary used for all chunks, stored in the Scylla component.
+    bytes _dictionary;
 public:
     // Set the compressor algorithm, please check the definition of enum compressor.
     void set_compressor(compressor_ptr c);
@@ -356,6 +358,15 @@ struct compression {
         _compressed_file_length = compressed_file_length;
     }
 
+    // Empty if chunks are compressed without a dictionary.
+    bytes_view dictionary() const {
+        return _dictionary;
+    }
+
+    void set_dictionary(bytes dictionary) {
+        _dictionary = std::move(dictionary);
+    }
+
     uint32_t get_full_checksum() const {
         return _full_checksum;
     }
@@ -367,7 +378,8 @@ struct compression {
     friend class sstable;
 };
 
-// for API query only. Free function just to distinguish it from an accessor in compression
+// Free function just to distinguish it from an accessor in compression.
+// The returned compressor uses the sstable's dictionary, if any.
 compressor_ptr get_sstable_compressor(const compression&);
 
 // Note: compression_metadata is passed by reference; The caller is
@@ -375,23 +387,39 @@ compressor_ptr get_sstable_compressor(const compression&);
 // are open streams on it. This should happen naturally on a higher level -
 // as long as we have *sstables* work in progress, we need to keep the whole
 // sstable alive, and the compression metadata is only a part of it.
+//
+// If a compressor is passed to the input streams, it is used instead of
+// creating a new one from the compression metadata. It must be the result
+// of get_sstable_compressor() for the same metadata.
+//
+// If the compressor from compression parameters wants a dictionary (see
+// compressor::dictionary_size()), output streams use dictionary_compressor
+// when it is compatible with the parameters, otherwise they train a new
+// dictionary from the first chunks written. The dictionary is stored in
+// the compression metadata.
 input_stream<char> make_compressed_file_k_l_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options);
+                class file_input_stream_options options,
+                compressor_ptr compressor = {});
 
 output_stream<char> make_compressed_file_k_l_format_output_stream(file f,
                 file_output_stream_options options,
                 sstables::compression* cm,
-                const compression_parameters& cp);
+                const compression_parameters& cp,
+                compressor_ptr dictionary_compressor = {},
+                bool use_dictionary = false);
 
 input_stream<char> make_compressed_file_m_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options);
+                class file_input_stream_options options,
+                compressor_ptr compressor = {});
 
 output_stream<char> make_compressed_file_m_format_output_stream(file f,
                 file_output_stream_options options,
                 sstables::compression* cm,
-                const compression_parameters& cp);
+                const compression_parameters& cp,
+                compressor_ptr dictionary_compressor = {},
+                bool use_dictionary = false);
 
 }
 
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "incremental_compaction_strategy.hh"
+#include "sstables/compaction_backlog_manager.hh"
+#include "exceptions/exceptions.hh"
+#include <boost/range/adaptors.hpp>
+#include <boost/range/algorithm.hpp>
+#include <boost/range/numeric.hpp>
+#include <cmath>
+
+namespace sstables {
+
+// The backlog of STCS, see size_tiered_backlog_tracker.hh, with runs in place of sstables:
+// a run of size Si will take part in about log4(T / Si) more compactions, no matter how many
+// fragments it's made of.
+class incremental_backlog_tracker final : public compaction_backlog_tracker::impl {
+    int64_t _total_bytes = 0;
+    std::unordered_map<utils::UUID, int64_t> _run_bytes;
+
+    static double log4(double x) {
+        static constexpr double inv_log_4 = 1.0f / std::log(4);
+        return log(x) * inv_log_4;
+    }
+public:
+    virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override {
+        auto total_bytes = _total_bytes;
+        std::unordered_map<utils::UUID, int64_t> compacted_bytes;
+        for (auto const& crp : oc) {
+            auto compacted = crp.second->compacted();
+            compacted_bytes[crp.first->run_identifier()] += compacted;
+            total_bytes -= compacted;
+        }
+        // Sstables being written don't know their run yet, so each is taken as a run of its own.
+        for (auto const& swp : ow) {
+            total_bytes += swp.second->written();
+        }
+        if (total_bytes <= 0) {
+            return 0;
+        }
+
+        double b = 0;
+        for (auto const& run : _run_bytes) {
+            auto it = compacted_bytes.find(run.first);
+            auto effective_bytes = run.second - (it != compacted_bytes.end() ? it->second : 0);
+            if (run.second > 0 && effective_bytes > 0) {
+                b += effective_bytes * log4(double(total_bytes) / run.second);
+            }
+        }
+        for (auto const& swp : ow) {
+            auto written = swp.second->written();
+            if (written > 0) {
+                b += written * log4(double(total_bytes) / written);
+            }
+        }
+        return b > 0 ? b : 0;
+    }
+
+    virtual void add_sstable(sstables::shared_sstable sst) override {
+        if (sst->data_size() > 0) {
+            _total_bytes += sst->data_size();
+            _run_bytes[sst->run_identifier()] += sst->data_size();
+        }
+    }
+
+    virtual void remove_sstable(sstables::shared_sstable sst) override {
+        if (sst->data_size() > 0) {
+            _total_bytes -= sst->data_size();
+            auto it = _run_bytes.find(sst->run_identifier());
+            if (it != _run_bytes.end() && (it->second -= sst->data_size()) <= 0) {
+                _run_bytes.erase(it);
+            }
+        }
+    }
+};
+
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _stcs_options(options)
+    , _backlog_tracker(std::make_unique<incremental_backlog_tracker>())
+{
+    using namespace cql3::statements;
+    auto tmp_value = compaction_strategy_impl::get_value(options, FRAGMENT_SIZE_OPTION);
+    auto fragment_size_in_mb = property_definitions::to_long(FRAGMENT_SIZE_OPTION, tmp_value, DEFAULT_FRAGMENT_SIZE_IN_MB);
+    if (fragment_size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("{} must be greater than 0, but was {}", FRAGMENT_SIZE_OPTION, fragment_size_in_mb));
+    }
+    _fragment_size = uint64_t(fragment_size_in_mb) * 1024 * 1024;
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::get_runs(const std::vector<shared_sstable>& sstables) {
+    std::unordered_map<utils::UUID, sstable_run> runs;
+    for (auto& sst : sstables) {
+        runs[sst->run_identifier()].insert(sst);
+    }
+    return boost::copy_range<std::vector<sstable_run>>(runs | boost::adaptors::map_values);
+}
+
+std::vector<std::vector<sstable_run>>
+incremental_compaction_strategy::get_buckets(const std::vector<sstable_run>& runs) const {
+    auto sorted_runs = runs;
+    std::sort(sorted_runs.begin(), sorted_runs.end(), [] (const sstable_run& i, const sstable_run& j) {
+        return i.data_size() < j.data_size();
+    });
+
+    std::map<uint64_t, std::vector<sstable_run>> buckets;
+    for (auto& run : sorted_runs) {
+        bool found = false;
+        uint64_t size = run.data_size();
+
+        // Same as STCS: a run goes to a bucket if it's within the bucket's bounds of the average
+        // size of the bucket, or if both are considered small.
+        for (auto it = buckets.begin(); it != buckets.end(); it++) {
+            uint64_t old_average_size = it->first;
+
+            if ((size > (old_average_size * _stcs_options.bucket_low) && size < (old_average_size * _stcs_options.bucket_high)) ||
+                    (size < _stcs_options.min_sstable_size && old_average_size < _stcs_options.min_sstable_size)) {
+                auto bucket = std::move(it->second);
+                uint64_t total_size = bucket.size() * old_average_size;
+                uint64_t new_average_size = (total_size + size) / (bucket.size() + 1);
+
+                bucket.push_back(run);
+                buckets.erase(it);
+                buckets.insert({ new_average_size, std::move(bucket) });
+
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            buckets.insert({ size, std::vector<sstable_run>{ run } });
+        }
+    }
+
+    return boost::copy_range<std::vector<std::vector<sstable_run>>>(buckets | boost::adaptors::map_values);
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets,
+        size_t min_threshold, size_t max_threshold) const {
+    std::vector<sstable_run>* min = nullptr;
+    uint64_t min_avg = 0;
+    for (auto& bucket : buckets) {
+        if (bucket.size() > max_threshold) {
+            bucket.resize(max_threshold);
+        }
+        if (bucket.size() < min_threshold) {
+            continue;
+        }
+        auto avg = boost::accumulate(bucket | boost::adaptors::transformed(std::mem_fn(&sstable_run::data_size)), uint64_t(0)) / bucket.size();
+        if (!min || avg < min_avg) {
+            min = &bucket;
+            min_avg = avg;
+        }
+    }
+    return min ? std::move(*min) : std::vector<sstable_run>();
+}
+
+compaction_descriptor incremental_compaction_strategy::make_descriptor(const std::vector<sstable_run>& runs) const {
+    std::vector<shared_sstable> sstables;
+    for (auto& run : runs) {
+        sstables.insert(sstables.end(), run.all().begin(), run.all().end());
+    }
+    return compaction_descriptor(std::move(sstables), compaction_descriptor::default_level, _fragment_size);
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(column_family& cf, std::vector<shared_sstable> candidates) {
+    size_t min_threshold = cf.schema()->min_compaction_threshold();
+    size_t max_threshold = cf.schema()->max_compaction_threshold();
+    auto gc_before = gc_clock::now() - cf.schema()->gc_grace_seconds();
+
+    // Candidates never include part of a run, as the compaction manager keeps out all fragments
+    // of a run which is being compacted or written.
+    auto buckets = get_buckets(get_runs(candidates));
+
+    auto most_interesting = most_interesting_bucket(buckets, min_threshold, max_threshold);
+    if (most_interesting.empty() && !cf.compaction_enforce_min_threshold()) {
+        most_interesting = most_interesting_bucket(buckets, 2, max_threshold);
+    }
+    if (!most_interesting.empty()) {
+        return make_descriptor(most_interesting);
+    }
+
+    // Like STCS, fall back to compacting a single fragment whose droppable tombstone ratio
+    // is greater than the threshold, preferring the oldest one of the biggest tiers. The
+    // output takes its place in its run, which it doesn't overlap.
+    for (auto& bucket : buckets | boost::adaptors::reversed) {
+        std::vector<shared_sstable> sstables;
+        for (auto& run : bucket) {
+            boost::copy(run.all() | boost::adaptors::filtered([this, &gc_before] (const shared_sstable& sst) {
+                return worth_dropping_tombstones(sst, gc_before);
+            }), std::back_inserter(sstables));
+        }
+        if (sstables.empty()) {
+            continue;
+        }
+        auto it = std::min_element(sstables.begin(), sstables.end(), [] (auto& i, auto& j) {
+            return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
+        });
+        return compaction_descriptor({ *it }, compaction_descriptor::default_level, _fragment_size, (*it)->run_identifier());
+    }
+    return compaction_descriptor();
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(column_family& cf, std::vector<shared_sstable> candidates) {
+    if (candidates.empty()) {
+        return compaction_descriptor();
+    }
+    return make_descriptor(get_runs(candidates));
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(column_family& cf) const {
+    size_t min_threshold = cf.schema()->min_compaction_threshold();
+    size_t max_threshold = cf.schema()->max_compaction_threshold();
+    std::vector<shared_sstable> sstables;
+    int64_t n = 0;
+
+    sstables.reserve(cf.sstables_count());
+    for (auto& entry : *cf.get_sstables()) {
+        sstables.push_back(entry);
+    }
+
+    for (auto& bucket : get_buckets(get_runs(sstables))) {
+        if (bucket.size() >= min_threshold) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "sstable_set.hh"
+
+namespace sstables {
+
+// Incremental compaction strategy (ICS).
+//
+// Tiers sstable runs, rather than sstables, by size the way STCS does, and writes
+// the output of every compaction as a run of fragments of a fixed size. Inputs
+// are then runs of many fragments, so compaction replaces each input fragment by
+// the output as soon as the merge moves past its last key, and deletes it. The
+// temporary space needed by a compaction is thus bounded by a few fragments per
+// input run, instead of the size of the whole input as with STCS.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+    static constexpr uint64_t DEFAULT_FRAGMENT_SIZE_IN_MB = 1000;
+    const sstring FRAGMENT_SIZE_OPTION = "sstable_size_in_mb";
+
+    uint64_t _fragment_size = DEFAULT_FRAGMENT_SIZE_IN_MB * 1024 * 1024;
+    size_tiered_compaction_strategy_options _stcs_options;
+    compaction_backlog_tracker _backlog_tracker;
+
+    // Group runs of similar size into buckets.
+    std::vector<std::vector<sstable_run>> get_buckets(const std::vector<sstable_run>& runs) const;
+
+    // Maybe return the bucket with the smallest runs among those which have at least min_threshold runs,
+    // trimmed to max_threshold runs.
+    std::vector<sstable_run> most_interesting_bucket(std::vector<std::vector<sstable_run>> buckets,
+            size_t min_threshold, size_t max_threshold) const;
+
+    compaction_descriptor make_descriptor(const std::vector<sstable_run>& runs) const;
+public:
+    incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    // Group sstables into the runs they belong to.
+    static std::vector<sstable_run> get_runs(const std::vector<shared_sstable>& sstables);
+
+    virtual compaction_descriptor get_sstables_for_compaction(column_family& cf, std::vector<shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(column_family& cf, std::vector<shared_sstable> candidates) override;
+
+    virtual int64_t estimated_pending_compactions(column_family& cf) const override;
+
+    virtual compaction_strategy_type type() const {
+        return compaction_strategy_type::incremental;
+    }
+
+    virtual compaction_backlog_tracker& get_backlog_tracker() override {
+        return _backlog_tracker;
+    }
+};
+
+}
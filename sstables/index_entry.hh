@@ -506,26 +506,32 @@ class promoted_index_blocks_reader : public data_consumer::continuous_data_consu
 
 class promoted_index {
     deletion_time _del_time;
+    uint64_t _promoted_index_start;
     uint32_t _promoted_index_size;
     promoted_index_blocks_reader _reader;
     bool _reader_closed = false;
 
 public:
     promoted_index(const schema& s, reader_permit permit, deletion_time del_time, input_stream<char>&& promoted_index_stream,
-                   uint32_t promoted_index_size, uint32_t blocks_count)
+                   uint64_t promoted_index_start, uint32_t promoted_index_size, uint32_t blocks_count)
             : _del_time{del_time}
+            , _promoted_index_start(promoted_index_start)
             , _promoted_index_size(promoted_index_size)
             , _reader{std::move(permit), std::move(promoted_index_stream), blocks_count, s, 0, promoted_index_size}
     {}
 
     promoted_index(const schema& s, reader_permit permit, deletion_time del_time, input_stream<char>&& promoted_index_stream,
-                   uint32_t promoted_index_size, uint32_t blocks_count, column_values_fixed_lengths clustering_values_fixed_lengths)
+                   uint64_t promoted_index_start, uint32_t promoted_index_size, uint32_t blocks_count,
+                   column_values_fixed_lengths clustering_values_fixed_lengths)
             : _del_time{del_time}
+            , _promoted_index_start(promoted_index_start)
             , _promoted_index_size(promoted_index_size)
             , _reader{std::move(permit), std::move(promoted_index_stream), blocks_count, s, 0, promoted_index_size, std::move(clustering_values_fixed_lengths)}
     {}
 
     [[nodiscard]] deletion_time get_deletion_time() const { return _del_time; }
+    // Position of the promoted index blocks in the index file
+    [[nodiscard]] uint64_t get_promoted_index_start() const { return _promoted_index_start; }
     [[nodiscard]] uint32_t get_promoted_index_size() const { return _promoted_index_size; }
     [[nodiscard]] promoted_index_blocks_reader& get_reader() { return _reader; };
     [[nodiscard]] const promoted_index_blocks_reader& get_reader() const { return _reader; };
@@ -575,6 +581,8 @@ class index_entry {
 
     uint32_t get_promoted_index_size() const { return _index ? _index->get_promoted_index_size() : 0; }
 
+    uint64_t get_promoted_index_start() const { return _index ? _index->get_promoted_index_start() : 0; }
+
     index_entry(temporary_buffer<char>&& key, uint64_t position, std::unique_ptr<promoted_index>&& index)
         : _key(std::move(key))
         , _position(position)
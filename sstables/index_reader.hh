@@ -24,7 +24,9 @@
 #include "consumer.hh"
 #include "downsampling.hh"
 #include "sstables/shared_index_lists.hh"
+#include "sstables/partition_index_cache.hh"
 #include <seastar/util/bool_class.hh>
+#include <seastar/core/align.hh>
 #include "utils/buffer_input_stream.hh"
 #include "sstables/prepended_input_stream.hh"
 #include "tracing/traced_file.hh"
@@ -187,7 +189,8 @@ class index_consume_entry_context : public data_consumer::continuous_data_consum
             }
         state_CONSUME_ENTRY:
         case state::CONSUME_ENTRY: {
-            auto promoted_index_size = _promoted_index_end - current_pos();
+            auto promoted_index_start = current_pos();
+            auto promoted_index_size = _promoted_index_end - promoted_index_start;
             if (_deletion_time) {
                 _num_pi_blocks = get_uint32();
             }
@@ -210,11 +213,11 @@ class index_consume_entry_context : public data_consumer::continuous_data_consum
             if (promoted_index_stream) {
                 if (is_mc_format()) {
                     index = std::make_unique<promoted_index>(_s, continuous_data_consumer::_permit, *_deletion_time, std::move(*promoted_index_stream),
-                                  promoted_index_size,
+                                  promoted_index_start, promoted_index_size,
                                   _num_pi_blocks, *_ck_values_fixed_lengths);
                 } else {
                      index = std::make_unique<promoted_index>(_s, continuous_data_consumer::_permit, *_deletion_time, std::move(*promoted_index_stream),
-                                   promoted_index_size, _num_pi_blocks);
+                                   promoted_index_start, promoted_index_size, _num_pi_blocks);
                 }
             }
             _consumer.consume_entry(index_entry{std::move(_key), _position, std::move(index)}, _entry_offset);
@@ -354,6 +357,11 @@ class index_reader {
     // Upper bound may remain uninitialized
     std::optional<index_bound> _upper_bound;
 
+    // Read-ahead of the page following the one of the lower bound, started
+    // when the lower bound is advanced sequentially. Never fails.
+    std::optional<future<>> _read_ahead;
+    uint64_t _read_ahead_summary_idx = 0;
+
 private:
     void advance_to_end(index_bound& bound) {
         sstlog.trace("index {}: advance_to_end() bound {}", this, &bound);
@@ -378,36 +386,8 @@ class index_reader {
             advance_to_end(bound);
             return make_ready_future<>();
         }
-        auto loader = [this] (uint64_t summary_idx) -> future<index_list> {
-            auto& summary = _sstable->get_summary();
-            uint64_t position = summary.entries[summary_idx].position;
-            uint64_t quantity = downsampling::get_effective_index_interval_after_index(summary_idx, summary.header.sampling_level,
-                summary.header.min_index_interval);
-
-            uint64_t end;
-            if (summary_idx + 1 >= summary.header.size) {
-                end = _sstable->index_size();
-            } else {
-                end = summary.entries[summary_idx + 1].position;
-            }
-
-            return do_with(std::make_unique<reader>(_sstable, _permit, _pc, _trace_state, position, end, quantity), [this, summary_idx] (auto& entries_reader) {
-                return entries_reader->_context.consume_input().then_wrapped([this, summary_idx, &entries_reader] (future<> f) {
-                    std::exception_ptr ex;
-                    if (f.failed()) {
-                        ex = f.get_exception();
-                        sstlog.error("failed reading index for {}: {}", _sstable->get_filename(), ex);
-                    }
-                    auto indexes = std::move(entries_reader->_consumer.indexes);
-                    return entries_reader->_context.close().then([indexes = std::move(indexes), ex = std::move(ex)] () mutable {
-                        if (ex) {
-                            std::rethrow_exception(std::move(ex));
-                        }
-                        return std::move(indexes);
-                    });
-
-                });
-            });
+        auto loader = [this] (uint64_t summary_idx) {
+            return load_page(summary_idx);
         };
 
         return _index_lists.get_or_load(summary_idx, loader).then([this, &bound, summary_idx] (shared_index_lists::list_ptr ref) {
@@ -433,6 +413,169 @@ class index_reader {
         });
     }
 
+    // Loads a page of the partition index, from the sstable's index page cache if possible.
+    future<index_list> load_page(uint64_t summary_idx) {
+        auto& cache = _sstable->_index_cache;
+        if (cache.enabled()) {
+            if (auto read = cache.wait_for_read(summary_idx)) {
+                sstlog.trace("index {}: waiting for read of page {}", this, summary_idx);
+                return read->then([this, summary_idx] {
+                    return load_page(summary_idx);
+                });
+            }
+            if (const cached_index_page* page = cache.find(summary_idx)) {
+                sstlog.trace("index {}: page {} found in cache", this, summary_idx);
+                return make_ready_future<index_list>(materialize_page(*page));
+            }
+        }
+        return read_page(_sstable, _permit, _pc, _trace_state, summary_idx);
+    }
+
+    // Reads and parses a page of the partition index from the index file.
+    // Doesn't reference the index_reader, so it may outlive it.
+    //
+    // Concurrent lookups of the page in other index_readers of the sstable
+    // wait for this read instead of issuing their own.
+    static future<index_list> read_page(shared_sstable sst, reader_permit permit, const io_priority_class& pc,
+            tracing::trace_state_ptr trace_state, uint64_t summary_idx) {
+        auto& summary = sst->get_summary();
+        uint64_t position = summary.entries[summary_idx].position;
+        uint64_t quantity = downsampling::get_effective_index_interval_after_index(summary_idx, summary.header.sampling_level,
+            summary.header.min_index_interval);
+
+        uint64_t end;
+        if (summary_idx + 1 >= summary.header.size) {
+            end = sst->index_size();
+        } else {
+            end = summary.entries[summary_idx + 1].position;
+        }
+
+        auto entries_reader = std::make_unique<reader>(sst, std::move(permit), pc, std::move(trace_state), position, end, quantity);
+        sst->_index_cache.on_read_started(summary_idx);
+        auto f = do_with(std::move(entries_reader), [sst, summary_idx] (auto& entries_reader) {
+            return entries_reader->_context.consume_input().then_wrapped([sst, summary_idx, &entries_reader] (future<> f) {
+                std::exception_ptr ex;
+                if (f.failed()) {
+                    ex = f.get_exception();
+                    sstlog.error("failed reading index for {}: {}", sst->get_filename(), ex);
+                }
+                auto indexes = std::move(entries_reader->_consumer.indexes);
+                return entries_reader->_context.close().then([sst, summary_idx, indexes = std::move(indexes), ex = std::move(ex)] () mutable {
+                    if (ex) {
+                        std::rethrow_exception(std::move(ex));
+                    }
+                    populate_cache(*sst, summary_idx, indexes);
+                    return std::move(indexes);
+                });
+
+            });
+        });
+        return f.finally([sst = std::move(sst), summary_idx] {
+            sst->_index_cache.on_read_finished(summary_idx);
+        });
+    }
+
+    // Reads the given page into the sstable's index page cache in the background,
+    // so that a sequential scan finds it there instead of waiting for the index
+    // file when it crosses the page boundary.
+    //
+    // At most one page is read ahead at a time. The read-ahead doesn't reference
+    // the index_reader, so it may be abandoned by destroying the reader, but
+    // close() waits for it.
+    void read_ahead_page(uint64_t summary_idx) {
+        auto& cache = _sstable->_index_cache;
+        if (!cache.enabled() || summary_idx >= _sstable->get_summary().header.size) {
+            return;
+        }
+        if (_read_ahead && (_read_ahead_summary_idx >= summary_idx || !_read_ahead->available())) {
+            return;
+        }
+        if (cache.contains(summary_idx) || cache.is_being_read(summary_idx)) {
+            return;
+        }
+        sstlog.trace("index {}: read ahead page {}", this, summary_idx);
+        cache.on_read_ahead();
+        _read_ahead_summary_idx = summary_idx;
+        _read_ahead = read_page(_sstable, _permit, _pc, _trace_state, summary_idx).then([] (index_list indexes) {
+            return do_with(std::move(indexes), [] (index_list& indexes) {
+                return parallel_for_each(indexes, [] (index_entry& ie) {
+                    return ie.close_pi_stream();
+                });
+            });
+        }).handle_exception([sst = _sstable, summary_idx] (std::exception_ptr ep) {
+            // The page will be read again when the scan gets to it.
+            sstlog.debug("failed to read ahead index page {} of {}: {}", summary_idx, sst->get_filename(), ep);
+        });
+    }
+
+    // Stores a reader-independent copy of the page in the sstable's partition index cache.
+    static void populate_cache(sstable& sst, uint64_t summary_idx, const index_list& indexes) {
+        auto& cache = sst._index_cache;
+        if (!cache.enabled() || indexes.empty()) {
+            return;
+        }
+        size_t keys_size = 0;
+        for (const index_entry& e : indexes) {
+            keys_size += e.get_key_bytes().size();
+        }
+        // Keys parsed from the index file may share the (much larger) read buffer,
+        // so copy them into a single buffer owned by the cached page.
+        temporary_buffer<char> keys(keys_size);
+        utils::chunked_vector<cached_index_entry> entries;
+        entries.reserve(indexes.size());
+        uint32_t key_offset = 0;
+        for (const index_entry& e : indexes) {
+            auto key = e.get_key_bytes();
+            std::copy_n(key.begin(), key.size(), keys.get_write() + key_offset);
+            entries.push_back(cached_index_entry{
+                key_offset,
+                uint32_t(key.size()),
+                e.position(),
+                e.get_promoted_index_start(),
+                e.get_promoted_index_size(),
+                e.get_total_pi_blocks_count(),
+                e.get_deletion_time()});
+            key_offset += key.size();
+        }
+        cache.insert(summary_idx, std::move(keys), std::move(entries));
+    }
+
+    // Creates index entries from a cached page, without reading the partition index.
+    // Promoted indexes are read from the index file on demand.
+    index_list materialize_page(const cached_index_page& page) {
+        const auto& cached_entries = page.entries();
+        index_list indexes;
+        indexes.reserve(cached_entries.size());
+        file index_file;
+        file_input_stream_options options;
+        std::optional<column_values_fixed_lengths> ck_values_fixed_lengths;
+        const schema& s = *_sstable->_schema;
+        for (const cached_index_entry& ce : cached_entries) {
+            std::unique_ptr<promoted_index> index;
+            if (ce.partition_tombstone) {
+                if (!index_file) {
+                    index_file = reader::get_file(*_sstable, _permit, _trace_state);
+                    options = reader::get_file_input_stream_options(_sstable, _pc);
+                    if (_sstable->get_version() == sstable_version_types::mc) {
+                        ck_values_fixed_lengths = get_clustering_values_fixed_lengths(_sstable->get_serialization_header());
+                    }
+                }
+                auto pi_options = options;
+                pi_options.buffer_size = std::min<size_t>(options.buffer_size, align_up<size_t>(ce.promoted_index_size, 4096));
+                auto stream = make_file_input_stream(index_file, ce.promoted_index_start, ce.promoted_index_size, pi_options);
+                if (ck_values_fixed_lengths) {
+                    index = std::make_unique<promoted_index>(s, _permit, *ce.partition_tombstone, std::move(stream),
+                            ce.promoted_index_start, ce.promoted_index_size, ce.promoted_index_blocks, *ck_values_fixed_lengths);
+                } else {
+                    index = std::make_unique<promoted_index>(s, _permit, *ce.partition_tombstone, std::move(stream),
+                            ce.promoted_index_start, ce.promoted_index_size, ce.promoted_index_blocks);
+                }
+            }
+            indexes.push_back(index_entry{page.key(ce), ce.position, std::move(index)});
+        }
+        return indexes;
+    }
+
     future<> advance_lower_to_start(const dht::partition_range &range) {
         if (range.start()) {
             return advance_to(_lower_bound,
@@ -480,6 +623,12 @@ class index_reader {
                 return advance_to_next_partition(bound);
             });
         }
+        // Advancing partition by partition is what range scans do, so make sure
+        // the next page is on its way before the scan gets to it.
+        const bool sequential_scan = &bound == &_lower_bound;
+        if (sequential_scan) {
+            read_ahead_page(bound.current_summary_idx + 1);
+        }
         if (bound.current_index_idx + 1 < bound.current_list->size()) {
             ++bound.current_index_idx;
             bound.current_pi_idx = 0;
@@ -490,7 +639,11 @@ class index_reader {
         }
         auto& summary = _sstable->get_summary();
         if (bound.current_summary_idx + 1 < summary.header.size) {
-            return advance_to_page(bound, bound.current_summary_idx + 1);
+            return advance_to_page(bound, bound.current_summary_idx + 1).then([this, &bound, sequential_scan] {
+                if (sequential_scan) {
+                    read_ahead_page(bound.current_summary_idx + 1);
+                }
+            });
         }
         advance_to_end(bound);
         return make_ready_future<>();
@@ -832,8 +985,12 @@ class index_reader {
     }
 
     future<> close() {
+        auto read_ahead = _read_ahead ? std::move(*_read_ahead) : make_ready_future<>();
+        _read_ahead.reset();
         // Need to close consequently as we expect to not have close_current_list_ptr to run in parallel
-        return close_index_list(_lower_bound.current_list).then([this] {
+        return read_ahead.then([this] {
+            return close_index_list(_lower_bound.current_list);
+        }).then([this] {
             if (_upper_bound) {
                 return close_index_list(_upper_bound->current_list);
             }
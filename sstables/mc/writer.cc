@@ -28,6 +28,7 @@
 #include "sstables/types.hh"
 #include "sstables/mc/types.hh"
 #include "db/config.hh"
+#include "db/bloom_filter_format_extension.hh"
 #include "atomic_cell.hh"
 #include "utils/exceptions.hh"
 
@@ -753,7 +754,9 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(),
+                db::bloom_filter_format_extension::filter_format_for(_schema, utils::filter_format::m_format,
+                        _cfg.use_split_block_bloom_filters));
         _pi_write_m.desired_block_size = cfg.promoted_index_block_size.value_or(get_config().column_index_size_in_kb() * 1024);
         _sst._correctly_serialize_non_compound_range_tombstones = _cfg.correctly_serialize_non_compound_range_tombstones;
         _index_sampling_state.summary_byte_cost = summary_byte_cost();
@@ -839,7 +842,9 @@ void writer::init_file_writers() {
                 std::move(_sst._data_file),
                 options,
                 &_sst._components->compression,
-                _schema.get_compressor_params()));
+                _schema.get_compressor_params(),
+                _cfg.compression_dictionary,
+                _cfg.use_compression_dictionaries));
     }
     _index_writer = std::make_unique<file_writer>(std::move(_sst._index_file), options);
 }
@@ -1415,6 +1420,9 @@ void writer::consume_end_of_stream() {
     if (!_cfg.correctly_serialize_static_compact_in_mc) {
         features.disable(sstable_feature::CorrectStaticCompact);
     }
+    if (!_sst.has_split_block_filter()) {
+        features.disable(sstable_feature::SplitBlockBloomFilter);
+    }
     run_identifier identifier{_run_identifier};
     _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier));
     _cfg.monitor->on_write_completed();
@@ -24,6 +24,7 @@
 
 
 #include <variant>
+#include <boost/algorithm/cxx11/any_of.hpp>
 #include "flat_mutation_reader.hh"
 #include "timestamp.hh"
 #include "gc_clock.hh"
@@ -1190,6 +1191,22 @@ class mp_row_consumer_m : public consumer_m {
         return consumer_m::row_processing_result::do_proceed;
     }
 
+    virtual bool needs_column_value(const column_translation::column_info& column_info, column_kind kind) const override {
+        // Only data queries can do without the values of unselected columns,
+        // mutation queries return them and read repair writes them back.
+        // Rows which populate the cache must be complete too.
+        if (!_slice.options.contains(query::partition_slice::option::skip_unselected_values)
+                || !_slice.options.contains(query::partition_slice::option::bypass_cache)
+                || _treat_static_row_as_regular) {
+            return true;
+        }
+        if (!column_info.id) {
+            return false;
+        }
+        const auto& columns = kind == column_kind::static_column ? _slice.static_columns : _slice.regular_columns;
+        return boost::algorithm::any_of_equal(columns, *column_info.id);
+    }
+
     virtual proceed consume_column(const column_translation::column_info& column_info,
                                    bytes_view cell_path,
                                    bytes_view value,
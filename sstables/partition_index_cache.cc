@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sstables/partition_index_cache.hh"
+
+namespace sstables {
+
+thread_local index_page_cache_tracker index_page_cache_tracker::_shard_tracker;
+
+index_page_cache_tracker::~index_page_cache_tracker() {
+    clear();
+}
+
+void index_page_cache_tracker::set_max_memory(size_t max_memory) {
+    _max_memory = max_memory;
+    maybe_evict();
+}
+
+void index_page_cache_tracker::evict_one() {
+    cached_index_page& page = _lru.front();
+    ++_stats.evictions;
+    page._owner.erase(page);
+}
+
+void index_page_cache_tracker::maybe_evict() {
+    while (_stats.bytes > _max_memory && !_lru.empty()) {
+        evict_one();
+    }
+}
+
+void index_page_cache_tracker::clear() {
+    while (!_lru.empty()) {
+        cached_index_page& page = _lru.front();
+        page._owner.erase(page);
+    }
+}
+
+void index_page_cache_tracker::insert(cached_index_page& page) noexcept {
+    ++_stats.populations;
+    ++_stats.pages;
+    _stats.bytes += page.memory_usage();
+    _lru.push_back(page);
+    maybe_evict();
+}
+
+void index_page_cache_tracker::on_remove(cached_index_page& page) noexcept {
+    --_stats.pages;
+    _stats.bytes -= page.memory_usage();
+    page._lru_link.unlink();
+}
+
+partition_index_cache::~partition_index_cache() {
+    clear();
+}
+
+void partition_index_cache::insert(uint64_t summary_idx, temporary_buffer<char> keys, utils::chunked_vector<cached_index_entry> entries) {
+    if (!_tracker.enabled()) {
+        return;
+    }
+    auto it = _pages.emplace(summary_idx, nullptr);
+    if (!it.second) {
+        return;
+    }
+    try {
+        it.first->second = std::make_unique<cached_index_page>(*this, summary_idx, std::move(keys), std::move(entries));
+    } catch (...) {
+        _pages.erase(it.first);
+        throw;
+    }
+    _tracker.insert(*it.first->second);
+}
+
+void partition_index_cache::on_read_started(uint64_t summary_idx) {
+    if (_tracker.enabled()) {
+        _reads.emplace(summary_idx, shared_promise<>());
+    }
+}
+
+void partition_index_cache::on_read_finished(uint64_t summary_idx) noexcept {
+    auto i = _reads.find(summary_idx);
+    if (i != _reads.end()) {
+        i->second.set_value();
+        _reads.erase(i);
+    }
+}
+
+std::optional<future<>> partition_index_cache::wait_for_read(uint64_t summary_idx) {
+    auto i = _reads.find(summary_idx);
+    if (i == _reads.end()) {
+        return std::nullopt;
+    }
+    _tracker.on_shared_read();
+    return i->second.get_shared_future();
+}
+
+void partition_index_cache::erase(cached_index_page& page) noexcept {
+    _tracker.on_remove(page);
+    _pages.erase(page.summary_idx());
+}
+
+void partition_index_cache::clear() noexcept {
+    for (auto&& e : _pages) {
+        _tracker.on_remove(*e.second);
+    }
+    _pages.clear();
+}
+
+}
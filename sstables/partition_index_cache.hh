@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <boost/intrusive/list.hpp>
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/core/shared_future.hh>
+#include "sstables/types.hh"
+#include "utils/chunked_vector.hh"
+#include "seastarx.hh"
+
+namespace sstables {
+
+namespace bi = boost::intrusive;
+
+class partition_index_cache;
+class index_page_cache_tracker;
+
+// Reader-independent copy of a parsed partition index entry.
+//
+// The promoted index is not kept in memory, only its location in the index
+// file, so that readers can open a stream over it when it is needed.
+struct cached_index_entry {
+    uint32_t key_offset; // into cached_index_page::_keys
+    uint32_t key_size;
+    uint64_t position;
+    uint64_t promoted_index_start = 0;
+    uint32_t promoted_index_size = 0;
+    uint32_t promoted_index_blocks = 0;
+    std::optional<sstables::deletion_time> partition_tombstone;
+};
+
+// A cached partition index page, that is all index entries between two
+// consecutive summary entries.
+//
+// Keys of all entries are stored in a single buffer, entries can share it
+// with the index_entry objects materialized from the page.
+class cached_index_page {
+public:
+    using lru_link_type = bi::list_member_hook<bi::link_mode<bi::auto_unlink>>;
+private:
+    friend class index_page_cache_tracker;
+    friend class partition_index_cache;
+
+    partition_index_cache& _owner;
+    uint64_t _summary_idx;
+    temporary_buffer<char> _keys;
+    utils::chunked_vector<cached_index_entry> _entries;
+    lru_link_type _lru_link;
+public:
+    cached_index_page(partition_index_cache& owner, uint64_t summary_idx,
+            temporary_buffer<char> keys, utils::chunked_vector<cached_index_entry> entries)
+        : _owner(owner)
+        , _summary_idx(summary_idx)
+        , _keys(std::move(keys))
+        , _entries(std::move(entries))
+    { }
+
+    cached_index_page(const cached_index_page&) = delete;
+    cached_index_page(cached_index_page&&) = delete;
+
+    uint64_t summary_idx() const { return _summary_idx; }
+    const utils::chunked_vector<cached_index_entry>& entries() const { return _entries; }
+
+    // Returns a buffer holding the key of the given entry.
+    // The buffer shares the underlying storage with the page, so it stays valid after eviction.
+    temporary_buffer<char> key(const cached_index_entry& e) const {
+        return _keys.share(e.key_offset, e.key_size);
+    }
+
+    size_t memory_usage() const {
+        return sizeof(*this) + _keys.size() + _entries.size() * sizeof(cached_index_entry);
+    }
+};
+
+// Shard-wide LRU of cached partition index pages of all sstables.
+//
+// Pages are evicted in LRU order when the total memory used by cached pages
+// exceeds the configured budget. A budget of zero disables population.
+class index_page_cache_tracker {
+public:
+    using lru_type = bi::list<cached_index_page,
+        bi::member_hook<cached_index_page, cached_index_page::lru_link_type, &cached_index_page::_lru_link>,
+        bi::constant_time_size<false>>; // we need this to have bi::auto_unlink on hooks.
+
+    struct stats {
+        uint64_t hits = 0; // Number of page lookups satisfied from the cache
+        uint64_t misses = 0; // Number of page lookups which had to read the index file
+        uint64_t populations = 0; // Number of pages inserted into the cache
+        uint64_t evictions = 0; // Number of pages evicted from the cache due to memory pressure
+        uint64_t read_aheads = 0; // Number of pages read into the cache ahead of a sequential scan
+        uint64_t shared_reads = 0; // Number of page lookups which waited for a read of the page issued by another lookup
+        uint64_t pages = 0; // Number of pages currently cached
+        uint64_t bytes = 0; // Memory currently used by cached pages
+    };
+private:
+    static thread_local index_page_cache_tracker _shard_tracker;
+
+    size_t _max_memory = 0;
+    lru_type _lru;
+    stats _stats;
+private:
+    void evict_one();
+    void maybe_evict();
+public:
+    index_page_cache_tracker() = default;
+    index_page_cache_tracker(const index_page_cache_tracker&) = delete;
+    ~index_page_cache_tracker();
+
+    static index_page_cache_tracker& shard_tracker() { return _shard_tracker; }
+
+    // Sets the memory budget for cached pages. Evicts pages if the budget is exceeded.
+    void set_max_memory(size_t max_memory);
+    size_t max_memory() const { return _max_memory; }
+    bool enabled() const { return _max_memory != 0; }
+
+    // Evicts all pages.
+    void clear();
+
+    void on_hit(cached_index_page& page) noexcept {
+        ++_stats.hits;
+        page._lru_link.unlink();
+        _lru.push_back(page);
+    }
+    void on_miss() noexcept { ++_stats.misses; }
+    void on_read_ahead() noexcept { ++_stats.read_aheads; }
+    void on_shared_read() noexcept { ++_stats.shared_reads; }
+
+    void insert(cached_index_page& page) noexcept;
+    void on_remove(cached_index_page& page) noexcept;
+
+    const stats& get_stats() const { return _stats; }
+};
+
+// Per-sstable cache of partition index pages, keyed by summary index.
+//
+// Unlike shared_index_lists, which only shares pages between cursors of a single
+// index_reader, pages cached here outlive the readers and are evicted by the
+// index_page_cache_tracker.
+class partition_index_cache {
+    index_page_cache_tracker& _tracker;
+    std::unordered_map<uint64_t, std::unique_ptr<cached_index_page>> _pages;
+    // Pages being read from the index file. Lookups of a page which is being
+    // read, like those of the keys of a multi-partition query falling into the
+    // same page, wait for the read to populate the cache instead of issuing
+    // their own.
+    std::unordered_map<uint64_t, shared_promise<>> _reads;
+public:
+    explicit partition_index_cache(index_page_cache_tracker& tracker = index_page_cache_tracker::shard_tracker())
+        : _tracker(tracker)
+    { }
+    partition_index_cache(const partition_index_cache&) = delete;
+    ~partition_index_cache();
+
+    // Returns the cached page for the given summary index or nullptr when it is not cached.
+    // The returned pointer is invalidated by any deferring point.
+    const cached_index_page* find(uint64_t summary_idx) {
+        auto i = _pages.find(summary_idx);
+        if (i == _pages.end()) {
+            _tracker.on_miss();
+            return nullptr;
+        }
+        _tracker.on_hit(*i->second);
+        return i->second.get();
+    }
+
+    // Like find(), but doesn't count as a lookup.
+    bool contains(uint64_t summary_idx) const {
+        return _pages.count(summary_idx);
+    }
+
+    bool enabled() const { return _tracker.enabled(); }
+
+    void on_read_ahead() noexcept { _tracker.on_read_ahead(); }
+
+    // Called around reads of a page from the index file, which are expected to populate the cache.
+    void on_read_started(uint64_t summary_idx);
+    void on_read_finished(uint64_t summary_idx) noexcept;
+
+    // Returns a future which resolves when the read of the given page, started by
+    // another lookup, completes, or nothing when the page isn't being read.
+    // The page is not guaranteed to be cached afterwards, the read may have failed
+    // or the page may have been evicted already.
+    std::optional<future<>> wait_for_read(uint64_t summary_idx);
+
+    bool is_being_read(uint64_t summary_idx) const {
+        return _reads.count(summary_idx);
+    }
+
+    // Inserts the page unless the same page was already inserted.
+    void insert(uint64_t summary_idx, temporary_buffer<char> keys, utils::chunked_vector<cached_index_entry> entries);
+
+    // Removes the page, called by the tracker on eviction.
+    void erase(cached_index_page& page) noexcept;
+
+    void clear() noexcept;
+
+    size_t size() const { return _pages.size(); }
+};
+
+}
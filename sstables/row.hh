@@ -190,6 +190,16 @@ class consumer_m {
 
     virtual row_processing_result consume_static_row_start() = 0;
 
+    // Tells whether the consumer needs the values of cells of the given atomic,
+    // non-counter column. Called for each column when the parser is set up.
+    //
+    // Cells of columns whose values are not needed are still passed to
+    // consume_column(), because they decide whether the row is live, but with
+    // empty values, which the parser skips over without reading them.
+    virtual bool needs_column_value(const sstables::column_translation::column_info& column_info, column_kind kind) const {
+        return true;
+    }
+
     virtual proceed consume_column(const sstables::column_translation::column_info& column_info,
                                    bytes_view cell_path,
                                    bytes_view value,
@@ -610,6 +620,7 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
         COLUMN_TTL_2,
         COLUMN_CELL_PATH,
         COLUMN_VALUE,
+        COLUMN_VALUE_SKIP,
         COLUMN_END,
         RANGE_TOMBSTONE_MARKER,
         RANGE_TOMBSTONE_KIND,
@@ -651,6 +662,9 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
 
         // Represents the subset of _all_columns present in current row
         boost::dynamic_bitset<uint64_t> _columns_selector; // size() == _columns.size()
+
+        // Represents the subset of _all_columns whose cell values the consumer needs
+        boost::dynamic_bitset<uint64_t> _values_needed; // size() == _all_columns.size()
     };
 
     row_schema _regular_row;
@@ -693,9 +707,14 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
         _row = &rs;
         _row->_columns = _row->_all_columns;
     }
-    void setup_columns(row_schema& rs, const std::vector<column_translation::column_info>& columns) {
+    void setup_columns(row_schema& rs, const std::vector<column_translation::column_info>& columns, column_kind kind) {
         rs._all_columns = boost::make_iterator_range(columns);
         rs._columns_selector = boost::dynamic_bitset<uint64_t>(columns.size());
+        rs._values_needed = boost::dynamic_bitset<uint64_t>(columns.size());
+        for (size_t i = 0; i < columns.size(); ++i) {
+            const auto& column = columns[i];
+            rs._values_needed[i] = column.is_collection || column.is_counter || _consumer.needs_column_value(column, kind);
+        }
     }
     void skip_absent_columns() {
         size_t pos = _row->_columns_selector.find_first();
@@ -714,6 +733,9 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
     }
     bool is_column_simple() const { return !_row->_columns.front().is_collection; }
     bool is_column_counter() const { return _row->_columns.front().is_counter; }
+    bool is_column_value_needed() const {
+        return _row->_values_needed.test(_row->_all_columns.size() - _row->_columns.size());
+    }
     const column_translation::column_info& get_column_info() const {
         return _row->_columns.front();
     }
@@ -1120,6 +1142,18 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                 _state = state::COLUMN_END;
                 goto column_end_label;
             }
+            if (!is_column_value_needed()) {
+                _column_value = temporary_buffer<char>(0);
+                if (auto len = get_column_value_length()) {
+                    _u64 = *len;
+                    goto column_value_skip_label;
+                }
+                if (read_unsigned_vint(data) != read_status::ready) {
+                    _state = state::COLUMN_VALUE_SKIP;
+                    break;
+                }
+                goto column_value_skip_label;
+            }
             read_status status = read_status::waiting;
             if (auto len = get_column_value_length()) {
                 status = read_bytes(data, *len, _column_value);
@@ -1166,6 +1200,16 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
                 move_to_next_column();
             }
             goto column_label;
+        case state::COLUMN_VALUE_SKIP:
+        column_value_skip_label: {
+            _sst->get_stats().on_cell_value_skip();
+            _state = state::COLUMN_END;
+            auto skipped = skip(data, static_cast<uint32_t>(_u64));
+            if (std::holds_alternative<data_consumer::skip_bytes>(skipped)) {
+                return skipped;
+            }
+            goto column_end_label;
+        }
         case state::ROW_BODY_MISSING_COLUMNS_2:
         row_body_missing_columns_2_label: {
             uint64_t missing_column_bitmap_or_count = _u64;
@@ -1351,8 +1395,8 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
         , _column_translation(sst->get_column_translation(s, _header))
         , _has_shadowable_tombstones(sst->has_shadowable_tombstones())
     {
-        setup_columns(_regular_row, _column_translation.regular_columns());
-        setup_columns(_static_row, _column_translation.static_columns());
+        setup_columns(_regular_row, _column_translation.regular_columns(), column_kind::regular_column);
+        setup_columns(_static_row, _column_translation.static_columns(), column_kind::static_column);
     }
 
     void verify_end_state() {
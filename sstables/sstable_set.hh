@@ -23,6 +23,7 @@
 
 #include "shared_sstable.hh"
 #include "dht/i_partitioner.hh"
+#include "utils/i_filter.hh"
 #include <seastar/core/shared_ptr.hh>
 #include <vector>
 
@@ -103,6 +104,19 @@ class sstable_set {
 
 std::unique_ptr<sstable_set_impl> make_partitioned_sstable_set(schema_ptr schema, bool use_level_metadata = true);
 
+// Probes the bloom filters of all the sstables for the same key, hashed once by the caller.
+//
+// The memory touched by each probe is prefetched before any filter is tested, so that
+// with many candidate sstables the cache misses overlap instead of being serialized.
+//
+// Removes the sstables which can't contain the key in place, keeping the order of the
+// others, so that the read path doesn't allocate. Returns the number of removed sstables.
+size_t probe_filters(std::vector<shared_sstable>& sstables, utils::hashed_key hk);
+
+// Like probe_filters(), but only tells whether any of the sstables may contain the key.
+// Stops at the first one which may, and doesn't allocate.
+bool any_filter_has_key(const std::vector<shared_sstable>& sstables, utils::hashed_key hk);
+
 std::ostream& operator<<(std::ostream& os, const sstables::sstable_run& run);
 
 }
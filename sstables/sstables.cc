@@ -68,6 +68,7 @@
 #include "integrity_checked_file_impl.hh"
 #include "service/storage_service.hh"
 #include "db/extensions.hh"
+#include "db/bloom_filter_format_extension.hh"
 #include "unimplemented.hh"
 #include "vint-serialization.hh"
 #include "db/large_data_handler.hh"
@@ -1111,7 +1112,21 @@ future<> sstable::read_compression(const io_priority_class& pc) {
         return make_ready_future<>();
     }
 
-    return read_simple<component_type::CompressionInfo>(_components->compression, pc);
+    return read_simple<component_type::CompressionInfo>(_components->compression, pc).then([this] {
+        // Scylla component is read before the others.
+        if (_components->scylla_metadata) {
+            if (auto* dict = _components->scylla_metadata->get_compression_dictionary()) {
+                _components->compression.set_dictionary(dict->value);
+            }
+        }
+    });
+}
+
+const compressor_ptr& sstable::get_compressor() {
+    if (!_compressor && _components->compression) {
+        _compressor = get_sstable_compressor(_components->compression);
+    }
+    return _compressor;
 }
 
 void sstable::write_compression(const io_priority_class& pc) {
@@ -1391,16 +1406,24 @@ future<> sstable::read_filter(const io_priority_class& pc) {
         utils::filter_format format = (_version == sstable_version_types::mc)
                                       ? utils::filter_format::m_format
                                       : utils::filter_format::k_l_format;
+        if (has_scylla_component() && _components->scylla_metadata->has_feature(sstable_feature::SplitBlockBloomFilter)) {
+            format = utils::filter_format::split_block;
+        }
         _components->filter = utils::filter::create_filter(filter.hashes, std::move(bs), format);
     });
 }
 
+bool sstable::has_split_block_filter() const {
+    auto f = dynamic_cast<const utils::filter::bloom_filter*>(_components->filter.get());
+    return f && f->format() == utils::filter_format::split_block;
+}
+
 void sstable::write_filter(const io_priority_class& pc) {
     if (!has_component(component_type::Filter)) {
         return;
     }
 
-    auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
+    auto f = static_cast<utils::filter::bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
     auto filter_ref = sstables::filter_ref(f->num_hashes(), bs.get_storage());
@@ -2030,7 +2053,9 @@ components_writer::components_writer(sstable& sst, const schema& s, file_writer&
     , _tombstone_written(false)
     , _range_tombstones(s)
 {
-    _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::k_l_format);
+    _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(),
+            db::bloom_filter_format_extension::filter_format_for(_schema, utils::filter_format::k_l_format,
+                    cfg.use_split_block_bloom_filters));
     _sst._pi_write.desired_block_size = cfg.promoted_index_block_size.value_or(get_config().column_index_size_in_kb() * 1024);
     _sst._correctly_serialize_non_compound_range_tombstones = cfg.correctly_serialize_non_compound_range_tombstones;
     _index_sampling_state.summary_byte_cost = summary_byte_cost();
@@ -2236,6 +2261,10 @@ sstable::write_scylla_metadata(const io_priority_class& pc, shard_id shard, ssta
     _components->scylla_metadata->data.set<scylla_metadata_type::Sharding>(std::move(sm));
     _components->scylla_metadata->data.set<scylla_metadata_type::Features>(std::move(features));
     _components->scylla_metadata->data.set<scylla_metadata_type::RunIdentifier>(std::move(identifier));
+    if (has_compression_dictionary()) {
+        auto dict = _components->compression.dictionary();
+        _components->scylla_metadata->data.set<scylla_metadata_type::CompressionDictionary>(disk_string<uint32_t>{bytes(dict.begin(), dict.end())});
+    }
 
     write_simple<component_type::Scylla>(*_components->scylla_metadata, pc);
 }
@@ -2289,7 +2318,8 @@ void sstable_writer_k_l::prepare_file_writer()
         _writer = std::make_unique<adler32_checksummed_file_writer>(std::move(_sst._data_file), std::move(options));
     } else {
         _writer = std::make_unique<file_writer>(make_compressed_file_k_l_format_output_stream(
-                std::move(_sst._data_file), std::move(options), &_sst._components->compression, _schema.get_compressor_params()));
+                std::move(_sst._data_file), std::move(options), &_sst._components->compression, _schema.get_compressor_params(),
+                _cfg.compression_dictionary, _cfg.use_compression_dictionaries));
     }
 }
 
@@ -2357,6 +2387,9 @@ void sstable_writer_k_l::consume_end_of_stream()
     if (!_correctly_serialize_non_compound_range_tombstones) {
         features.disable(sstable_feature::NonCompoundRangeTombstones);
     }
+    if (!_sst.has_split_block_filter()) {
+        features.disable(sstable_feature::SplitBlockBloomFilter);
+    }
     run_identifier identifier{_run_identifier};
     _sst.write_scylla_metadata(_pc, _shard, std::move(features), std::move(identifier));
 
@@ -2805,10 +2838,10 @@ input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_prior
     if (_components->compression) {
         if (_version == sstable_version_types::mc) {
              return make_compressed_file_m_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options));
+                pos, len, std::move(options), get_compressor());
         } else {
             return make_compressed_file_k_l_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options));
+                pos, len, std::move(options), get_compressor());
         }
     }
 
@@ -3394,6 +3427,23 @@ future<> init_metrics() {
         sm::make_derive("index_page_blocks", [] { return shared_index_lists::shard_stats().blocks; },
             sm::description("Index page requests which needed to wait due to page not being loaded yet")),
 
+        sm::make_derive("index_page_cache_hits", [] { return index_page_cache_tracker::shard_tracker().get_stats().hits; },
+            sm::description("Index page requests which were satisfied from the index page cache")),
+        sm::make_derive("index_page_cache_misses", [] { return index_page_cache_tracker::shard_tracker().get_stats().misses; },
+            sm::description("Index page requests which had to read and parse the index file")),
+        sm::make_derive("index_page_cache_populations", [] { return index_page_cache_tracker::shard_tracker().get_stats().populations; },
+            sm::description("Index pages inserted into the index page cache")),
+        sm::make_derive("index_page_cache_evictions", [] { return index_page_cache_tracker::shard_tracker().get_stats().evictions; },
+            sm::description("Index pages evicted from the index page cache due to memory pressure")),
+        sm::make_derive("index_page_cache_read_aheads", [] { return index_page_cache_tracker::shard_tracker().get_stats().read_aheads; },
+            sm::description("Index pages read into the index page cache ahead of sequential scans")),
+        sm::make_derive("index_page_cache_shared_reads", [] { return index_page_cache_tracker::shard_tracker().get_stats().shared_reads; },
+            sm::description("Index page requests which waited for a read of the page issued by a concurrent request")),
+        sm::make_gauge("index_page_cache_pages", [] { return index_page_cache_tracker::shard_tracker().get_stats().pages; },
+            sm::description("Number of index pages currently held in the index page cache")),
+        sm::make_gauge("index_page_cache_bytes", [] { return index_page_cache_tracker::shard_tracker().get_stats().bytes; },
+            sm::description("Memory used by the index page cache")),
+
         sm::make_derive("partition_writes", [] { return sstables_stats::get_shard_stats().partition_writes; },
             sm::description("Number of partitions written")),
         sm::make_derive("static_row_writes", [] { return sstables_stats::get_shard_stats().static_row_writes; },
@@ -3420,6 +3470,8 @@ future<> init_metrics() {
             sm::description("Number of partitions seeked")),
         sm::make_derive("row_reads", [] { return sstables_stats::get_shard_stats().row_reads; },
             sm::description("Number of rows read")),
+        sm::make_derive("cell_value_skips", [] { return sstables_stats::get_shard_stats().cell_value_skips; },
+            sm::description("Number of cell values of unselected columns skipped over without being read")),
 
         sm::make_counter("capped_local_deletion_time", [] { return sstables_stats::get_shard_stats().capped_local_deletion_time; },
             sm::description("Was local deletion time capped at maximum allowed value in Statistics")),
@@ -3481,6 +3533,14 @@ bool supports_correct_static_compact_in_mc() {
     return bool(service::get_local_storage_service().cluster_supports_correct_static_compact_in_mc());
 }
 
+bool supports_compression_dictionaries() {
+    return service::get_local_storage_service().cluster_supports_compression_dictionaries();
+}
+
+bool supports_split_block_bloom_filters() {
+    return service::get_local_storage_service().cluster_supports_split_block_bloom_filters();
+}
+
 }
 
 std::ostream& operator<<(std::ostream& out, const sstables::component_type& comp_type) {
@@ -62,6 +62,7 @@
 #include "stats.hh"
 #include "utils/observable.hh"
 #include "sstables/shareable_components.hh"
+#include "sstables/partition_index_cache.hh"
 
 #include <seastar/util/optimized_optional.hh>
 #include <boost/intrusive/list.hpp>
@@ -111,6 +112,8 @@ class index_reader;
 
 bool supports_correct_non_compound_range_tombstones();
 bool supports_correct_static_compact_in_mc();
+bool supports_compression_dictionaries();
+bool supports_split_block_bloom_filters();
 
 struct sstable_writer_config {
     std::optional<size_t> promoted_index_block_size;
@@ -122,6 +125,15 @@ struct sstable_writer_config {
     bool correctly_serialize_non_compound_range_tombstones = supports_correct_non_compound_range_tombstones();
     bool correctly_serialize_static_compact_in_mc = supports_correct_static_compact_in_mc();
     utils::UUID run_identifier = utils::make_random_uuid();
+    // Compressor bound to a dictionary to use instead of training a new one,
+    // if the table's compression wants a dictionary. See compressor::dictionary_size().
+    compressor_ptr compression_dictionary;
+    // Nodes which don't know dictionaries would read such sstables as garbage.
+    bool use_compression_dictionaries = supports_compression_dictionaries();
+    // Nodes which don't know split block filters would read them as classic
+    // ones and miss partitions, so the bloom_filter_format of the table is
+    // ignored until all nodes do.
+    bool use_split_block_bloom_filters = supports_split_block_bloom_filters();
 };
 
 class sstable_tracker;
@@ -469,6 +481,8 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     std::vector<sstring> _unrecognized_components;
 
     foreign_ptr<lw_shared_ptr<shareable_components>> _components = make_foreign(make_lw_shared<shareable_components>());
+    // Shard-local, created on first use. See get_compressor().
+    compressor_ptr _compressor;
     column_translation _column_translation;
     bool _shared = true;  // across shards; safe default
     bool _open = false;
@@ -493,6 +507,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     lw_shared_ptr<file_input_stream_history> _single_partition_history = make_lw_shared<file_input_stream_history>();
     lw_shared_ptr<file_input_stream_history> _partition_range_history = make_lw_shared<file_input_stream_history>();
 
+    // Parsed partition index pages, evicted by the shard's index_page_cache_tracker.
+    partition_index_cache _index_cache;
+
     //FIXME: Set by sstable_writer to influence sstable writing behavior.
     //       Remove when doing #3012
     bool _correctly_serialize_non_compound_range_tombstones;
@@ -733,10 +750,17 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _components->filter->is_present(key);
     }
 
+    void prefetch_filter(utils::hashed_key key) const {
+        _components->filter->prefetch(key);
+    }
+
     bool filter_has_key(const schema& s, partition_key_view key) const {
         return filter_has_key(key::from_partition_key(s, key));
     }
 
+    // Whether the bloom filter is a utils::filter::split_block_bloom_filter.
+    bool has_split_block_filter() const;
+
     static utils::hashed_key make_hashed_key(const schema& s, const partition_key& key);
 
     filter_tracker& get_filter_tracker() { return _filter_tracker; }
@@ -809,6 +833,15 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _components->compression;
     }
 
+    // Returns the compressor of the data file, bound to the sstable's
+    // compression dictionary if it has one. Null if not compressed.
+    // Shared by all readers of the sstable on this shard.
+    const compressor_ptr& get_compressor();
+
+    bool has_compression_dictionary() const {
+        return !_components->compression.dictionary().empty();
+    }
+
     future<> mutate_sstable_level(uint32_t);
 
     const summary& get_summary() const {
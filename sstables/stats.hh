@@ -38,6 +38,7 @@ class sstables_stats {
         uint64_t partition_reads = 0;
         uint64_t partition_seeks = 0;
         uint64_t row_reads = 0;
+        uint64_t cell_value_skips = 0;
         uint64_t capped_local_deletion_time = 0;
         uint64_t capped_tombstone_deletion_time = 0;
     } _shard_stats;
@@ -101,6 +102,10 @@ class sstables_stats {
         ++_stats.row_reads;
     }
 
+    inline void on_cell_value_skip() {
+        ++_stats.cell_value_skips;
+    }
+
     inline void on_capped_local_deletion_time() {
         ++_stats.capped_local_deletion_time;
     }
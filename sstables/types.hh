@@ -459,7 +459,8 @@ enum sstable_feature : uint8_t {
     ShadowableTombstones = 2, // See #3885
     CorrectStaticCompact = 3, // See #4139
     CorrectEmptyCounters = 4, // See #4363
-    End = 5,
+    SplitBlockBloomFilter = 5, // Filter.db holds a utils::filter::split_block_bloom_filter
+    End = 6,
 };
 
 // Scylla-specific features enabled for a particular sstable.
@@ -498,6 +499,7 @@ enum class scylla_metadata_type : uint32_t {
     Features = 2,
     ExtensionAttributes = 3,
     RunIdentifier = 4,
+    CompressionDictionary = 5,
 };
 
 struct run_identifier {
@@ -516,7 +518,8 @@ struct scylla_metadata {
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::Sharding, sharding_metadata>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::Features, sstable_enabled_features>,
             disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::ExtensionAttributes, extension_attributes>,
-            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::RunIdentifier, run_identifier>
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::RunIdentifier, run_identifier>,
+            disk_tagged_union_member<scylla_metadata_type, scylla_metadata_type::CompressionDictionary, disk_string<uint32_t>>
             > data;
 
     sstable_enabled_features get_features() const {
@@ -544,6 +547,9 @@ struct scylla_metadata {
         auto* m = data.get<scylla_metadata_type::RunIdentifier, run_identifier>();
         return m ? std::make_optional(m->id) : std::nullopt;
     }
+    const disk_string<uint32_t>* get_compression_dictionary() const {
+        return data.get<scylla_metadata_type::CompressionDictionary, disk_string<uint32_t>>();
+    }
 
     template <typename Describer>
     auto describe_type(sstable_version_types v, Describer f) { return f(data); }
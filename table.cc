@@ -143,11 +143,15 @@ filter_sstable_for_reader(std::vector<sstables::shared_sstable>&& sstables, colu
     const dht::ring_position& pr_key = pr.start()->value();
     auto sstable_has_not_key = [&, cmp = dht::ring_position_comparator(*schema)] (const sstables::shared_sstable& sst) {
         return cmp(pr_key, sst->get_first_decorated_key()) < 0 ||
-               cmp(pr_key, sst->get_last_decorated_key()) > 0 ||
-               !sst->filter_has_key(key);
+               cmp(pr_key, sst->get_last_decorated_key()) > 0;
     };
     sstables.erase(boost::remove_if(sstables, sstable_has_not_key), sstables.end());
 
+    // Together with the per-sstable false positive counts, these give the
+    // actual false positive rate of the filters, see filter_tracker.
+    cf.get_stats().bloom_filter_checks += sstables.size();
+    cf.get_stats().bloom_filter_negatives += sstables::probe_filters(sstables, utils::make_hashed_key(bytes_view(key)));
+
     // FIXME: Workaround for https://github.com/scylladb/scylla/issues/3552
     // and https://github.com/scylladb/scylla/issues/3553
     const bool filtering_broken = true;
@@ -277,11 +281,11 @@ class incremental_reader_selector : public reader_selector {
     }
 };
 
+// Reads the partition from the sstables picked by filter_sstable_for_reader().
 static flat_mutation_reader
-create_single_key_sstable_reader(column_family* cf,
-                                 schema_ptr schema,
+create_single_key_sstable_reader(schema_ptr schema,
                                  reader_permit permit,
-                                 lw_shared_ptr<sstables::sstable_set> sstables,
+                                 const std::vector<sstables::shared_sstable>& sstables,
                                  utils::estimated_histogram& sstable_histogram,
                                  const dht::partition_range& pr, // must be singular
                                  const query::partition_slice& slice,
@@ -290,9 +294,8 @@ create_single_key_sstable_reader(column_family* cf,
                                  streamed_mutation::forwarding fwd,
                                  mutation_reader::forwarding fwd_mr)
 {
-    auto key = sstables::key::from_partition_key(*schema, *pr.start()->value().key());
     auto readers = boost::copy_range<std::vector<flat_mutation_reader>>(
-        filter_sstable_for_reader(sstables->select(pr), *cf, schema, pr, key, slice)
+        sstables
         | boost::adaptors::transformed([&] (const sstables::shared_sstable& sstable) {
             tracing::trace(trace_state, "Reading key {} from sstable {}", pr, seastar::value_of([&sstable] { return sstable->get_filename(); }));
             return sstable->read_row_flat(schema, permit, pr.start()->value(), slice, pc, trace_state, fwd);
@@ -329,6 +332,26 @@ flat_mutation_reader make_range_sstable_reader(schema_ptr s,
             fwd_mr);
 }
 
+// Estimates the memory a read from the sstables will consume, to admit it
+// with (see reader_concurrency_semaphore::wait_admission()).
+// The read of each sstable holds an index page and a data buffer. A single
+// partition read only buffers as much data as the partition has (the average
+// partition, as far as we know), a range scan fills whole buffers.
+// Reads which hit the cache are not admitted, sstable readers are only
+// created when the cache misses, so the estimate need not discount them.
+static size_t estimate_sstable_read_memory(const std::vector<sstables::shared_sstable>& sstables, bool singular) {
+    size_t memory = 0;
+    for (auto&& sst : sstables) {
+        size_t data = sstables::default_sstable_buffer_size;
+        if (singular) {
+            data = std::min(data, size_t(std::max(sst->get_stats_metadata().estimated_partition_size.mean(), int64_t(0))));
+        }
+        const auto index_page = sst->index_size() / std::max(sst->get_summary().entries.size(), size_t(1));
+        memory += index_page + data;
+    }
+    return memory;
+}
+
 flat_mutation_reader
 table::make_sstable_reader(schema_ptr s,
                                    lw_shared_ptr<sstables::sstable_set> sstables,
@@ -342,14 +365,42 @@ table::make_sstable_reader(schema_ptr s,
         ? _config.streaming_read_concurrency_semaphore
         : _config.read_concurrency_semaphore;
 
+    const bool singular = pr.is_singular() && pr.start()->value().has_key();
+    const bool local = !singular || dht::shard_of(pr.start()->value().token()) == engine().cpu_id();
+
+    // A single partition read picks its sstables up front, so that they are
+    // selected and filtered once, and the memory estimate counts only those
+    // which will be read.
+    std::vector<sstables::shared_sstable> candidates;
+    if (singular && local) {
+        auto key = sstables::key::from_partition_key(*s, *pr.start()->value().key());
+        candidates = filter_sstable_for_reader(sstables->select(pr), const_cast<column_family&>(*this), s, pr, key, slice);
+    }
+
+    // Cap the estimate, so that large reads still get admitted, albeit
+    // with fewer other reads in parallel.
+    size_t memory_cost = restricted_reader_base_cost;
+    if (semaphore) {
+        const auto max_memory_cost = std::max(restricted_reader_base_cost, size_t(semaphore->initial_resources().memory / 4));
+        size_t estimate;
+        if (singular) {
+            estimate = estimate_sstable_read_memory(candidates, true);
+        } else {
+            // A range scan opens readers incrementally, starting with the sstables
+            // intersecting its start, see incremental_reader_selector.
+            auto selector = sstables->make_incremental_selector();
+            estimate = estimate_sstable_read_memory(selector.select(dht::ring_position_view::for_range_start(pr)).sstables, false);
+        }
+        memory_cost = std::clamp(estimate, restricted_reader_base_cost, max_memory_cost);
+    }
+
     // CAVEAT: if make_sstable_reader() is called on a single partition
     // we want to optimize and read exactly this partition. As a
     // consequence, fast_forward_to() will *NOT* work on the result,
     // regardless of what the fwd_mr parameter says.
     auto ms = [&] () -> mutation_source {
-        if (pr.is_singular() && pr.start()->value().has_key()) {
-            const dht::ring_position& pos = pr.start()->value();
-            if (dht::shard_of(pos.token()) != engine().cpu_id()) {
+        if (singular) {
+            if (!local) {
                 return mutation_source([] (
                         schema_ptr s,
                         reader_permit permit,
@@ -363,7 +414,7 @@ table::make_sstable_reader(schema_ptr s,
                 });
             }
 
-            return mutation_source([semaphore, this, sstables=std::move(sstables)] (
+            return mutation_source([this, candidates = std::move(candidates)] (
                     schema_ptr s,
                     reader_permit permit,
                     const dht::partition_range& pr,
@@ -372,7 +423,7 @@ table::make_sstable_reader(schema_ptr s,
                     tracing::trace_state_ptr trace_state,
                     streamed_mutation::forwarding fwd,
                     mutation_reader::forwarding fwd_mr) {
-                return create_single_key_sstable_reader(const_cast<column_family*>(this), std::move(s), std::move(permit), std::move(sstables),
+                return create_single_key_sstable_reader(std::move(s), std::move(permit), candidates,
                         _stats.estimated_sstable_per_read, pr, slice, pc, std::move(trace_state), fwd, fwd_mr);
             });
         } else {
@@ -392,7 +443,8 @@ table::make_sstable_reader(schema_ptr s,
     }();
 
     if (semaphore) {
-        return make_restricted_flat_reader(*semaphore, std::move(ms), std::move(s), pr, slice, pc, std::move(trace_state), fwd, fwd_mr);
+        return make_restricted_flat_reader(*semaphore, std::move(ms), std::move(s), pr, slice, pc, std::move(trace_state), fwd, fwd_mr,
+                memory_cost);
     } else {
         return ms.make_reader(std::move(s), no_reader_permit(), pr, slice, pc, std::move(trace_state), fwd, fwd_mr);
     }
@@ -697,6 +749,9 @@ void table::add_sstable(sstables::shared_sstable sstable, const std::vector<unsi
     new_sstables->insert(sstable);
     _sstables = std::move(new_sstables);
     update_stats_for_new_sstable(sstable->bytes_on_disk(), shards_for_the_sstable);
+    if (sstable->has_compression_dictionary()) {
+        _compression_dictionary = sstable->get_compressor();
+    }
     if (sstable->requires_view_building()) {
         _sstables_staging.emplace(sstable->generation(), sstable);
     } else {
@@ -833,7 +888,8 @@ table::seal_active_streaming_memtable_immediate(flush_permit&& permit) {
             database_sstable_write_monitor monitor(std::move(fp), newtab, _compaction_manager, _compaction_strategy, old->get_max_timestamp());
             return do_with(std::move(monitor), [this, newtab, old, permit = std::move(permit)] (auto& monitor) mutable {
                 auto&& priority = service::get_local_streaming_write_priority();
-                return write_memtable_to_sstable(*old, newtab, monitor, incremental_backups_enabled(), priority, false).then([this, newtab, old] {
+                return write_memtable_to_sstable(*old, newtab, monitor, incremental_backups_enabled(), priority, false,
+                        _compression_dictionary).then([this, newtab, old] {
                     return newtab->open_data();
                 }).then([this, old, newtab] () {
                     return with_scheduling_group(_config.memtable_to_cache_scheduling_group, [this, newtab, old] {
@@ -881,7 +937,8 @@ future<> table::seal_active_streaming_memtable_big(streaming_memtable_big& smb,
                 auto fp = permit.release_sstable_write_permit();
                 auto monitor = std::make_unique<database_sstable_write_monitor>(std::move(fp), newtab, _compaction_manager, _compaction_strategy, old->get_max_timestamp());
                 auto&& priority = service::get_local_streaming_write_priority();
-                auto fut = write_memtable_to_sstable(*old, newtab, *monitor, incremental_backups_enabled(), priority, true);
+                auto fut = write_memtable_to_sstable(*old, newtab, *monitor, incremental_backups_enabled(), priority, true,
+                        _compression_dictionary);
                 return fut.then_wrapped([this, newtab, old, &smb, permit = std::move(permit), monitor = std::move(monitor)] (future<> f) mutable {
                     if (!f.failed()) {
                         smb.sstables.push_back(monitored_sstable{std::move(monitor), newtab});
@@ -977,7 +1034,8 @@ table::try_flush_memtable_to_sstable(lw_shared_ptr<memtable> old, sstable_write_
     database_sstable_write_monitor monitor(std::move(permit), newtab, _compaction_manager, _compaction_strategy, old->get_max_timestamp());
     return do_with(std::move(monitor), [this, old, newtab] (auto& monitor) {
         auto&& priority = service::get_local_memtable_flush_priority();
-        auto f = write_memtable_to_sstable(*old, newtab, monitor, incremental_backups_enabled(), priority, false);
+        auto f = write_memtable_to_sstable(*old, newtab, monitor, incremental_backups_enabled(), priority, false,
+                _compression_dictionary);
         // Switch back to default scheduling group for post-flush actions, to avoid them being staved by the memtable flush
         // controller. Cache update does not affect the input of the memtable cpu controller, so it can be subject to
         // priority inversion.
@@ -1105,6 +1163,8 @@ void table::set_metrics() {
                 ms::make_gauge("live_disk_space", ms::description("Live disk space used"), _stats.live_disk_space_used)(cf)(ks),
                 ms::make_gauge("total_disk_space", ms::description("Total disk space used"), _stats.total_disk_space_used)(cf)(ks),
                 ms::make_gauge("live_sstable", ms::description("Live sstable count"), _stats.live_sstable_count)(cf)(ks),
+                ms::make_derive("bloom_filter_checks", ms::description("Number of sstable bloom filter probes done by single-partition reads"), _stats.bloom_filter_checks)(cf)(ks),
+                ms::make_derive("bloom_filter_negatives", ms::description("Number of sstable bloom filter probes which excluded the sstable from a single-partition read"), _stats.bloom_filter_negatives)(cf)(ks),
                 ms::make_gauge("pending_compaction", ms::description("Estimated number of compactions pending for this column family"), _stats.pending_compactions)(cf)(ks)
         });
 
@@ -1278,6 +1338,16 @@ void table::remove_ancestors_needed_rewrite(std::unordered_set<uint64_t> ancesto
     rebuild_statistics();
 }
 
+void table::replace_compacted_sstables(std::vector<sstables::shared_sstable> old_ssts, std::vector<sstables::shared_sstable> new_ssts,
+        const std::function<void(const std::vector<sstables::shared_sstable>&)>& release_exhausted) {
+    _compaction_strategy.notify_completion(old_ssts, new_ssts);
+    _compaction_manager.propagate_replacement(this, old_ssts, new_ssts);
+    on_compaction_completion(new_ssts, old_ssts);
+    if (release_exhausted) {
+        release_exhausted(old_ssts);
+    }
+}
+
 future<>
 table::compact_sstables(sstables::compaction_descriptor descriptor) {
     if (!descriptor.sstables.size()) {
@@ -1293,12 +1363,7 @@ table::compact_sstables(sstables::compaction_descriptor descriptor) {
         };
         auto replace_sstables = [this, release_exhausted = descriptor.release_exhausted] (std::vector<sstables::shared_sstable> old_ssts,
                 std::vector<sstables::shared_sstable> new_ssts) {
-            _compaction_strategy.notify_completion(old_ssts, new_ssts);
-            _compaction_manager.propagate_replacement(this, old_ssts, new_ssts);
-            this->on_compaction_completion(new_ssts, old_ssts);
-            if (release_exhausted) {
-                release_exhausted(old_ssts);
-            }
+            replace_compacted_sstables(std::move(old_ssts), std::move(new_ssts), release_exhausted);
         };
 
         return sstables::compact_sstables(std::move(descriptor), *this, create_sstable, replace_sstables);
@@ -1319,14 +1384,18 @@ table::compact_sstables(sstables::compaction_descriptor descriptor) {
     });
 }
 
-static bool needs_cleanup(const sstables::shared_sstable& sst,
-                   const dht::token_range_vector& owned_ranges,
-                   schema_ptr s) {
+static dht::token_range get_token_range(const sstables::shared_sstable& sst, const schema_ptr& s) {
     auto first = sst->get_first_partition_key();
     auto last = sst->get_last_partition_key();
     auto first_token = dht::global_partitioner().get_token(*s, first);
     auto last_token = dht::global_partitioner().get_token(*s, last);
-    dht::token_range sst_token_range = dht::token_range::make(first_token, last_token);
+    return dht::token_range::make(first_token, last_token);
+}
+
+static bool needs_cleanup(const sstables::shared_sstable& sst,
+                   const dht::token_range_vector& owned_ranges,
+                   schema_ptr s) {
+    dht::token_range sst_token_range = get_token_range(sst, s);
 
     // return true iff sst partition range isn't fully contained in any of the owned ranges.
     for (auto& r : owned_ranges) {
@@ -1337,11 +1406,25 @@ static bool needs_cleanup(const sstables::shared_sstable& sst,
     return true;
 }
 
+// return true iff sst partition range doesn't overlap any of the owned ranges, so none of its data is owned.
+static bool owns_nothing_of(const sstables::shared_sstable& sst,
+                   const dht::token_range_vector& owned_ranges,
+                   schema_ptr s) {
+    dht::token_range sst_token_range = get_token_range(sst, s);
+
+    for (auto& r : owned_ranges) {
+        if (r.overlaps(sst_token_range, dht::token_comparator())) {
+            return false;
+        }
+    }
+    return true;
+}
+
 future<> table::cleanup_sstables(sstables::compaction_descriptor descriptor, bool is_actual_cleanup) {
     dht::token_range_vector r;
 
     if (is_actual_cleanup) {
-        r = service::get_local_storage_service().get_local_ranges(_schema->ks_name());
+        r = descriptor.owned_ranges ? std::move(*descriptor.owned_ranges) : service::get_local_storage_service().get_local_ranges(_schema->ks_name());
     }
 
     return do_with(std::move(descriptor.sstables), std::move(r), std::move(descriptor.release_exhausted), [this, is_actual_cleanup] (auto& sstables, auto& owned_ranges, auto& release_fn) {
@@ -1349,6 +1432,17 @@ future<> table::cleanup_sstables(sstables::compaction_descriptor descriptor, boo
             if (!owned_ranges.empty() && !needs_cleanup(sst, owned_ranges, _schema)) {
                 return make_ready_future<>();
             }
+            // An sstable with no owned data is deleted right away, without being read.
+            if (!owned_ranges.empty() && owns_nothing_of(sst, owned_ranges, _schema)) {
+                return with_lock(_sstables_lock.for_read(), [this, &sst, &release_fn] {
+                    return seastar::async([this, sst, &release_fn] {
+                        tlogger.info("Cleanup of {}.{} deletes sstable {}, which holds no data owned by this node",
+                            _schema->ks_name(), _schema->cf_name(), sst->get_filename());
+                        _compaction_strategy.get_backlog_tracker().remove_sstable(sst);
+                        replace_compacted_sstables({ sst }, {}, release_fn);
+                    });
+                });
+            }
 
             // this semaphore ensures that only one cleanup will run per shard.
             // That's to prevent node from running out of space when almost all sstables
@@ -1356,13 +1450,16 @@ future<> table::cleanup_sstables(sstables::compaction_descriptor descriptor, boo
             // twice the disk space used by those sstables.
             static thread_local named_semaphore sem(1, named_semaphore_exception_factory{"cleanup sstables"});
 
-            return with_semaphore(sem, 1, [this, &sst, &release_fn, is_actual_cleanup] {
+            return with_semaphore(sem, 1, [this, &sst, &owned_ranges, &release_fn, is_actual_cleanup] {
                 // release reference to sstables cleaned up, otherwise space usage from their data and index
                 // components cannot be reclaimed until all of them are cleaned.
                 auto sstable_level = sst->get_sstable_level();
                 auto run_identifier = sst->run_identifier();
                 auto descriptor = sstables::compaction_descriptor({ std::move(sst) }, sstable_level,
                     sstables::compaction_descriptor::default_max_sstable_bytes, run_identifier, is_actual_cleanup);
+                if (is_actual_cleanup) {
+                    descriptor.owned_ranges = owned_ranges;
+                }
                 descriptor.release_exhausted = release_fn;
                 return this->compact_sstables(std::move(descriptor));
             });
@@ -1595,10 +1692,8 @@ table::make_partition_presence_checker(lw_shared_ptr<sstables::sstable_set> ssta
             return partition_presence_checker_result::definitely_doesnt_exist;
         }
         auto hk = sstables::sstable::make_hashed_key(*_schema, key.key());
-        for (auto&& s : sst) {
-            if (s->filter_has_key(hk)) {
-                return partition_presence_checker_result::maybe_exists;
-            }
+        if (sstables::any_filter_has_key(sst, hk)) {
+            return partition_presence_checker_result::maybe_exists;
         }
         return partition_presence_checker_result::definitely_doesnt_exist;
     };
@@ -2350,11 +2445,13 @@ table::apply(const frozen_mutation& m, const schema_ptr& m_schema, db::rp_handle
 future<>
 write_memtable_to_sstable(memtable& mt, sstables::shared_sstable sst,
                           sstables::write_monitor& monitor,
-                          bool backup, const io_priority_class& pc, bool leave_unsealed) {
+                          bool backup, const io_priority_class& pc, bool leave_unsealed,
+                          compressor_ptr compression_dictionary) {
     sstables::sstable_writer_config cfg;
     cfg.replay_position = mt.replay_position();
     cfg.backup = backup;
     cfg.leave_unsealed = leave_unsealed;
+    cfg.compression_dictionary = std::move(compression_dictionary);
     cfg.monitor = &monitor;
     return sst->write_components(mt.make_flush_reader(mt.schema(), pc), mt.partition_count(),
         mt.schema(), cfg, mt.get_encoding_stats(), pc);
@@ -2401,6 +2498,44 @@ struct query_state {
     }
 };
 
+// Reads which copy more rows than that have to go through a querier, so that
+// they are preempted.
+static constexpr size_t max_rows_read_from_cache_without_reader = 256;
+
+bool
+table::query_from_cache(const schema_ptr& s, const dht::partition_range& range, const query::partition_slice& slice,
+        uint32_t row_limit, gc_clock::time_point query_time, query::result::builder& builder,
+        const query::querier_cache_context& cache_ctx, const tracing::trace_state_ptr& trace_state) {
+    if (_virtual_reader || !_config.enable_cache || slice.options.contains(query::partition_slice::option::bypass_cache)) {
+        return false;
+    }
+    if (!query::is_single_partition(range) || !row_limit || !slice.partition_row_limit()) {
+        return false;
+    }
+    // Continuing a page of a querier which is still alive is cheaper than
+    // copying the partition again, and leaves no querier behind.
+    if (cache_ctx.may_have_querier() || (_config.data_listeners && !_config.data_listeners->empty())) {
+        return false;
+    }
+    auto& pos = range.start()->value();
+    auto dk = pos.as_decorated_key();
+    // Cache holds only what was flushed, the partition must not have newer
+    // data in memtables. Between deferring points the data in memtables and
+    // cache is coherent, see make_reader().
+    for (auto&& mt : *_memtables) {
+        if (mt->contains(dk)) {
+            return false;
+        }
+    }
+    auto m = _cache.read_if_continuous(s, dk, slice, max_rows_read_from_cache_without_reader);
+    if (!m) {
+        return false;
+    }
+    tracing::trace(trace_state, "Read partition {} from cache without a reader", dk);
+    std::move(*m).query(builder, slice, query_time, row_limit);
+    return true;
+}
+
 future<lw_shared_ptr<query::result>>
 table::query(schema_ptr s,
         const query::read_command& cmd,
@@ -2421,6 +2556,9 @@ table::query(schema_ptr s,
         auto& qs = *qs_ptr;
         return do_until(std::bind(&query_state::done, &qs), [this, &qs, trace_state = std::move(trace_state), timeout, cache_ctx = std::move(cache_ctx)] {
             auto&& range = *qs.current_partition_range++;
+            if (query_from_cache(qs.schema, range, qs.cmd.slice, qs.remaining_rows(), qs.cmd.timestamp, qs.builder, cache_ctx, trace_state)) {
+                return make_ready_future<>();
+            }
             return data_query(qs.schema, as_mutation_source(), range, qs.cmd.slice, qs.remaining_rows(),
                               qs.remaining_partitions(), qs.cmd.timestamp, qs.builder, trace_state, timeout, cache_ctx);
         }).then([qs_ptr = std::move(qs_ptr), &qs] {
@@ -37,6 +37,7 @@
 #include "transport/messages/result_message.hh"
 
 #include "db/config.hh"
+#include "service/storage_proxy.hh"
 
 namespace {
 
@@ -259,3 +260,79 @@ SEASTAR_TEST_CASE(test_reverse_type_aggregation) {
         }
     });
 }
+
+// Aggregates read at CL ONE are computed by the replica shards, compare them
+// with the ones computed by the coordinator at CL QUORUM.
+SEASTAR_TEST_CASE(test_partial_aggregates) {
+    return do_with_cql_env_thread([&] (auto& e) {
+        e.execute_cql("CREATE TABLE test (p int, c int, s int static, v bigint, primary key (p, c))").get();
+        int64_t sum = 0;
+        for (int p = 0; p < 100; ++p) {
+            e.execute_cql(format("INSERT INTO test (p, s) VALUES ({:d}, {:d})", p, p)).get();
+            // Every fifth partition has only its static row.
+            if (p % 5 == 0) {
+                continue;
+            }
+            for (int c = 0; c < 10; ++c) {
+                e.execute_cql(format("INSERT INTO test (p, c, v) VALUES ({:d}, {:d}, {:d})", p, c, p * c)).get();
+                sum += p * c;
+            }
+        }
+        const int64_t rows = 80 * 10 + 20;
+
+        // Counts the queries whose aggregates were computed by the replicas.
+        auto pushed_down = [] {
+            return service::get_local_storage_proxy().get_stats().partial_aggregate_queries;
+        };
+        // Only consistency level ONE reads from a single replica, so that the
+        // replicas can aggregate.
+        auto execute = [&] (cql3::prepared_cache_key_type id, db::consistency_level cl) {
+            auto before = pushed_down();
+            auto msg = e.execute_prepared(id, {}, cl).get0();
+            BOOST_REQUIRE_EQUAL(pushed_down() - before, cl == db::consistency_level::ONE ? 1u : 0u);
+            return msg;
+        };
+
+        auto id = e.prepare("SELECT count(*), count(v), sum(v), avg(v), min(p), max(s) FROM test").get0();
+        for (auto cl : {db::consistency_level::ONE, db::consistency_level::QUORUM}) {
+            auto msg = execute(id, cl);
+            assert_that(msg).is_rows().with_size(1).with_row({{long_type->decompose(rows)},
+                                                              {long_type->decompose(int64_t(800))},
+                                                              {long_type->decompose(sum)},
+                                                              {long_type->decompose(sum / 800)},
+                                                              {int32_type->decompose(0)},
+                                                              {int32_type->decompose(99)}});
+        }
+
+        id = e.prepare("SELECT count(*), sum(v) FROM test WHERE p = 7 AND c >= 5").get0();
+        for (auto cl : {db::consistency_level::ONE, db::consistency_level::QUORUM}) {
+            auto msg = execute(id, cl);
+            assert_that(msg).is_rows().with_size(1).with_row({{long_type->decompose(int64_t(5))},
+                                                              {long_type->decompose(int64_t(7 * (5 + 6 + 7 + 8 + 9)))}});
+        }
+
+        id = e.prepare("SELECT count(*), max(v) FROM test WHERE p IN (0, 5, 6)").get0();
+        for (auto cl : {db::consistency_level::ONE, db::consistency_level::QUORUM}) {
+            auto msg = execute(id, cl);
+            assert_that(msg).is_rows().with_size(1).with_row({{long_type->decompose(int64_t(12))},
+                                                              {long_type->decompose(int64_t(54))}});
+        }
+
+        // Replicas can't apply limits or filtering to their partial aggregates,
+        // so such queries are aggregated by the coordinator, at any consistency level.
+        for (auto query : {"SELECT count(*), sum(v) FROM test LIMIT 3",
+                           "SELECT count(*), sum(v) FROM test PER PARTITION LIMIT 2",
+                           "SELECT count(*), sum(v) FROM test WHERE p IN (6, 7) PER PARTITION LIMIT 1 LIMIT 1",
+                           "SELECT count(*), sum(v) FROM test WHERE v > 100 ALLOW FILTERING"}) {
+            id = e.prepare(query).get0();
+            auto expected = e.execute_prepared(id, {}, db::consistency_level::QUORUM).get0();
+            auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(expected);
+            BOOST_REQUIRE(rows);
+            auto before = pushed_down();
+            auto msg = e.execute_prepared(id, {}, db::consistency_level::ONE).get0();
+            BOOST_REQUIRE_EQUAL(pushed_down(), before);
+            auto& expected_rows = rows->rs().result_set().rows();
+            assert_that(msg).is_rows().with_rows({expected_rows.begin(), expected_rows.end()});
+        }
+    });
+}
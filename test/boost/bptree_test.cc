@@ -0,0 +1,437 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "utils/bptree.hh"
+
+struct element {
+    int value;
+    bplus::member_hook hook;
+
+    explicit element(int v) : value(v) { }
+    element(element&& o) noexcept : value(o.value), hook(std::move(o.hook)) { }
+
+    struct compare {
+        // Coarse prefix, so that lookups have to fall back to the comparator.
+        int64_t prefix(const element& e) const { return e.value / 4; }
+        int64_t prefix(int v) const { return v / 4; }
+
+        bool operator()(const element& a, const element& b) const { return a.value < b.value; }
+        bool operator()(const element& a, int b) const { return a.value < b; }
+        bool operator()(int a, const element& b) const { return a < b.value; }
+    };
+};
+
+using tree_type = bplus::tree<element, &element::hook>;
+
+static void check_contents(const tree_type& t, const std::set<int>& expected) {
+    BOOST_REQUIRE_EQUAL(t.size(), expected.size());
+    BOOST_REQUIRE_EQUAL(t.empty(), expected.empty());
+    auto ei = expected.begin();
+    for (auto&& e : t) {
+        BOOST_REQUIRE(ei != expected.end());
+        BOOST_REQUIRE_EQUAL(e.value, *ei);
+        ++ei;
+    }
+    BOOST_REQUIRE(ei == expected.end());
+}
+
+static void check_bounds(const tree_type& t, const std::set<int>& expected, int key) {
+    auto cmp = element::compare();
+    auto lb = t.lower_bound(key, cmp);
+    auto elb = expected.lower_bound(key);
+    BOOST_REQUIRE_EQUAL(lb == t.end(), elb == expected.end());
+    if (elb != expected.end()) {
+        BOOST_REQUIRE_EQUAL(lb->value, *elb);
+    }
+    auto ub = t.upper_bound(key, cmp);
+    auto eub = expected.upper_bound(key);
+    BOOST_REQUIRE_EQUAL(ub == t.end(), eub == expected.end());
+    if (eub != expected.end()) {
+        BOOST_REQUIRE_EQUAL(ub->value, *eub);
+    }
+    auto f = t.find(key, cmp);
+    BOOST_REQUIRE_EQUAL(f != t.end(), expected.count(key) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_insertion_in_order) {
+    tree_type t;
+    std::vector<std::unique_ptr<element>> elements;
+    std::set<int> expected;
+    for (int i = 0; i < 1000; ++i) {
+        elements.emplace_back(std::make_unique<element>(i));
+        t.insert_before(t.end(), *elements.back(), element::compare());
+        expected.insert(i);
+    }
+    check_contents(t, expected);
+    for (int i = -1; i < 1001; ++i) {
+        check_bounds(t, expected, i);
+    }
+    t.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_random_insertion_and_erasure) {
+    std::mt19937 rnd(1234);
+    auto cmp = element::compare();
+    tree_type t;
+    std::vector<std::unique_ptr<element>> elements(4096);
+    std::set<int> expected;
+
+    for (int round = 0; round < 20000; ++round) {
+        int v = std::uniform_int_distribution<int>(0, elements.size() - 1)(rnd);
+        if (elements[v]) {
+            auto i = t.find(v, cmp);
+            BOOST_REQUIRE(i != t.end());
+            auto next = t.erase(i);
+            auto enext = expected.upper_bound(v);
+            BOOST_REQUIRE_EQUAL(next == t.end(), enext == expected.end());
+            if (enext != expected.end()) {
+                BOOST_REQUIRE_EQUAL(next->value, *enext);
+            }
+            BOOST_REQUIRE(!elements[v]->hook.is_linked());
+            elements[v].reset();
+            expected.erase(v);
+        } else {
+            elements[v] = std::make_unique<element>(v);
+            auto i = t.lower_bound(v, cmp);
+            auto j = t.insert_before(i, *elements[v], cmp);
+            BOOST_REQUIRE_EQUAL(j->value, v);
+            expected.insert(v);
+        }
+        if (round % 1000 == 0) {
+            check_contents(t, expected);
+            for (int k = -1; k <= int(elements.size()); k += 7) {
+                check_bounds(t, expected, k);
+            }
+        }
+    }
+    check_contents(t, expected);
+
+    size_t disposed = 0;
+    t.clear_and_dispose([&] (element* e) {
+        BOOST_REQUIRE(!e->hook.is_linked());
+        elements[e->value].reset();
+        ++disposed;
+    });
+    BOOST_REQUIRE_EQUAL(disposed, expected.size());
+    BOOST_REQUIRE(t.empty());
+    BOOST_REQUIRE(t.begin() == t.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_erase_all) {
+    tree_type t;
+    std::vector<std::unique_ptr<element>> elements;
+    for (int i = 0; i < 500; ++i) {
+        elements.emplace_back(std::make_unique<element>(i));
+        t.insert_before(t.end(), *elements.back(), element::compare());
+    }
+    // Erase from the middle outwards, so that inner nodes get emptied in various orders.
+    std::set<int> expected(boost::counting_iterator<int>(0), boost::counting_iterator<int>(500));
+    for (int i = 0; i < 250; ++i) {
+        for (int v : {250 + i, 249 - i}) {
+            t.erase_and_dispose(t.find(v, element::compare()), [&] (element* e) {
+                BOOST_REQUIRE_EQUAL(e->value, v);
+            });
+            expected.erase(v);
+        }
+        if (i % 50 == 0) {
+            check_contents(t, expected);
+        }
+    }
+    BOOST_REQUIRE(t.empty());
+    BOOST_REQUIRE_EQUAL(t.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_erasure_keeps_nodes_half_full) {
+    std::mt19937 rnd(4321);
+    auto cmp = element::compare();
+    tree_type t;
+    std::vector<std::unique_ptr<element>> elements(20000);
+    std::vector<int> values(boost::counting_iterator<int>(0), boost::counting_iterator<int>(elements.size()));
+    std::shuffle(values.begin(), values.end(), rnd);
+    for (int v : values) {
+        elements[v] = std::make_unique<element>(v);
+        t.insert_before(t.lower_bound(v, cmp), *elements[v], cmp);
+    }
+
+    // Keep every 100th element, erasing in random order.
+    std::set<int> expected;
+    std::shuffle(values.begin(), values.end(), rnd);
+    for (int v : values) {
+        if (v % 100) {
+            t.erase(t.iterator_to(*elements[v]));
+            elements[v].reset();
+        } else {
+            expected.insert(v);
+        }
+    }
+    check_contents(t, expected);
+    for (int k = -1; k <= int(elements.size()); k += 7) {
+        check_bounds(t, expected, k);
+    }
+
+    // Nodes other than the root hold at least node_min_fill keys, so there are
+    // at most size / node_min_fill leaves and fewer inner nodes.
+    auto max_nodes = t.size() / bplus::node_min_fill;
+    BOOST_REQUIRE_LE(t.external_memory_usage(), max_nodes * (sizeof(bplus::leaf_node) + sizeof(bplus::inner_node)));
+
+    // A tree built from the remaining elements doesn't take much less memory.
+    tree_type fresh;
+    std::vector<std::unique_ptr<element>> copies;
+    for (int v : expected) {
+        copies.emplace_back(std::make_unique<element>(v));
+        fresh.insert_before(fresh.end(), *copies.back(), cmp);
+    }
+    BOOST_REQUIRE_LE(t.external_memory_usage(), 2 * fresh.external_memory_usage());
+
+    t.clear();
+    fresh.clear();
+    BOOST_REQUIRE_EQUAL(t.external_memory_usage(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_moving_elements_and_trees) {
+    tree_type t;
+    std::vector<std::unique_ptr<element>> elements;
+    std::set<int> expected;
+    for (int i = 0; i < 200; ++i) {
+        elements.emplace_back(std::make_unique<element>(i * 2));
+        t.insert_before(t.end(), *elements.back(), element::compare());
+        expected.insert(i * 2);
+    }
+
+    // Simulate migration of elements by the allocator.
+    for (auto&& e : elements) {
+        auto moved = std::make_unique<element>(std::move(*e));
+        BOOST_REQUIRE(!e->hook.is_linked());
+        BOOST_REQUIRE(moved->hook.is_linked());
+        e = std::move(moved);
+    }
+    check_contents(t, expected);
+    BOOST_REQUIRE_EQUAL(&*t.iterator_to(*elements[17]), elements[17].get());
+
+    tree_type t2(std::move(t));
+    BOOST_REQUIRE(t.empty());
+    check_contents(t2, expected);
+
+    // The moved-to tree must remain fully functional.
+    elements.emplace_back(std::make_unique<element>(7));
+    t2.insert_before(t2.lower_bound(7, element::compare()), *elements.back(), element::compare());
+    expected.insert(7);
+    check_contents(t2, expected);
+    t2.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_iterators_survive_insertions_and_erasures) {
+    std::mt19937 rnd(4321);
+    auto cmp = element::compare();
+    tree_type t;
+    std::vector<std::unique_ptr<element>> elements(2048);
+    for (int v = 0; v < 2048; v += 2) {
+        elements[v] = std::make_unique<element>(v);
+        t.insert_before(t.end(), *elements[v], cmp);
+    }
+    auto it = t.find(1000, cmp);
+    for (int round = 0; round < 5000; ++round) {
+        int v = std::uniform_int_distribution<int>(0, elements.size() - 1)(rnd);
+        if (v == 1000) {
+            continue;
+        }
+        if (elements[v]) {
+            elements[v].reset(); // auto-unlinks
+        } else {
+            elements[v] = std::make_unique<element>(v);
+            t.insert(t.end(), *elements[v], cmp);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(it->value, 1000);
+    BOOST_REQUIRE(it == t.find(1000, cmp));
+
+    // Walk backwards and forwards from the iterator.
+    std::set<int> expected;
+    for (auto&& e : elements) {
+        if (e) {
+            expected.insert(e->value);
+        }
+    }
+    check_contents(t, expected);
+    auto ei = expected.find(1000);
+    for (auto i = it; i != t.begin(); --i, --ei) {
+        BOOST_REQUIRE_EQUAL(i->value, *ei);
+    }
+    BOOST_REQUIRE_EQUAL(t.rbegin()->value, *expected.rbegin());
+    BOOST_REQUIRE_EQUAL(std::prev(t.end())->value, *expected.rbegin());
+    BOOST_REQUIRE(std::equal(t.rbegin(), t.rend(), expected.rbegin(), expected.rend(),
+        [] (const element& e, int v) { return e.value == v; }));
+    t.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_insert_check) {
+    auto cmp = element::compare();
+    tree_type t;
+    element a(1), b(5), c(5), d(3);
+    BOOST_REQUIRE(t.insert_check(t.end(), a, cmp).second);
+    BOOST_REQUIRE(t.insert_check(t.end(), b, cmp).second);
+    auto r = t.insert_check(t.begin(), c, cmp); // wrong hint
+    BOOST_REQUIRE(!r.second);
+    BOOST_REQUIRE_EQUAL(&*r.first, &b);
+    BOOST_REQUIRE(!c.hook.is_linked());
+    r = t.insert_check(t.end(), d, cmp); // wrong hint
+    BOOST_REQUIRE(r.second);
+    BOOST_REQUIRE_EQUAL(&*std::next(t.begin()), &d);
+    BOOST_REQUIRE(tree_type::is_only_member(a) == false);
+    BOOST_REQUIRE_EQUAL(&tree_type::container_of(d), &t);
+    t.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_clone_and_move_between_trees) {
+    auto cmp = element::compare();
+    tree_type src;
+    std::vector<std::unique_ptr<element>> elements;
+    std::set<int> expected;
+    for (int i = 0; i < 300; ++i) {
+        elements.emplace_back(std::make_unique<element>(i * 3));
+        src.insert_before(src.end(), *elements.back(), cmp);
+        expected.insert(i * 3);
+    }
+
+    tree_type copy;
+    copy.clone_from(src, [] (const element& e) { return new element(e.value); }, [] (element* e) { delete e; });
+    check_contents(copy, expected);
+    for (int k = -1; k < 1000; k += 5) {
+        check_bounds(copy, expected, k);
+    }
+    copy.clear_and_dispose([] (element* e) { delete e; });
+
+    // Move every other element to another tree.
+    tree_type dst;
+    std::set<int> moved;
+    for (auto it = src.begin(); it != src.end();) {
+        auto next = std::next(it);
+        if (it->value % 2 == 0) {
+            moved.insert(it->value);
+            expected.erase(it->value);
+            dst.insert_before(dst.end(), *it, cmp);
+        }
+        it = next;
+    }
+    check_contents(src, expected);
+    check_contents(dst, moved);
+    BOOST_REQUIRE_EQUAL(&tree_type::container_of(*elements[0]), &dst);
+    src.clear();
+    dst.clear();
+}
+
+BOOST_AUTO_TEST_CASE(test_many_equal_prefixes) {
+    struct counting_compare {
+        // Only a few distinct prefixes, so that equal ones span many leaves.
+        int64_t prefix(const element& e) const { return e.value / 1000; }
+        int64_t prefix(int v) const { return v / 1000; }
+
+        size_t& calls;
+
+        bool operator()(const element& a, const element& b) const { ++calls; return a.value < b.value; }
+        bool operator()(const element& a, int b) const { ++calls; return a.value < b; }
+        bool operator()(int a, const element& b) const { ++calls; return a < b.value; }
+    };
+
+    std::mt19937 rnd(5678);
+    size_t calls = 0;
+    auto cmp = counting_compare{calls};
+    tree_type t;
+    std::vector<std::unique_ptr<element>> elements(4000);
+    std::set<int> expected;
+
+    std::vector<int> values(boost::counting_iterator<int>(0), boost::counting_iterator<int>(elements.size()));
+    std::shuffle(values.begin(), values.end(), rnd);
+    for (int v : values) {
+        elements[v] = std::make_unique<element>(v);
+        auto j = t.insert_before(t.lower_bound(v, cmp), *elements[v], cmp);
+        BOOST_REQUIRE_EQUAL(j->value, v);
+        expected.insert(v);
+    }
+    check_contents(t, expected);
+
+    auto check = [&] (int key) {
+        auto lb = t.lower_bound(key, cmp);
+        auto elb = expected.lower_bound(key);
+        BOOST_REQUIRE_EQUAL(lb == t.end(), elb == expected.end());
+        if (elb != expected.end()) {
+            BOOST_REQUIRE_EQUAL(lb->value, *elb);
+        }
+        auto ub = t.upper_bound(key, cmp);
+        auto eub = expected.upper_bound(key);
+        BOOST_REQUIRE_EQUAL(ub == t.end(), eub == expected.end());
+        if (eub != expected.end()) {
+            BOOST_REQUIRE_EQUAL(ub->value, *eub);
+        }
+        BOOST_REQUIRE_EQUAL(t.find(key, cmp) != t.end(), expected.count(key) == 1);
+    };
+
+    for (int k = -1; k <= int(elements.size()); ++k) {
+        check(k);
+    }
+
+    // Erase half of the elements, so that separators no longer match the remaining
+    // elements, and insert some of them back.
+    for (int round = 0; round < 4000; ++round) {
+        int v = std::uniform_int_distribution<int>(0, elements.size() - 1)(rnd);
+        if (elements[v] && round % 3) {
+            t.erase(t.iterator_to(*elements[v]));
+            elements[v].reset();
+            expected.erase(v);
+        } else if (!elements[v]) {
+            elements[v] = std::make_unique<element>(v);
+            t.insert_before(t.lower_bound(v, cmp), *elements[v], cmp);
+            expected.insert(v);
+        }
+    }
+    check_contents(t, expected);
+    for (int k = -1; k <= int(elements.size()); ++k) {
+        check(k);
+    }
+
+    // Lookups among a thousand elements with the same prefix must not scan them.
+    calls = 0;
+    t.lower_bound(1999, cmp);
+    t.upper_bound(1000, cmp);
+    BOOST_REQUIRE_LT(calls, 100);
+
+    // Consume the tree from the left.
+    auto ei = expected.begin();
+    while (auto e = t.unlink_leftmost_without_rebalance()) {
+        BOOST_REQUIRE_EQUAL(e->value, *ei++);
+        BOOST_REQUIRE(!e->hook.is_linked());
+        if (ei != expected.end()) {
+            BOOST_REQUIRE_EQUAL(t.begin()->value, *ei);
+        }
+    }
+    BOOST_REQUIRE(ei == expected.end());
+    BOOST_REQUIRE(t.empty());
+}
@@ -22,12 +22,14 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 
 #include <stdlib.h>
 #include <iostream>
 #include <unordered_map>
 #include <unordered_set>
 #include <set>
+#include <map>
 
 #include <seastar/testing/test_case.hh>
 #include <seastar/core/future-util.hh>
@@ -35,6 +37,7 @@
 #include <seastar/core/scollectd_api.hh>
 #include <seastar/core/file.hh>
 #include <seastar/core/reactor.hh>
+#include <seastar/core/thread.hh>
 #include <seastar/util/noncopyable_function.hh>
 #include "utils/UUID_gen.hh"
 #include "test/lib/tmpdir.hh"
@@ -400,6 +403,52 @@ SEASTAR_TEST_CASE(test_commitlog_reader){
         });
 }
 
+static future<> test_commitlog_compressed_segments(commitlog::compression compression) {
+    commitlog::config cfg;
+    cfg.commitlog_segment_size_in_mb = 1;
+    cfg.segment_compression = compression;
+    return cl_test(cfg, [](commitlog& log) {
+        return seastar::async([&log] {
+            auto uuid = utils::UUID_gen::get_time_UUID();
+            std::map<db::replay_position, sstring> written;
+            // Compressible entries of various sizes, some larger than a buffer fragment,
+            // enough of them to fill several segments.
+            for (auto i : boost::irange(0, 2000)) {
+                auto tmp = sstring(format("hej bubba cow {:d} ", i)) + sstring(i % 100 == 0 ? 200 * 1024 : i % 700, 'x');
+                auto h = log.add_mutation(uuid, tmp.size(), db::commitlog::force_sync::no, [tmp](db::commitlog::output& dst) {
+                    dst.write(tmp.data(), tmp.size());
+                }).get0();
+                written.emplace(h.release(), std::move(tmp));
+            }
+            log.sync_all_segments().get();
+
+            auto segments = log.get_active_segment_names();
+            BOOST_REQUIRE(segments.size() > 1);
+
+            std::map<db::replay_position, sstring> read;
+            for (auto&& seg : segments) {
+                BOOST_REQUIRE_EQUAL(commitlog::descriptor(seg).ver, 2u);
+                db::commitlog::read_log_file(seg, db::commitlog::descriptor::FILENAME_PREFIX, service::get_local_commitlog_priority(), [&read](db::commitlog::buffer_and_replay_position buf_rp) {
+                    auto&& [buf, rp] = buf_rp;
+                    auto linearization_buffer = bytes_ostream();
+                    auto in = buf.get_istream();
+                    read.emplace(rp, sstring(to_sstring_view(in.read_bytes_view(buf.size_bytes(), linearization_buffer))));
+                    return make_ready_future<>();
+                }).get();
+            }
+            BOOST_REQUIRE(read == written);
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_commitlog_lz4_compressed_segments) {
+    return test_commitlog_compressed_segments(commitlog::compression::lz4);
+}
+
+SEASTAR_TEST_CASE(test_commitlog_zstd_compressed_segments) {
+    return test_commitlog_compressed_segments(commitlog::compression::zstd);
+}
+
 static future<> corrupt_segment(sstring seg, uint64_t off, uint32_t value) {
     return open_file_dma(seg, open_flags::rw).then([off, value](file f) {
         size_t size = align_up<size_t>(off, 4096);
@@ -533,6 +582,57 @@ SEASTAR_TEST_CASE(test_commitlog_reader_produce_exception){
         });
 }
 
+SEASTAR_TEST_CASE(test_commitlog_reuse_segments_o_dsync) {
+    commitlog::config cfg;
+    cfg.commitlog_segment_size_in_mb = 1;
+    cfg.commitlog_total_space_in_mb = 64;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.use_o_dsync = true;
+    return cl_test(cfg, [](commitlog& log) {
+            auto count = make_lw_shared<size_t>(0);
+            auto uuid = utils::UUID_gen::get_time_UUID();
+            // Entries are released right away, so filled segments get recycled.
+            return do_until([&log, count] { return log.get_num_segments_recycled() > 0 || *count >= 2048; },
+                    [&log, count, uuid] {
+                        ++*count;
+                        size_t size = 32 * 1024;
+                        return log.add_mutation(uuid, size, db::commitlog::force_sync::no, [size](db::commitlog::output& dst) {
+                                    dst.fill(char(1), size);
+                                }).discard_result();
+                    }).then([&log] {
+                        BOOST_REQUIRE_GT(log.get_num_segments_recycled(), 0);
+                    });
+        });
+}
+
+SEASTAR_TEST_CASE(test_commitlog_batch_group_commit) {
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::BATCH;
+    cfg.batch_window = std::chrono::milliseconds(2);
+    return cl_test(cfg, [](commitlog& log) {
+            auto uuid = utils::UUID_gen::get_time_UUID();
+            // Concurrent writers, each waiting for its write to be synced before
+            // issuing the next one, like clients do. Without a window their writes
+            // drift apart and most of them end up synced on their own.
+            constexpr int writers = 20;
+            constexpr int writes_per_writer = 50;
+            return parallel_for_each(boost::irange(0, writers), [&log, uuid] (int) {
+                return do_for_each(boost::irange(0, writes_per_writer), [&log, uuid] (int) {
+                    sstring tmp = "hej bubba cow";
+                    return log.add_mutation(uuid, tmp.size(), db::commitlog::force_sync::no, [tmp](db::commitlog::output& dst) {
+                                dst.write(tmp.data(), tmp.size());
+                            }).then([](db::rp_handle h) {
+                                BOOST_CHECK_NE(h.rp(), db::replay_position());
+                            });
+                });
+            }).then([&log, writers, writes_per_writer] {
+                BOOST_REQUIRE_GT(log.get_num_group_commit_windows(), 0);
+                // Each sync covers several writes on average.
+                BOOST_REQUIRE_LT(log.get_flush_count(), writers * writes_per_writer / 4);
+            });
+        });
+}
+
 SEASTAR_TEST_CASE(test_commitlog_counters) {
     auto count_cl_counters = []() -> size_t {
         auto ids = scollectd::get_collectd_ids();
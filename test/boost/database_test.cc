@@ -81,6 +81,52 @@ SEASTAR_TEST_CASE(test_safety_after_truncate) {
     }, cfg);
 }
 
+SEASTAR_TEST_CASE(test_commitlog_replay_progress) {
+    return do_with_cql_env_thread([](cql_test_env& e) {
+        e.execute_cql("create table ks.cf (k text, v int, primary key (k));").get();
+        auto& db = e.local_db();
+        auto s = db.find_schema("ks", "cf");
+        dht::partition_range_vector pranges;
+
+        for (uint32_t i = 1; i <= 1000; ++i) {
+            auto pkey = partition_key::from_single_value(*s, to_bytes(format("key{:d}", i)));
+            mutation m(s, pkey);
+            m.set_clustered_cell(clustering_key_prefix::make_empty(), "v", int32_t(i), {});
+            pranges.emplace_back(dht::partition_range::make_singular(dht::global_partitioner().decorate_key(*s, std::move(pkey))));
+            db.apply(s, freeze(m), db::commitlog::force_sync::no).get();
+        }
+        db.commitlog()->sync_all_segments().get();
+
+        auto rp = db::commitlog_replayer::create_replayer(e.db()).get0();
+        auto paths = db.commitlog()->list_existing_segments().get0();
+        rp.recover(paths, db::commitlog::descriptor::FILENAME_PREFIX).get();
+
+        using progress = db::commitlog_replayer::progress;
+        auto p = e.db().map_reduce0([] (database&) {
+            return db::commitlog_replayer::local_progress();
+        }, progress(), [] (progress a, const progress& b) {
+            a.segments_total += b.segments_total;
+            a.segments_replayed += b.segments_replayed;
+            a.bytes_total += b.bytes_total;
+            a.bytes_replayed += b.bytes_replayed;
+            a.applied_mutations += b.applied_mutations;
+            a.active |= b.active;
+            return a;
+        }).get0();
+        BOOST_REQUIRE(!p.active);
+        BOOST_REQUIRE_EQUAL(p.segments_total, paths.size());
+        BOOST_REQUIRE_EQUAL(p.segments_replayed, paths.size());
+        BOOST_REQUIRE_EQUAL(p.bytes_replayed, p.bytes_total);
+        BOOST_REQUIRE_GE(p.applied_mutations, 1000);
+
+        // Replay is idempotent.
+        auto max_size = std::numeric_limits<size_t>::max();
+        auto cmd = query::read_command(s->id(), s->version(), partition_slice_builder(*s).build(), 1000);
+        auto result = db.query(s, cmd, query::result_options::only_result(), pranges, nullptr, max_size).get0();
+        assert_that(query::result_set::from_raw_result(s, cmd.slice, *result)).has_size(1000);
+    });
+}
+
 SEASTAR_TEST_CASE(test_querying_with_limits) {
     return do_with_cql_env([](cql_test_env& e) {
         return seastar::async([&] {
@@ -208,6 +208,41 @@ SEASTAR_THREAD_TEST_CASE(combined_reader_galloping_changing_multiple_partitions_
         .produces_end_of_stream();
 }
 
+// Readers holding runs of consecutive partitions, some of which overlap
+// with other readers, as sstables of different size tiers do.
+SEASTAR_THREAD_TEST_CASE(combined_reader_partition_runs_test) {
+    simple_schema s;
+
+    const auto k = s.make_pkeys(64);
+
+    for (auto nr_readers : {2, 3, 8, 33}) {
+        std::vector<std::vector<mutation>> mss(nr_readers);
+        std::vector<mutation> expected;
+        for (auto i = 0u; i < k.size(); ++i) {
+            auto r = (i / 4) % nr_readers;
+            if (i % 7 == 0) {
+                // Half of the rows come from the next reader.
+                mss[r].push_back(make_partition_with_clustering_rows(s, k[i], boost::irange(0, 5)));
+                mss[(r + 1) % nr_readers].push_back(make_partition_with_clustering_rows(s, k[i], boost::irange(5, 10)));
+            } else {
+                mss[r].push_back(make_partition_with_clustering_rows(s, k[i], boost::irange(0, 10)));
+            }
+            expected.push_back(make_partition_with_clustering_rows(s, k[i], boost::irange(0, 10)));
+        }
+
+        std::vector<flat_mutation_reader> v;
+        for (auto& ms : mss) {
+            std::sort(ms.begin(), ms.end(), mutation_decorated_key_less_comparator());
+            v.push_back(flat_mutation_reader_from_mutations(std::move(ms)));
+        }
+        auto rd = assert_that(make_combined_reader(s.schema(), std::move(v), streamed_mutation::forwarding::no, mutation_reader::forwarding::no));
+        for (auto& m : expected) {
+            rd.produces(m);
+        }
+        rd.produces_end_of_stream();
+    }
+}
+
 static mutation make_mutation_with_key(schema_ptr s, dht::decorated_key dk) {
     mutation m(s, std::move(dk));
     m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(bytes("v1")), 1);
@@ -1134,6 +1169,43 @@ SEASTAR_TEST_CASE(reader_restriction_file_tracking) {
     });
 }
 
+SEASTAR_TEST_CASE(reader_permit_tracks_memory_against_base_cost) {
+    return async([&] {
+        reader_concurrency_semaphore semaphore(100, 8 * 1024, get_name());
+
+        {
+            auto permit = semaphore.wait_admission(4 * 1024).get0();
+            BOOST_REQUIRE_EQUAL(4 * 1024, semaphore.available_resources().memory);
+
+            auto units1 = permit.get_memory_units(3 * 1024);
+            // Covered by the base cost.
+            BOOST_REQUIRE_EQUAL(4 * 1024, semaphore.available_resources().memory);
+
+            auto units2 = permit.get_memory_units(3 * 1024);
+            BOOST_REQUIRE_EQUAL(2 * 1024, semaphore.available_resources().memory);
+
+            units1.reset();
+            BOOST_REQUIRE_EQUAL(4 * 1024, semaphore.available_resources().memory);
+
+            units2.increase(4 * 1024);
+            BOOST_REQUIRE_EQUAL(1 * 1024, semaphore.available_resources().memory);
+
+            units2.decrease(2 * 1024);
+            BOOST_REQUIRE_EQUAL(3 * 1024, semaphore.available_resources().memory);
+
+            // Memory units outliving the permit keep accounting for it.
+            auto units3 = std::make_unique<reader_permit::memory_units>(permit.get_memory_units(1024));
+            units2.reset();
+            permit = no_reader_permit();
+            BOOST_REQUIRE_EQUAL(4 * 1024, semaphore.available_resources().memory);
+
+            units3.reset();
+        }
+
+        BOOST_REQUIRE_EQUAL(8 * 1024, semaphore.available_resources().memory);
+    });
+}
+
 SEASTAR_TEST_CASE(restricted_reader_reading) {
     return sstables::test_env::do_with_async([&] (sstables::test_env& env) {
         storage_service_for_tests ssft;
@@ -2087,8 +2159,9 @@ SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_as_mutation_source) {
     }
 
     do_with_cql_env([] (cql_test_env& env) -> future<> {
-        auto make_populate = [] (bool evict_paused_readers, bool single_fragment_buffer) {
-            return [evict_paused_readers, single_fragment_buffer] (schema_ptr s, const std::vector<mutation>& mutations) mutable {
+        auto make_populate = [] (bool evict_paused_readers, bool single_fragment_buffer,
+                multishard_reader_concurrency concurrency = {}) {
+            return [evict_paused_readers, single_fragment_buffer, concurrency] (schema_ptr s, const std::vector<mutation>& mutations) mutable {
                 // We need to group mutations that have the same token so they land on the same shard.
                 std::map<dht::token, std::vector<frozen_mutation>> mutations_by_token;
 
@@ -2117,7 +2190,7 @@ SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_as_mutation_source) {
                     remote_memtables->emplace_back(std::move(remote_mt));
                 }
 
-                return mutation_source([partitioner, remote_memtables, evict_paused_readers, single_fragment_buffer] (schema_ptr s,
+                return mutation_source([partitioner, remote_memtables, evict_paused_readers, single_fragment_buffer, concurrency] (schema_ptr s,
                         reader_permit,
                         const dht::partition_range& range,
                         const query::partition_slice& slice,
@@ -2141,7 +2214,8 @@ SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_as_mutation_source) {
                     };
 
                     auto lifecycle_policy = seastar::make_shared<test_reader_lifecycle_policy>(std::move(factory), evict_paused_readers);
-                    auto mr = make_multishard_combining_reader(std::move(lifecycle_policy), *partitioner, s, range, slice, pc, trace_state, fwd_mr);
+                    auto mr = make_multishard_combining_reader(std::move(lifecycle_policy), *partitioner, s, range, slice, pc, trace_state, fwd_mr,
+                            concurrency);
                     if (fwd_sm == streamed_mutation::forwarding::yes) {
                         return make_forwardable(std::move(mr));
                     }
@@ -2159,6 +2233,9 @@ SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_as_mutation_source) {
         BOOST_TEST_MESSAGE("run_mutation_source_tests(evict_readers=true, single_fragment_buffer=true)");
         run_mutation_source_tests(make_populate(true, true));
 
+        BOOST_TEST_MESSAGE("run_mutation_source_tests(evict_readers=true, single_fragment_buffer=true, parallel)");
+        run_mutation_source_tests(make_populate(true, true, multishard_reader_concurrency::parallel(smp::count)));
+
         return make_ready_future<>();
     }).get();
 }
@@ -2201,6 +2278,61 @@ SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_reading_empty_table) {
     }).get();
 }
 
+// The shard reader should read more at once from a shard which the
+// multishard reader keeps waiting for.
+SEASTAR_THREAD_TEST_CASE(test_multishard_combining_reader_adaptive_fill_size) {
+    do_with_cql_env([] (cql_test_env& env) -> future<> {
+        simple_schema s;
+        auto pkey = s.make_pkey(0);
+        const auto shard = dht::global_partitioner().shard_of(pkey.token());
+
+        mutation m(s.schema(), pkey);
+        const auto value = sstring(1024, 'v');
+        for (uint32_t ck = 0; ck < 2048; ++ck) {
+            s.add_row(m, s.make_ckey(ck), value);
+        }
+        auto fm = freeze(m);
+
+        auto factory = [gs = global_simple_schema(s), &fm, shard] (
+                schema_ptr,
+                const dht::partition_range& range,
+                const query::partition_slice& slice,
+                const io_priority_class& pc,
+                tracing::trace_state_ptr trace_state,
+                mutation_reader::forwarding fwd_mr) {
+            auto s = gs.get();
+            if (engine().cpu_id() != shard) {
+                return make_empty_flat_reader(s.schema());
+            }
+            auto mt = make_lw_shared<memtable>(s.schema());
+            mt->apply(fm.unfreeze(s.schema()));
+            return mt->make_flat_reader(s.schema(), range, slice, pc, std::move(trace_state), streamed_mutation::forwarding::no, fwd_mr);
+        };
+
+        const auto stats_before = get_multishard_reader_stats();
+
+        assert_that(make_multishard_combining_reader(
+                    seastar::make_shared<test_reader_lifecycle_policy>(std::move(factory)),
+                    dht::global_partitioner(),
+                    s.schema(),
+                    query::full_partition_range,
+                    s.schema()->full_slice(),
+                    service::get_local_sstable_query_read_priority()))
+                .produces(m)
+                .produces_end_of_stream();
+
+        const auto& stats = get_multishard_reader_stats();
+        const auto fills = stats.cross_shard_fills - stats_before.cross_shard_fills;
+        const auto fill_bytes = stats.cross_shard_fill_bytes - stats_before.cross_shard_fill_bytes;
+        BOOST_REQUIRE_GE(fill_bytes, 2048 * value.size());
+        // With fixed 8KB fills the partition would take ~256 round trips.
+        BOOST_REQUIRE_LT(fills, smp::count + 64);
+        BOOST_REQUIRE_GT(stats.cross_shard_stalls, stats_before.cross_shard_stalls);
+
+        return make_ready_future<>();
+    }).get();
+}
+
 // A reader that can controlled by it's "creator" after it's created.
 //
 // It can execute one of a set of actions on it's fill_buffer() call:
@@ -3048,3 +3048,72 @@ SEASTAR_THREAD_TEST_CASE(test_compaction_data_stream_split) {
         run_compaction_data_stream_split_test(schema, query_time, mutations);
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(test_clustering_prefix_is_consistent_with_ordering) {
+    auto random_int = [] (auto min, auto max) {
+        return std::uniform_int_distribution<decltype(min)>(min, max)(tests::random::gen());
+    };
+    auto random_text = [&] {
+        return tests::random::get_sstring(random_int(0, 12));
+    };
+    std::vector<std::pair<data_type, std::function<bytes()>>> cases = {
+        {int32_type, [&] { return int32_type->decompose(random_int(-5, 5)); }},
+        {int32_type, [&] { return int32_type->decompose(random_int(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())); }},
+        {long_type, [&] { return long_type->decompose(random_int(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max())); }},
+        {utf8_type, [&] { return utf8_type->decompose(random_text()); }},
+        {bytes_type, [&] { return tests::random::get_bytes(random_int(0, 12)); }},
+        {timeuuid_type, [&] { return timeuuid_type->decompose(utils::UUID_gen::get_time_UUID(random_int(int64_t(0), int64_t(1) << 40))); }},
+        {reversed_type_impl::get_instance(int32_type), [&] { return int32_type->decompose(random_int(-5, 5)); }},
+        {reversed_type_impl::get_instance(utf8_type), [&] { return utf8_type->decompose(random_text()); }},
+        {double_type, [&] { return double_type->decompose(double(random_int(-5, 5))); }},
+    };
+
+    for (auto&& [type, gen] : cases) {
+        auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck1", type, column_kind::clustering_key)
+            .with_column("ck2", int32_type, column_kind::clustering_key)
+            .with_column("v", int32_type)
+            .build();
+        rows_entry::tri_compare cmp(*s);
+
+        std::vector<position_in_partition> positions;
+        positions.emplace_back(position_in_partition::for_static_row());
+        positions.emplace_back(position_in_partition::before_all_clustered_rows());
+        positions.emplace_back(position_in_partition::after_all_clustered_rows());
+        for (int i = 0; i < 30; ++i) {
+            auto v = gen();
+            positions.emplace_back(position_in_partition::for_key(clustering_key::from_exploded(*s, {v, int32_type->decompose(i)})));
+            auto prefix = clustering_key_prefix::from_exploded(*s, {v});
+            positions.emplace_back(position_in_partition::for_range_start(query::clustering_range::make_starting_with({prefix, true})));
+            positions.emplace_back(position_in_partition::for_range_end(query::clustering_range::make_ending_with({prefix, true})));
+        }
+        // Empty values sort before everything else.
+        positions.emplace_back(position_in_partition::for_key(clustering_key::from_exploded(*s, {bytes(), int32_type->decompose(0)})));
+
+        for (auto&& a : positions) {
+            for (auto&& b : positions) {
+                if (cmp.prefix(a) < cmp.prefix(b)) {
+                    BOOST_REQUIRE(cmp(a, b) < 0);
+                }
+            }
+        }
+
+        // Rows must end up in clustering order regardless of the prefix.
+        mutation_partition mp(s);
+        for (auto&& p : positions) {
+            if (p.is_clustering_row()) {
+                mp.clustered_row(*s, p.key());
+            }
+        }
+        position_in_partition::less_compare less(*s);
+        BOOST_REQUIRE(std::is_sorted(mp.clustered_rows().begin(), mp.clustered_rows().end(), [&] (const rows_entry& a, const rows_entry& b) {
+            return less(a.position(), b.position());
+        }));
+        for (auto&& p : positions) {
+            if (p.is_clustering_row()) {
+                BOOST_REQUIRE(mp.find_row(*s, p.key()));
+            }
+        }
+    }
+}
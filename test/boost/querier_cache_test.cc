@@ -109,16 +109,6 @@ class test_querier_cache {
         return mutations;
     }
 
-    template <typename Querier>
-    Querier make_querier(const dht::partition_range& range) {
-        return Querier(_mutation_source,
-            _s.schema(),
-            range,
-            _s.schema()->full_slice(),
-            service::get_local_sstable_query_read_priority(),
-            nullptr);
-    }
-
     static utils::UUID make_cache_key(unsigned key) {
         return utils::UUID{key, 1};
     }
@@ -189,6 +179,20 @@ class test_querier_cache {
         return _sem;
     }
 
+    query::querier_cache& get_querier_cache() {
+        return _cache;
+    }
+
+    template <typename Querier>
+    Querier make_querier(const dht::partition_range& range) {
+        return Querier(_mutation_source,
+            _s.schema(),
+            range,
+            _s.schema()->full_slice(),
+            service::get_local_sstable_query_read_priority(),
+            nullptr);
+    }
+
     dht::partition_range make_partition_range(bound begin, bound end) const {
         return dht::partition_range::make({_mutations.at(begin.value()).decorated_key(), begin.is_inclusive()},
                 {_mutations.at(end.value()).decorated_key(), end.is_inclusive()});
@@ -570,6 +574,80 @@ SEASTAR_THREAD_TEST_CASE(test_time_based_cache_eviction) {
     BOOST_REQUIRE_EQUAL(t.get_semaphore().get_inactive_read_stats().population, 0);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_range_scan_entry_ttl) {
+    test_querier_cache t(1s);
+    t.get_querier_cache().set_range_scan_entry_ttl(24h);
+
+    const auto range_entry = t.produce_first_page_and_save_data_querier(1);
+    const auto singular_entry = t.produce_first_page_and_save_data_querier(2, std::size_t(0));
+
+    seastar::sleep(2s).get();
+
+    t.assert_cache_lookup_data_querier(singular_entry.key, *t.get_schema(), singular_entry.expected_range, singular_entry.expected_slice)
+        .misses()
+        .no_drops()
+        .time_based_evictions();
+
+    t.assert_cache_lookup_data_querier(range_entry.key, *t.get_schema(), range_entry.expected_range, range_entry.expected_slice)
+        .no_misses()
+        .no_drops()
+        .no_evictions();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_range_scan_read_ahead) {
+    test_querier_cache t;
+    auto& cache = t.get_querier_cache();
+    const size_t read_ahead_size = 64 * 1024;
+    cache.set_read_ahead_size(read_ahead_size);
+
+    // Singular ranges don't read ahead.
+    t.produce_first_page_and_save_data_querier(1, std::size_t(0));
+    BOOST_REQUIRE_EQUAL(cache.get_stats().read_aheads, 0);
+    const auto singular_memory_usage = cache.get_stats().memory_usage;
+    BOOST_REQUIRE_LT(singular_memory_usage, read_ahead_size);
+
+    const auto initial_memory = t.get_semaphore().available_resources().memory;
+
+    // The first page stops at the first row of the second partition.
+    const auto entry = t.produce_first_page_and_save_data_querier(2);
+    BOOST_REQUIRE_EQUAL(cache.get_stats().read_aheads, 1);
+    BOOST_REQUIRE_EQUAL(cache.get_stats().memory_usage, singular_memory_usage + read_ahead_size);
+    // The read-ahead is accounted for by the semaphore.
+    BOOST_REQUIRE_LT(t.get_semaphore().available_resources().memory, initial_memory);
+    BOOST_REQUIRE_GE(t.get_semaphore().available_resources().memory, initial_memory - ssize_t(read_ahead_size));
+
+    auto q = cache.lookup_data_querier(utils::UUID{2, 1}, *t.get_schema(), entry.expected_range, entry.expected_slice, nullptr);
+    BOOST_REQUIRE(q);
+    BOOST_REQUIRE_EQUAL(cache.get_stats().memory_usage, singular_memory_usage);
+
+    // The next page continues from the data read ahead, with the rest of
+    // the second partition and the first row of the third one.
+    auto [dk, ck] = q->consume_page(dummy_result_builder{}, 5, std::numeric_limits<uint32_t>::max(), gc_clock::now(), db::no_timeout).get0();
+    BOOST_REQUIRE(dk);
+    BOOST_REQUIRE(dk->equal(*t.get_schema(), t.make_singular_partition_range(2).start()->value().as_decorated_key()));
+    BOOST_REQUIRE_EQUAL(t.get_semaphore().available_resources().memory, initial_memory);
+
+    // Evicting a querier gives the memory of its read-ahead back at once.
+    t.produce_first_page_and_save_data_querier(3);
+    BOOST_REQUIRE_EQUAL(cache.get_stats().read_aheads, 2);
+    BOOST_REQUIRE_LT(t.get_semaphore().available_resources().memory, initial_memory);
+    while (t.get_semaphore().try_evict_one_inactive_read());
+    BOOST_REQUIRE_EQUAL(t.get_semaphore().available_resources().memory, initial_memory);
+
+    // No read-ahead is started when it would make other reads wait.
+    {
+        reader_concurrency_semaphore sem(100, read_ahead_size / 2, "test_range_scan_read_ahead");
+        auto q = t.make_querier<query::data_querier>(t.make_partition_range({1, true}, {3, false}));
+        seastar::gate gate;
+        q.read_ahead(gate, sem, read_ahead_size, db::no_timeout);
+        BOOST_REQUIRE(!q.is_reading_ahead());
+        BOOST_REQUIRE_EQUAL(sem.available_resources().memory, ssize_t(read_ahead_size / 2));
+    }
+
+    q.reset();
+    cache.stop().get();
+}
+
 sstring make_string_blob(size_t size) {
     const char* const letters = "abcdefghijklmnoqprsuvwxyz";
     std::random_device rd;
@@ -1028,6 +1028,71 @@ SEASTAR_TEST_CASE(test_single_partition_update) {
     });
 }
 
+SEASTAR_TEST_CASE(test_read_if_continuous) {
+    return seastar::async([] {
+        auto s = schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("v", int32_type)
+            .build();
+        auto make_dk = [&s] (int v) {
+            return dht::global_partitioner().decorate_key(*s, partition_key::from_exploded(*s, { int32_type->decompose(v) }));
+        };
+        auto make_ck = [&s] (int v) {
+            return clustering_key_prefix::from_single_value(*s, int32_type->decompose(v));
+        };
+        auto dk = make_dk(100);
+        auto range = dht::partition_range::make_singular(dk);
+        memtable_snapshot_source cache_mt(s);
+        mutation m(s, dk);
+        for (int ck : {1, 2, 4, 7}) {
+            m.set_clustered_cell(make_ck(ck), "v", data_value(101), 1);
+        }
+        cache_mt.apply(m);
+
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source([&] { return cache_mt(); }), tracker);
+        auto& full_slice = s->full_slice();
+
+        BOOST_REQUIRE(!cache.read_if_continuous(s, dk, full_slice, query::max_rows));
+
+        auto ck_ranges = query::clustering_row_ranges{query::clustering_range::make_ending_with(make_ck(2))};
+        auto slice = partition_slice_builder(*s)
+            .with_ranges(ck_ranges)
+            .build();
+        assert_that(cache.make_reader(s, range, slice))
+            .produces(m, ck_ranges)
+            .produces_end_of_stream();
+
+        // Only the rows selected by the first read are continuous.
+        auto mo = cache.read_if_continuous(s, dk, slice, query::max_rows);
+        BOOST_REQUIRE(mo);
+        assert_that(*mo).is_equal_to(m, ck_ranges);
+        BOOST_REQUIRE(!cache.read_if_continuous(s, dk, full_slice, query::max_rows));
+
+        assert_that(cache.make_reader(s, range))
+            .produces(m)
+            .produces_end_of_stream();
+
+        mo = cache.read_if_continuous(s, dk, full_slice, query::max_rows);
+        BOOST_REQUIRE(mo);
+        assert_that(*mo).is_equal_to(m);
+
+        // Reads of too many rows are left to readers.
+        BOOST_REQUIRE(!cache.read_if_continuous(s, dk, full_slice, 2));
+
+        // Partitions which cache knows are absent are empty.
+        assert_that(cache.make_reader(s, query::full_partition_range))
+            .produces(m)
+            .produces_end_of_stream();
+        mo = cache.read_if_continuous(s, make_dk(101), full_slice, query::max_rows);
+        BOOST_REQUIRE(mo);
+        BOOST_REQUIRE(mo->partition().empty());
+
+        BOOST_REQUIRE_EQUAL(tracker.get_stats().reads_without_reader, 3);
+    });
+}
+
 SEASTAR_TEST_CASE(test_update) {
     return seastar::async([] {
         auto s = make_schema();
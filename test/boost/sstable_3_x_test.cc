@@ -52,6 +52,7 @@
 #include "sstables/mc/writer.hh"
 #include "test/lib/simple_schema.hh"
 #include "test/lib/exception_utils.hh"
+#include "db/bloom_filter_format_extension.hh"
 
 using namespace sstables;
 
@@ -99,6 +100,18 @@ class sstable_assertions final {
         return _sst->get_stats_metadata();
     }
 
+    bool has_compression_dictionary() const {
+        return _sst->has_compression_dictionary();
+    }
+
+    bool has_split_block_filter() const {
+        return _sst->has_split_block_filter();
+    }
+
+    bool filter_has_key(const schema& s, const partition_key& key) const {
+        return _sst->filter_has_key(s, key);
+    }
+
     flat_mutation_reader read_range_rows_flat(
             const dht::partition_range& range,
             const query::partition_slice& slice,
@@ -3609,7 +3622,7 @@ SEASTAR_THREAD_TEST_CASE(test_write_multiple_partitions) {
     validate_stats_metadata(s, written_sst, table_name);
 }
 
-static void test_write_many_partitions(sstring table_name, tombstone partition_tomb, compression_parameters cp) {
+static sstable_assertions test_write_many_partitions(sstring table_name, tombstone partition_tomb, compression_parameters cp) {
     // CREATE TABLE <table_name> (pk int, PRIMARY KEY (pk)) WITH compression = {'sstable_compression': ''};
     schema_builder builder("sst3", table_name);
     builder.with_column("pk", int32_type, column_kind::partition_key);
@@ -3632,7 +3645,7 @@ static void test_write_many_partitions(sstring table_name, tombstone partition_t
     test_env env;
     tmpdir tmp = compressed ? write_sstables(env, s, mt) : write_and_compare_sstables(s, mt, table_name);
     boost::sort(muts, mutation_decorated_key_less_comparator());
-    validate_read(s, tmp.path(), muts);
+    return validate_read(s, tmp.path(), muts);
 }
 
 SEASTAR_THREAD_TEST_CASE(test_write_many_live_partitions) {
@@ -3685,6 +3698,106 @@ SEASTAR_THREAD_TEST_CASE(test_write_many_partitions_zstd) {
             })});
 }
 
+SEASTAR_THREAD_TEST_CASE(test_write_many_partitions_zstd_with_dictionary) {
+    auto abj = defer([] { await_background_jobs().get(); });
+    auto sst = test_write_many_partitions(
+            "many_partitions_zstd_dictionary",
+            tombstone{},
+            compression_parameters{compressor::create({
+                {"sstable_compression", "org.apache.cassandra.io.compress.ZstdCompressor"},
+                {"dictionary_size_kb", "2"}
+            })});
+    BOOST_REQUIRE(sst.has_compression_dictionary());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_zstd_dictionary_size_bound) {
+    auto make = [] (size_t size_kb) {
+        return compressor::create({
+            {"sstable_compression", "org.apache.cassandra.io.compress.ZstdCompressor"},
+            {"dictionary_size_kb", to_sstring(size_kb)}
+        });
+    };
+    // Dictionaries are trained on samples of up to max_dictionary_sample_size,
+    // larger ones wouldn't get enough of them.
+    const auto max_size_kb = compressor::max_dictionary_size / 1024;
+    BOOST_REQUIRE_GT(max_size_kb, 0);
+    BOOST_REQUIRE_GE(compressor::max_dictionary_sample_size, max_size_kb * 1024 * compressor::dictionary_sample_ratio);
+    BOOST_REQUIRE_EQUAL(make(max_size_kb)->dictionary_size(), max_size_kb * 1024);
+    BOOST_REQUIRE_THROW(make(max_size_kb + 1), exceptions::configuration_exception);
+    BOOST_REQUIRE_THROW(make(1024), exceptions::configuration_exception);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_write_split_block_bloom_filter) {
+    auto abj = defer([] { await_background_jobs().get(); });
+    // CREATE TABLE split_block_bloom_filter (pk int, PRIMARY KEY (pk)) WITH bloom_filter_format = 'split_block';
+    schema_builder builder("sst3", "split_block_bloom_filter");
+    builder.with_column("pk", int32_type, column_kind::partition_key);
+    builder.set_compressor_params(compression_parameters::no_compression());
+    builder.set_extensions(schema::extensions_map{{sstring(db::bloom_filter_format_extension::NAME),
+            ::make_shared<db::bloom_filter_format_extension>(sstring("split_block"))}});
+    schema_ptr s = builder.build(schema_builder::compact_storage::no);
+
+    lw_shared_ptr<memtable> mt = make_lw_shared<memtable>(s);
+
+    const int nr_partitions = 4096;
+    std::vector<mutation> muts;
+    for (auto i : boost::irange(0, nr_partitions)) {
+        auto key = partition_key::from_deeply_exploded(*s, {i});
+        muts.emplace_back(s, key);
+        muts.back().partition().apply(tombstone{write_timestamp, write_time_point});
+        mt->apply(muts.back());
+    }
+
+    test_env env;
+    tmpdir tmp = write_sstables(env, s, mt);
+    boost::sort(muts, mutation_decorated_key_less_comparator());
+    auto sst = validate_read(s, tmp.path(), muts);
+
+    BOOST_REQUIRE(sst.has_split_block_filter());
+    for (auto&& m : muts) {
+        BOOST_REQUIRE(sst.filter_has_key(*s, m.key()));
+    }
+    const int nr_absent = 100000;
+    int false_positives = 0;
+    for (auto i : boost::irange(nr_partitions, nr_partitions + nr_absent)) {
+        false_positives += sst.filter_has_key(*s, partition_key::from_deeply_exploded(*s, {i}));
+    }
+    BOOST_REQUIRE_LT(false_positives, nr_absent * s->bloom_filter_fp_chance() * 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_split_block_bloom_filter_waits_for_cluster_feature) {
+    auto abj = defer([] { await_background_jobs().get(); });
+    schema_builder builder("sst3", "split_block_bloom_filter_feature");
+    builder.with_column("pk", int32_type, column_kind::partition_key);
+    builder.set_compressor_params(compression_parameters::no_compression());
+    builder.set_extensions(schema::extensions_map{{sstring(db::bloom_filter_format_extension::NAME),
+            ::make_shared<db::bloom_filter_format_extension>(sstring("split_block"))}});
+    schema_ptr s = builder.build(schema_builder::compact_storage::no);
+
+    lw_shared_ptr<memtable> mt = make_lw_shared<memtable>(s);
+    const int nr_partitions = 128;
+    for (auto i : boost::irange(0, nr_partitions)) {
+        mutation m(s, partition_key::from_deeply_exploded(*s, {i}));
+        m.partition().apply(tombstone{write_timestamp, write_time_point});
+        mt->apply(m);
+    }
+
+    // Until all nodes support split block filters, sstables get classic ones.
+    storage_service_for_tests ssft;
+    test_env env;
+    tmpdir tmp;
+    auto sst = env.make_sstable(s, tmp.path().string(), 1, sstables::sstable_version_types::mc, sstable::format_types::big, 4096);
+    auto cfg = sstable_writer_config{};
+    cfg.use_split_block_bloom_filters = false;
+    sst->write_components(mt->make_flat_reader(s), nr_partitions, s, cfg, mt->get_encoding_stats()).get();
+
+    auto written = env.reusable_sst(s, tmp.path().string(), 1, sstables::sstable::version_types::mc).get0();
+    BOOST_REQUIRE(!written->has_split_block_filter());
+    for (auto i : boost::irange(0, nr_partitions)) {
+        BOOST_REQUIRE(written->filter_has_key(*s, partition_key::from_deeply_exploded(*s, {i})));
+    }
+}
+
 SEASTAR_THREAD_TEST_CASE(test_write_multiple_rows) {
     auto abj = defer([] { await_background_jobs().get(); });
     sstring table_name = "multiple_rows";
@@ -68,6 +68,7 @@
 #include "test/lib/cql_test_env.hh"
 
 #include "test/lib/sstable_utils.hh"
+#include "db/bloom_filter_format_extension.hh"
 
 namespace fs = std::filesystem;
 
@@ -3940,6 +3941,72 @@ SEASTAR_TEST_CASE(sstable_set_incremental_selector) {
     return make_ready_future<>();
 }
 
+SEASTAR_TEST_CASE(sstable_set_probe_filters) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        auto builder = schema_builder("tests", "probe_filters")
+            .with_column("pk", utf8_type, column_kind::partition_key)
+            .with_column("r1", int32_type);
+        auto s = builder.build();
+        builder.set_extensions(schema::extensions_map{{sstring(db::bloom_filter_format_extension::NAME),
+                ::make_shared<db::bloom_filter_format_extension>(sstring("split_block"))}});
+        auto split_block_s = builder.build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, &tmp, gen = make_lw_shared<unsigned>(1)] (schema_ptr s) mutable {
+            return [&env, &tmp, gen, s] {
+                return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::sstable::version_types::mc, big);
+            };
+        };
+        auto make_mutation = [] (schema_ptr s, sstring key) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::make_empty(), to_bytes("r1"), data_value(1), api::new_timestamp());
+            return m;
+        };
+
+        // The last sstable uses the other filter format, the batch has to handle a mix of them.
+        std::vector<shared_sstable> sstables = {
+            make_sstable_containing(sst_gen(s), {make_mutation(s, "k0"), make_mutation(s, "k1")}),
+            make_sstable_containing(sst_gen(s), {make_mutation(s, "k1"), make_mutation(s, "k2")}),
+            make_sstable_containing(sst_gen(split_block_s), {make_mutation(split_block_s, "k2"), make_mutation(split_block_s, "k3")}),
+        };
+        BOOST_REQUIRE(!sstables[0]->has_split_block_filter());
+        BOOST_REQUIRE(sstables[2]->has_split_block_filter());
+
+        // Returns the sstables which may contain the key, in their original order.
+        auto probe = [&] (sstring key) {
+            auto hk = sstables::sstable::make_hashed_key(*s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            std::vector<shared_sstable> expected;
+            for (auto&& sst : sstables) {
+                if (sst->filter_has_key(hk)) {
+                    expected.push_back(sst);
+                }
+            }
+            auto may_contain = sstables;
+            BOOST_REQUIRE_EQUAL(sstables::probe_filters(may_contain, hk), sstables.size() - expected.size());
+            BOOST_REQUIRE(may_contain == expected);
+            BOOST_REQUIRE_EQUAL(sstables::any_filter_has_key(sstables, hk), !expected.empty());
+            return may_contain;
+        };
+        auto expect = [&] (sstring key, std::vector<size_t> containing) {
+            auto may_contain = probe(key);
+            for (auto i : containing) {
+                BOOST_REQUIRE(std::count(may_contain.begin(), may_contain.end(), sstables[i]) == 1);
+            }
+        };
+        expect("k0", {0});
+        expect("k1", {0, 1});
+        expect("k2", {1, 2});
+        expect("k3", {2});
+
+        int false_positives = 0;
+        for (int i = 0; i < 1000; ++i) {
+            false_positives += probe(format("absent{}", i)).size();
+        }
+        BOOST_REQUIRE_LT(false_positives, 3000 * s->bloom_filter_fp_chance() * 2);
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_set_erase) {
     test_env env;
     auto s = make_lw_shared(schema({}, some_keyspace, some_column_family,
@@ -4156,6 +4223,262 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
             auto descriptor = cs.get_sstables_for_compaction(*cf, { sst });
             BOOST_REQUIRE(descriptor.sstables.size() == 0);
         }
+        // the compaction manager picks sstables for tombstone compaction with the options of the table's
+        // strategy, regardless of overlapping sstables
+        {
+            auto& cm = cf._data->cm;
+            sstables::test(sst).set_data_file_write_time(db_clock::time_point::min());
+            column_family_test(cf).add_sstable(sst);
+            auto candidates = cm.get_tombstone_compaction_candidates(*cf);
+            BOOST_REQUIRE(candidates.size() == 1);
+            BOOST_REQUIRE(candidates.front() == sst);
+
+            cf->set_compaction_strategy(sstables::compaction_strategy_type::null);
+            BOOST_REQUIRE(cm.get_tombstone_compaction_candidates(*cf).empty());
+            cf->set_compaction_strategy(sstables::compaction_strategy_type::size_tiered);
+
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes("key0")}));
+            m.set_clustered_cell(clustering_key::from_exploded(*s, {to_bytes("c1")}), *s->get_column_definition("r1"), make_atomic_cell(utf8_type, bytes("b")));
+            auto overlapping = make_sstable_containing(creator, {std::move(m)});
+            column_family_test(cf).add_sstable(overlapping);
+            candidates = cm.get_tombstone_compaction_candidates(*cf);
+            BOOST_REQUIRE(candidates.size() == 1);
+            BOOST_REQUIRE(candidates.front() == sst);
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(tombstone_compaction_next_to_older_overlapping_sstables) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        auto tmp = tmpdir();
+        auto s = make_lw_shared(schema({}, some_keyspace, some_column_family,
+            {{"p1", utf8_type}}, {{"c1", utf8_type}}, {{"r1", utf8_type}}, {}, utf8_type));
+        column_family_for_tests cf(s);
+        auto creator = [&, gen = make_lw_shared<unsigned>(1)] {
+            auto sst = env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+            sst->set_unshared();
+            return sst;
+        };
+        auto make_row = [&] (sstring key) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::from_exploded(*s, {to_bytes("c1")}), *s->get_column_definition("r1"),
+                    atomic_cell::make_live(*utf8_type, 1, bytes("a")));
+            return m;
+        };
+        auto deletion_time = gc_clock::now() - s->gc_grace_seconds() - std::chrono::hours(1);
+        auto make_deletion = [&] (sstring key) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.partition().apply(tombstone(10, deletion_time));
+            return m;
+        };
+
+        // Older sstables with rows spread over the whole token range, and an sstable
+        // with expired tombstones of other keys, and of one of theirs.
+        const int nr_keys = 100;
+        std::vector<mutation> rows_a, rows_b, deletions;
+        for (int i = 0; i < nr_keys; ++i) {
+            rows_a.push_back(make_row(format("a{}", i)));
+            rows_b.push_back(make_row(format("b{}", i)));
+            deletions.push_back(make_deletion(format("deleted{}", i)));
+        }
+        deletions.push_back(make_deletion("a0"));
+        auto old_a = make_sstable_containing(creator, std::move(rows_a));
+        auto old_b = make_sstable_containing(creator, std::move(rows_b));
+        auto tombstones = make_sstable_containing(creator, std::move(deletions));
+        sstables::test(tombstones).set_data_file_write_time(db_clock::time_point::min());
+        for (auto& sst : {old_a, old_b, tombstones}) {
+            column_family_test(cf).add_sstable(sst);
+        }
+
+        auto overlap = [&] (const sstables::shared_sstable& x, const sstables::shared_sstable& y) {
+            return x->get_first_decorated_key().tri_compare(*s, y->get_last_decorated_key()) <= 0
+                && y->get_first_decorated_key().tri_compare(*s, x->get_last_decorated_key()) <= 0;
+        };
+        BOOST_REQUIRE(overlap(tombstones, old_a) && overlap(tombstones, old_b));
+        BOOST_REQUIRE_LT(old_a->get_stats_metadata().min_timestamp, tombstones->get_stats_metadata().max_timestamp);
+
+        auto candidates = cf._data->cm.get_tombstone_compaction_candidates(*cf);
+        BOOST_REQUIRE(candidates.size() == 1);
+        BOOST_REQUIRE(candidates.front() == tombstones);
+
+        // Only the tombstones which may shadow data in the older sstables, as far as
+        // their bloom filters tell, survive the rewrite.
+        auto info = sstables::compact_sstables(sstables::compaction_descriptor(candidates), *cf, creator, replacer_fn_no_op()).get0();
+        BOOST_REQUIRE_GE(info.total_keys_written, 1u);
+        BOOST_REQUIRE_LT(info.total_keys_written, uint64_t(nr_keys / 10));
+    });
+}
+
+SEASTAR_TEST_CASE(compaction_strategy_shares_option) {
+    auto shares_of = [] (std::map<sstring, sstring> options) {
+        return sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, options).shares();
+    };
+    BOOST_REQUIRE_EQUAL(shares_of({}), 100u);
+    BOOST_REQUIRE_EQUAL(shares_of({{"shares", "500"}}), 500u);
+    BOOST_REQUIRE_THROW(shares_of({{"shares", "0"}}), exceptions::configuration_exception);
+    BOOST_REQUIRE_THROW(shares_of({{"shares", "1001"}}), exceptions::configuration_exception);
+    return make_ready_future<>();
+}
+
+SEASTAR_TEST_CASE(compaction_manager_fair_queueing_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+        cache_tracker tracker;
+        // Not started, so that postponed jobs are only reevaluated by the test.
+        compaction_manager cm;
+        compaction_manager_test t(cm);
+
+        auto make_table = [&] (sstring name, unsigned shares) {
+            auto s = schema_builder("tests", name)
+                    .with_column("id", utf8_type, column_kind::partition_key)
+                    .with_column("value", int32_type)
+                    .set_compaction_strategy_options({{"shares", to_sstring(shares)}})
+                    .build();
+            return make_lw_shared<column_family>(s, column_family_test_config(), column_family::no_commitlog(), cm, cl_stats, tracker);
+        };
+        auto hot = make_table("hot", 400);
+        auto cold = make_table("cold", 100);
+        auto boosted = make_table("boosted", 100);
+
+        const int weight = 5;
+        const uint64_t input_size = 1000;
+        using job_admission = compaction_manager_test::job_admission;
+
+        // Both tables want to compact while another compaction holds the weight.
+        t.take_weight(weight);
+        BOOST_REQUIRE(t.admit(*hot, weight, false, input_size) == job_admission::refused);
+        BOOST_REQUIRE(t.admit(*cold, weight, false, input_size) == job_admission::refused);
+        t.release_weight(weight);
+
+        // Each table keeps submitting jobs of the same size and weight. The job of a table which
+        // completes is submitted again right away, before the postponed jobs are reevaluated.
+        std::vector<column_family*> admitted;
+        column_family* running = nullptr;
+        for (int i = 0; i < 50; ++i) {
+            if (!running) {
+                for (auto cf : t.take_postponed()) {
+                    if (t.admit(*cf, weight, false, input_size) == job_admission::accepted) {
+                        BOOST_REQUIRE(!running);
+                        running = cf;
+                    }
+                }
+            }
+            BOOST_REQUIRE(running);
+            admitted.push_back(running);
+            auto finished = std::exchange(running, nullptr);
+            t.release_weight(weight);
+            if (t.admit(*finished, weight, false, input_size) == job_admission::accepted) {
+                running = finished;
+            }
+        }
+        // The cold table is not starved by the hot table resubmitting at once, and the hot table
+        // gets four times the compaction of the cold one.
+        BOOST_REQUIRE(admitted[0] == hot.get());
+        BOOST_REQUIRE(admitted[1] == cold.get());
+        BOOST_REQUIRE(admitted[2] == hot.get());
+        BOOST_REQUIRE_EQUAL(std::count(admitted.begin(), admitted.end(), hot.get()), 40);
+        BOOST_REQUIRE_EQUAL(std::count(admitted.begin(), admitted.end(), cold.get()), 10);
+
+        // The weight is held by the last admitted job, if any, and the other table waits for it.
+        if (running) {
+            t.release_weight(weight);
+        }
+        t.take_postponed();
+        BOOST_REQUIRE_EQUAL(t.taken_weight_count(weight), 0);
+
+        // A boosted job takes a weight held by another table, and never yields it.
+        BOOST_REQUIRE(t.admit(*hot, weight, false, input_size) == job_admission::accepted);
+        BOOST_REQUIRE(t.admit(*cold, weight, false, input_size) == job_admission::refused);
+        BOOST_REQUIRE(t.admit(*boosted, weight, true, input_size) == job_admission::accepted);
+        BOOST_REQUIRE_EQUAL(t.taken_weight_count(weight), 2);
+        BOOST_REQUIRE(!t.must_yield_weight(*boosted, weight, true));
+        t.release_weight(weight);
+        BOOST_REQUIRE_EQUAL(t.taken_weight_count(weight), 1);
+        t.release_weight(weight);
+        BOOST_REQUIRE_EQUAL(t.taken_weight_count(weight), 0);
+
+        // Postponed jobs of boosted tables are reevaluated first, even though the boosted table was
+        // charged last and has the latest start tag. The others go by start tag, whatever order they
+        // were postponed in: the hot table was charged for the last job before the boosted one, so
+        // the cold table goes before it.
+        t.take_postponed();
+        t.postpone(*hot, weight, false);
+        t.postpone(*cold, weight, false);
+        t.postpone(*boosted, weight, true);
+        auto order = t.take_postponed();
+        BOOST_REQUIRE_EQUAL(order.size(), 3);
+        BOOST_REQUIRE(order[0] == boosted.get());
+        BOOST_REQUIRE(order[1] == cold.get());
+        BOOST_REQUIRE(order[2] == hot.get());
+
+        // A boosted compaction raises the backlog, and with it the shares of compaction, while it runs.
+        auto backlog = cm.backlog();
+        auto boosted_backlog = t.make_boosted_backlog_tracker();
+        BOOST_REQUIRE_GT(cm.backlog(), backlog);
+        boosted_backlog = {};
+        BOOST_REQUIRE_EQUAL(cm.backlog(), backlog);
+    });
+}
+
+SEASTAR_TEST_CASE(compaction_manager_boost_thresholds_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+        cache_tracker tracker;
+        compaction_manager cm;
+        compaction_manager_test t(cm);
+
+        auto s = schema_builder("tests", "compaction_manager_boost_thresholds_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+        };
+        auto keys = make_local_keys(8, s);
+        auto make_mutation = [&] (size_t i) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(keys[i])}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), api::timestamp_type(0));
+            return m;
+        };
+        auto make_table = [&] (std::vector<std::vector<size_t>> sstables) {
+            auto cf = make_lw_shared<column_family>(s, column_family_test_config(), column_family::no_commitlog(), cm, cl_stats, tracker);
+            for (auto& sst_keys : sstables) {
+                std::vector<mutation> muts;
+                for (auto i : sst_keys) {
+                    muts.push_back(make_mutation(i));
+                }
+                column_family_test(cf).add_sstable(make_sstable_containing(sst_gen, std::move(muts)));
+            }
+            return cf;
+        };
+
+        // Four sstables of disjoint token ranges.
+        auto disjoint = make_table({{0, 1}, {2, 3}, {4, 5}, {6, 7}});
+        // Three sstables spanning the same token range, and one more of its own.
+        auto overlapping = make_table({{0, 5}, {1, 4}, {2, 3}, {6, 7}});
+        // Sstables overlapping only at their bounds still overlap.
+        auto touching = make_table({{0, 2}, {2, 4}, {2, 6}});
+
+        // Thresholds are disabled by default.
+        BOOST_REQUIRE(!t.needs_boost(*disjoint));
+        BOOST_REQUIRE(!t.needs_boost(*overlapping));
+
+        cm.set_compaction_boost_thresholds(3, 0);
+        BOOST_REQUIRE(t.needs_boost(*disjoint));
+        BOOST_REQUIRE(t.needs_boost(*overlapping));
+        BOOST_REQUIRE(!t.needs_boost(*touching));
+
+        cm.set_compaction_boost_thresholds(0, 2);
+        BOOST_REQUIRE(!t.needs_boost(*disjoint));
+        BOOST_REQUIRE(t.needs_boost(*overlapping));
+        BOOST_REQUIRE(t.needs_boost(*touching));
+
+        cm.set_compaction_boost_thresholds(0, 3);
+        BOOST_REQUIRE(!t.needs_boost(*overlapping));
+        BOOST_REQUIRE(!t.needs_boost(*touching));
     });
 }
 
@@ -4627,10 +4950,108 @@ SEASTAR_TEST_CASE(sstable_cleanup_correctness_test) {
             BOOST_REQUIRE(ret.total_keys_written == total_partitions);
             BOOST_REQUIRE(ret.new_sstables.size() == 1);
             BOOST_REQUIRE(ret.new_sstables.front()->run_identifier() == run_identifier);
+
+            // All of the ring is owned by the single node, so reading only the owned ranges reads everything.
+            auto rd = assert_that(sstable_reader(ret.new_sstables.front(), s));
+            for (auto& m : mutations) {
+                rd.produces(m);
+            }
+            rd.produces_end_of_stream();
         });
     });
 }
 
+SEASTAR_TEST_CASE(sstable_cleanup_partial_ownership_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        cell_locker_stats cl_stats;
+
+        auto s = schema_builder("tests", "sstable_cleanup_partial_ownership_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = tmpdir();
+        auto cm = make_lw_shared<compaction_manager>();
+        cm->start();
+
+        column_family::config cfg = column_family_test_config();
+        cfg.datadir = tmp.path().string();
+        cfg.enable_commitlog = false;
+        cfg.enable_incremental_backups = false;
+        cache_tracker tracker;
+        auto cf = make_lw_shared<column_family>(s, cfg, column_family::no_commitlog(), *cm, cl_stats, tracker);
+        cf->mark_ready_for_writes();
+        cf->start();
+
+        auto keys = make_local_keys(40, s);
+        std::vector<mutation> mutations;
+        for (auto& key : keys) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), api::timestamp_type(0));
+            mutations.push_back(std::move(m));
+        }
+        auto token_of = [&] (size_t i) {
+            return mutations[i].decorated_key().token();
+        };
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+        };
+        auto make_sstable = [&] (size_t first, size_t last) {
+            auto sst = make_sstable_containing(sst_gen, std::vector<mutation>(mutations.begin() + first, mutations.begin() + last + 1));
+            column_family_test::update_sstables_known_generation(*cf, sst->generation());
+            cf->add_sstable_and_update_cache(sst).get();
+            return sst;
+        };
+
+        // Wholly owned, so left alone.
+        auto owned = make_sstable(0, 9);
+        // Not owned at all, so deleted without being read.
+        auto unowned = make_sstable(10, 19);
+        // Partially owned by two disjoint ranges, so rewritten with only their data.
+        auto partial = make_sstable(20, 39);
+
+        auto owned_ranges = dht::token_range_vector{
+            dht::token_range::make(token_of(0), token_of(9)),
+            dht::token_range::make(token_of(22), token_of(25)),
+            dht::token_range::make(token_of(30), token_of(33)),
+        };
+        auto descriptor = sstables::compaction_descriptor({owned, unowned, partial});
+        descriptor.owned_ranges = owned_ranges;
+        cf->cleanup_sstables(std::move(descriptor), true).get();
+
+        auto sstables = cf->get_sstables();
+        auto has_sstable = [&] (const shared_sstable& sst) {
+            return sstables->count(sst);
+        };
+        BOOST_REQUIRE_EQUAL(sstables->size(), 2);
+        BOOST_REQUIRE(has_sstable(owned));
+        BOOST_REQUIRE(!has_sstable(unowned));
+        BOOST_REQUIRE(!has_sstable(partial));
+        BOOST_REQUIRE(!file_exists(unowned->get_filename()).get0());
+
+        auto rewritten = *boost::find_if(*sstables, [&] (const shared_sstable& sst) { return sst != owned; });
+        {
+            auto rd = assert_that(sstable_reader(owned, s));
+            for (size_t i = 0; i <= 9; ++i) {
+                rd.produces(mutations[i]);
+            }
+            rd.produces_end_of_stream();
+        }
+        {
+            auto rd = assert_that(sstable_reader(rewritten, s));
+            for (size_t i = 22; i <= 25; ++i) {
+                rd.produces(mutations[i]);
+            }
+            for (size_t i = 30; i <= 33; ++i) {
+                rd.produces(mutations[i]);
+            }
+            rd.produces_end_of_stream();
+        }
+
+        cm->stop().get();
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_partition_estimation_sanity_test) {
     return test_env::do_with_async([] (test_env& env) {
         storage_service_for_tests ssft;
@@ -5401,3 +5822,54 @@ SEASTAR_TEST_CASE(incremental_compaction_data_resurrection_test) {
         BOOST_REQUIRE(is_partition_dead(alpha));
     });
 }
+
+SEASTAR_TEST_CASE(incremental_compaction_strategy_test) {
+    test_env env;
+    column_family_for_tests cf;
+    auto key_and_token_pair = token_generation_for_current_shard(2);
+    auto min_key = key_and_token_pair[0].first;
+    auto max_key = key_and_token_pair[1].first;
+    auto mb = 1024 * 1024;
+
+    int64_t gen = 1;
+    std::vector<shared_sstable> candidates;
+    // Adds a run of the given number of fragments of the given size.
+    auto add_run = [&] (unsigned fragments, uint64_t fragment_size) {
+        auto run_id = utils::make_random_uuid();
+        std::vector<shared_sstable> run;
+        for (unsigned i = 0; i < fragments; i++) {
+            auto sst = env.make_sstable(cf->schema(), "", gen++, la, big);
+            sstables::test(sst).set_values_for_leveled_strategy(fragment_size, 0, 0, min_key, max_key);
+            sstables::test(sst).set_run_identifier(run_id);
+            column_family_test(cf).add_sstable(sst);
+            candidates.push_back(sst);
+            run.push_back(sst);
+        }
+        return run;
+    };
+    // Runs of similar size are tiered together regardless of the size of their fragments.
+    auto run1 = add_run(2, 100 * mb);
+    auto run2 = add_run(4, 50 * mb);
+    auto run3 = add_run(1, 220 * mb);
+    add_run(10, 100 * mb);
+
+    std::map<sstring, sstring> options = { { "sstable_size_in_mb", "1" } };
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, options);
+    BOOST_REQUIRE_EQUAL(cs.name(), "IncrementalCompactionStrategy");
+    BOOST_REQUIRE(sstables::compaction_strategy::type(cs.name()) == sstables::compaction_strategy_type::incremental);
+
+    auto descriptor = cs.get_sstables_for_compaction(*cf, candidates);
+    std::unordered_set<shared_sstable> expected;
+    expected.insert(run1.begin(), run1.end());
+    expected.insert(run2.begin(), run2.end());
+    expected.insert(run3.begin(), run3.end());
+    BOOST_REQUIRE(std::unordered_set<shared_sstable>(descriptor.sstables.begin(), descriptor.sstables.end()) == expected);
+    BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), expected.size());
+    BOOST_REQUIRE_EQUAL(descriptor.max_sstable_bytes, uint64_t(mb));
+
+    descriptor = cs.get_major_compaction_job(*cf, candidates);
+    BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), candidates.size());
+    BOOST_REQUIRE_EQUAL(descriptor.max_sstable_bytes, uint64_t(mb));
+
+    return make_ready_future<>();
+}
@@ -45,6 +45,8 @@
 #include "test/lib/make_random_string.hh"
 #include "test/lib/data_model.hh"
 #include "test/lib/random_utils.hh"
+#include "mutation_query.hh"
+#include "query-result-set.hh"
 
 using namespace sstables;
 using namespace std::chrono_literals;
@@ -448,6 +450,30 @@ SEASTAR_TEST_CASE(test_sstable_conforms_to_mutation_source) {
     });
 }
 
+SEASTAR_TEST_CASE(test_sstable_with_index_page_cache_conforms_to_mutation_source) {
+    return seastar::async([] {
+        auto wait_bg = seastar::defer([] { sstables::await_background_jobs().get(); });
+        storage_service_for_tests ssft;
+        sstables::test_env env;
+        auto& tracker = sstables::index_page_cache_tracker::shard_tracker();
+        auto disable_cache = seastar::defer([&tracker] { tracker.set_max_memory(0); });
+        // Small enough to exercise eviction, large enough to keep a few pages around.
+        tracker.set_max_memory(64 * 1024);
+        auto before = tracker.get_stats();
+        for (auto version : all_sstable_versions) {
+            for (auto index_block_size : {1, 64*1024}) {
+                sstable_writer_config cfg;
+                cfg.promoted_index_block_size = index_block_size;
+                test_mutation_source(env, cfg, version);
+            }
+        }
+        auto after = tracker.get_stats();
+        BOOST_REQUIRE_GT(after.populations, before.populations);
+        BOOST_REQUIRE_GT(after.hits, before.hits);
+        BOOST_REQUIRE_LE(after.bytes, tracker.max_memory());
+    });
+}
+
 SEASTAR_TEST_CASE(test_sstable_can_write_and_read_range_tombstone) {
     return seastar::async([] {
         auto wait_bg = seastar::defer([] { sstables::await_background_jobs().get(); });
@@ -965,6 +991,163 @@ static std::unique_ptr<index_reader> get_index_reader(shared_sstable sst) {
     return std::make_unique<index_reader>(sst, no_reader_permit(), default_priority_class(), tracing::trace_state_ptr());
 }
 
+SEASTAR_THREAD_TEST_CASE(test_index_reader_reads_ahead_during_sequential_scan) {
+    auto wait_bg = seastar::defer([] { sstables::await_background_jobs().get(); });
+    storage_service_for_tests ssft;
+    auto& tracker = sstables::index_page_cache_tracker::shard_tracker();
+    auto disable_cache = seastar::defer([&tracker] { tracker.set_max_memory(0); });
+    tracker.set_max_memory(1 << 20);
+    for (const auto version : all_sstable_versions) {
+        auto dir = tmpdir();
+        simple_schema ss;
+        auto s = ss.schema();
+
+        // Large enough values to get a summary entry, and so an index page, every few partitions.
+        auto value = sstring(4096, 'v');
+        auto keys = ss.make_pkeys(256);
+        std::vector<mutation> muts;
+        for (auto& dk : keys) {
+            mutation m(s, dk);
+            ss.add_row(m, ss.make_ckey(0), value);
+            muts.push_back(std::move(m));
+        }
+
+        sstables::test_env env;
+        auto sst = make_sstable_containing([&] {
+            return env.make_sstable(s, dir.path().string(), 1, version, sstables::sstable::format_types::big);
+        }, std::move(muts));
+        BOOST_REQUIRE_GT(sst->get_summary().header.size, 2u);
+
+        auto before = tracker.get_stats();
+        auto ir = get_index_reader(sst);
+        auto close_ir = seastar::defer([&ir] { ir->close().get(); });
+        ir->read_partition_data().get();
+        size_t partitions = 0;
+        while (!ir->eof()) {
+            BOOST_REQUIRE(ir->partition_data_ready());
+            BOOST_REQUIRE(ir->partition_key().to_partition_key(*s).equal(*s, keys[partitions].key()));
+            ++partitions;
+            ir->advance_to_next_partition().get();
+        }
+        BOOST_REQUIRE_EQUAL(partitions, keys.size());
+
+        auto after = tracker.get_stats();
+        BOOST_REQUIRE_GT(after.read_aheads, before.read_aheads);
+        // All pages but the first one were read ahead, so the scan found them in the cache.
+        BOOST_REQUIRE_GE(after.hits - before.hits, sst->get_summary().header.size - 1);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_concurrent_lookups_share_index_page_reads) {
+    auto wait_bg = seastar::defer([] { sstables::await_background_jobs().get(); });
+    storage_service_for_tests ssft;
+    auto& tracker = sstables::index_page_cache_tracker::shard_tracker();
+    auto disable_cache = seastar::defer([&tracker] { tracker.set_max_memory(0); });
+    tracker.set_max_memory(1 << 20);
+    for (const auto version : all_sstable_versions) {
+        auto dir = tmpdir();
+        simple_schema ss;
+        auto s = ss.schema();
+
+        auto keys = ss.make_pkeys(32);
+        std::vector<mutation> muts;
+        for (auto& dk : keys) {
+            mutation m(s, dk);
+            ss.add_row(m, ss.make_ckey(0), "v");
+            muts.push_back(std::move(m));
+        }
+
+        sstables::test_env env;
+        auto sst = make_sstable_containing([&] {
+            return env.make_sstable(s, dir.path().string(), 1, version, sstables::sstable::format_types::big);
+        }, std::move(muts));
+        BOOST_REQUIRE_EQUAL(sst->get_summary().header.size, 1u);
+
+        // Like the keys of an IN query, looked up concurrently.
+        auto before = tracker.get_stats();
+        parallel_for_each(keys, [&] (const dht::decorated_key& dk) {
+            auto hk = sstables::sstable::make_hashed_key(*s, dk.key());
+            return sst->has_partition_key(hk, dk).then([] (bool present) {
+                BOOST_REQUIRE(present);
+            });
+        }).get();
+        auto after = tracker.get_stats();
+        BOOST_REQUIRE_EQUAL(after.populations - before.populations, 1u);
+        BOOST_REQUIRE_EQUAL(after.shared_reads - before.shared_reads, keys.size() - 1);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reads_past_cache_skip_values_of_unselected_columns) {
+    auto wait_bg = seastar::defer([] { sstables::await_background_jobs().get(); });
+    storage_service_for_tests ssft;
+    auto dir = tmpdir();
+    auto s = schema_builder("ks", "cf")
+        .with_column("pk", int32_type, column_kind::partition_key)
+        .with_column("ck", int32_type, column_kind::clustering_key)
+        .with_column("v1", int32_type)
+        .with_column("v2", utf8_type)
+        .build();
+    const column_definition& v1 = *s->get_column_definition("v1");
+    const column_definition& v2 = *s->get_column_definition("v2");
+
+    auto make_mutation = [&] (bytes v2_value) {
+        mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(0)));
+        auto ck1 = clustering_key::from_single_value(*s, int32_type->decompose(1));
+        auto ck2 = clustering_key::from_single_value(*s, int32_type->decompose(2));
+        m.set_clustered_cell(ck1, v1, atomic_cell::make_live(*v1.type, 1, int32_type->decompose(7)));
+        m.set_clustered_cell(ck1, v2, atomic_cell::make_live(*v2.type, 1, v2_value));
+        // Only the cell of the unselected column keeps this row alive.
+        m.set_clustered_cell(ck2, v2, atomic_cell::make_live(*v2.type, 1, v2_value));
+        return m;
+    };
+    auto m = make_mutation(utf8_type->decompose(sstring(1024, 'v')));
+
+    sstables::test_env env;
+    auto sst = make_sstable_containing([&] {
+        return env.make_sstable(s, dir.path().string(), 1, sstables::sstable::version_types::mc, sstables::sstable::format_types::big);
+    }, {m});
+
+    auto read = [&] (const query::partition_slice& slice) {
+        auto rd = sst->as_mutation_source().make_reader(s, no_reader_permit(), query::full_partition_range, slice);
+        auto mopt = read_mutation_from_flat_mutation_reader(rd, db::no_timeout).get0();
+        BOOST_REQUIRE(mopt);
+        return std::move(*mopt);
+    };
+
+    auto slice = partition_slice_builder(*s).with_regular_column("v1").build();
+    auto before = sstables::sstables_stats::get_shard_stats().cell_value_skips;
+    BOOST_REQUIRE_EQUAL(read(slice), m);
+    BOOST_REQUIRE_EQUAL(sstables::sstables_stats::get_shard_stats().cell_value_skips, before);
+
+    // Mutation queries return the unselected cells, and read repair writes
+    // them back, so they must be read in full even when bypassing the cache.
+    slice.options.set<query::partition_slice::option::bypass_cache>();
+    {
+        auto result = mutation_query(s, sst->as_mutation_source(), query::full_partition_range, slice, query::max_rows, query::max_partitions,
+                gc_clock::now()).get0();
+        BOOST_REQUIRE_EQUAL(result.partitions().size(), 1);
+        BOOST_REQUIRE_EQUAL(result.partitions().front().mut().unfreeze(s), m);
+        BOOST_REQUIRE_EQUAL(sstables::sstables_stats::get_shard_stats().cell_value_skips, before);
+    }
+
+    slice.options.set<query::partition_slice::option::skip_unselected_values>();
+    BOOST_REQUIRE_EQUAL(read(slice), make_mutation(bytes()));
+    BOOST_REQUIRE_EQUAL(sstables::sstables_stats::get_shard_stats().cell_value_skips, before + 2);
+
+    // Slices of data queries get the option on the replica.
+    slice.options.remove<query::partition_slice::option::skip_unselected_values>();
+    {
+        query::result_memory_limiter l(std::numeric_limits<ssize_t>::max());
+        query::result::builder builder(slice, query::result_options::only_result(),
+                l.new_data_read(query::result_memory_limiter::maximum_result_size).get0());
+        data_query(s, sst->as_mutation_source(), query::full_partition_range, slice, query::max_rows, query::max_partitions, gc_clock::now(),
+                builder).get();
+        auto rs = query::result_set::from_raw_result(s, slice, builder.build());
+        BOOST_REQUIRE_EQUAL(rs.rows().size(), 2);
+        BOOST_REQUIRE_EQUAL(sstables::sstables_stats::get_shard_stats().cell_value_skips, before + 4);
+    }
+}
+
 SEASTAR_TEST_CASE(test_promoted_index_blocks_are_monotonic) {
     return seastar::async([] {
         auto wait_bg = seastar::defer([] { sstables::await_background_jobs().get(); });
@@ -65,6 +65,62 @@ class column_family_test {
     }
 };
 
+class compaction_manager_test {
+    compaction_manager& _cm;
+public:
+    using job_admission = compaction_manager::job_admission;
+
+    explicit compaction_manager_test(compaction_manager& cm) : _cm(cm) {}
+
+    // Admits a regular compaction job like submit() does, taking its weight if it's accepted.
+    job_admission admit(column_family& cf, int weight, bool boosted, uint64_t input_size) {
+        auto admission = _cm.admit_compaction_job(&cf, weight, boosted, input_size);
+        if (admission == job_admission::accepted) {
+            _cm.register_weight(weight);
+        }
+        return admission;
+    }
+
+    void take_weight(int weight) {
+        _cm.register_weight(weight);
+    }
+
+    void release_weight(int weight) {
+        _cm.deregister_weight(weight);
+    }
+
+    size_t taken_weight_count(int weight) const {
+        return _cm._weight_tracker.count(weight);
+    }
+
+    void postpone(column_family& cf, int weight, bool boosted) {
+        _cm.postpone_compaction_for_column_family(&cf, weight, boosted);
+    }
+
+    // Takes the postponed jobs, in the order they are reevaluated.
+    std::vector<column_family*> take_postponed() {
+        auto postponed = std::exchange(_cm._postponed, {});
+        _cm.order_postponed_compactions(postponed);
+        std::vector<column_family*> cfs;
+        for (auto& p : postponed) {
+            cfs.push_back(p.cf);
+        }
+        return cfs;
+    }
+
+    bool must_yield_weight(column_family& cf, int weight, bool boosted) const {
+        return _cm.must_yield_weight(&cf, weight, boosted);
+    }
+
+    bool needs_boost(const column_family& cf) const {
+        return _cm.needs_boost(cf);
+    }
+
+    lw_shared_ptr<compaction_backlog_tracker> make_boosted_backlog_tracker() {
+        return _cm.make_boosted_backlog_tracker();
+    }
+};
+
 namespace sstables {
 
 using sstable_ptr = shared_sstable;
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE tournament_tree
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "utils/tournament_tree.hh"
+
+struct input_and_value {
+    size_t input;
+    int value;
+};
+
+struct value_less {
+    bool operator()(const input_and_value& a, const input_and_value& b) const {
+        return a.value < b.value;
+    }
+};
+
+using tree_type = utils::tournament_tree<input_and_value, value_less>;
+
+BOOST_AUTO_TEST_CASE(test_empty) {
+    tree_type t;
+    BOOST_REQUIRE(t.empty());
+    t.reserve(7);
+    BOOST_REQUIRE(t.empty());
+    t.clear();
+    BOOST_REQUIRE_EQUAL(t.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_push_pop_sorts) {
+    std::mt19937 rnd(0);
+    for (size_t n : {1, 2, 3, 5, 8, 13, 64, 100}) {
+        tree_type t;
+        std::vector<int> values;
+        for (size_t i = 0; i < n; ++i) {
+            values.push_back(std::uniform_int_distribution<int>(0, 50)(rnd));
+            // Grows the tree as needed.
+            t.push({i, values.back()});
+            BOOST_REQUIRE_EQUAL(t.size(), i + 1);
+        }
+        std::sort(values.begin(), values.end());
+        for (auto v : values) {
+            BOOST_REQUIRE_EQUAL(t.top().value, v);
+            BOOST_REQUIRE_EQUAL(t.pop().value, v);
+        }
+        BOOST_REQUIRE(t.empty());
+    }
+}
+
+// Merges sorted inputs the way mutation_reader_merger does: take the
+// smallest value out, then put the next value of the same input in.
+BOOST_AUTO_TEST_CASE(test_merge) {
+    std::mt19937 rnd(1);
+    for (size_t k : {1, 2, 3, 4, 7, 16, 33, 64}) {
+        std::vector<std::vector<int>> inputs(k);
+        std::vector<int> expected;
+        for (auto& in : inputs) {
+            auto n = std::uniform_int_distribution<size_t>(0, 100)(rnd);
+            for (size_t i = 0; i < n; ++i) {
+                in.push_back(std::uniform_int_distribution<int>(0, 1000)(rnd));
+            }
+            std::sort(in.begin(), in.end());
+            expected.insert(expected.end(), in.begin(), in.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        tree_type t;
+        t.reserve(k);
+        std::vector<size_t> next(k, 0);
+        for (size_t i = 0; i < k; ++i) {
+            if (!inputs[i].empty()) {
+                t.push({i, inputs[i][next[i]++]});
+            }
+        }
+        std::vector<int> merged;
+        bool use_replace = false;
+        while (!t.empty()) {
+            auto i = t.top().input;
+            merged.push_back(t.top().value);
+            if (next[i] == inputs[i].size()) {
+                t.pop();
+            } else if (use_replace) {
+                t.replace_top({i, inputs[i][next[i]++]});
+            } else {
+                t.pop();
+                t.push({i, inputs[i][next[i]++]});
+            }
+            use_replace = !use_replace;
+        }
+        BOOST_REQUIRE(merged == expected);
+    }
+}
+
+// Values are put in some time after others were taken out, as when
+// several inputs are refilled at once.
+BOOST_AUTO_TEST_CASE(test_random_operations) {
+    std::mt19937 rnd(2);
+    tree_type t;
+    std::multiset<int> expected;
+    for (int i = 0; i < 100000; ++i) {
+        auto op = std::uniform_int_distribution<int>(0, 2)(rnd);
+        if (op == 0 && !t.empty()) {
+            BOOST_REQUIRE_EQUAL(t.pop().value, *expected.begin());
+            expected.erase(expected.begin());
+        } else {
+            auto v = std::uniform_int_distribution<int>(0, 1000)(rnd);
+            t.push({0, v});
+            expected.insert(v);
+        }
+        BOOST_REQUIRE_EQUAL(t.size(), expected.size());
+        if (!t.empty()) {
+            BOOST_REQUIRE_EQUAL(t.top().value, *expected.begin());
+        }
+        if (expected.size() > 200) {
+            while (!t.empty()) {
+                BOOST_REQUIRE_EQUAL(t.pop().value, *expected.begin());
+                expected.erase(expected.begin());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_clear_and_for_each) {
+    tree_type t;
+    for (int i = 0; i < 10; ++i) {
+        t.push({size_t(i), 10 - i});
+    }
+    int sum = 0;
+    t.for_each([&] (input_and_value& v) {
+        sum += v.value;
+    });
+    BOOST_REQUIRE_EQUAL(sum, 55);
+
+    t.clear();
+    BOOST_REQUIRE(t.empty());
+    t.push({0, 3});
+    t.push({1, 1});
+    t.push({2, 2});
+    BOOST_REQUIRE_EQUAL(t.pop().value, 1);
+    BOOST_REQUIRE_EQUAL(t.pop().value, 2);
+    BOOST_REQUIRE_EQUAL(t.pop().value, 3);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <random>
+
+#include "utils/bloom_filter.hh"
+#include "utils/bloom_calculations.hh"
+#include "test/perf/perf.hh"
+
+volatile uint64_t black_hole;
+
+// Large enough for the filters not to fit in the CPU caches.
+static constexpr int64_t nr_keys = 4 * 1024 * 1024;
+static constexpr double fp_chance = 0.01;
+
+// large_bitset(size_t) can only be used in a seastar thread.
+static large_bitset make_bitset(size_t nr_bits) {
+    utils::chunked_vector<uint64_t> storage;
+    storage.resize(nr_bits / 64);
+    return large_bitset(nr_bits, std::move(storage));
+}
+
+static bytes make_key(uint64_t v) {
+    bytes b(bytes::initialized_later(), sizeof(v));
+    std::copy_n(reinterpret_cast<const int8_t*>(&v), sizeof(v), b.begin());
+    return b;
+}
+
+static void run(const char* name, utils::filter_ptr filter) {
+    std::mt19937_64 rnd(0);
+    std::vector<utils::hashed_key> present;
+    std::vector<utils::hashed_key> absent;
+    present.reserve(nr_keys);
+    absent.reserve(nr_keys);
+    for (int64_t i = 0; i < nr_keys; ++i) {
+        auto k = make_key(rnd());
+        filter->add(k);
+        present.push_back(utils::make_hashed_key(k));
+        absent.push_back(utils::make_hashed_key(make_key(rnd())));
+    }
+
+    uint64_t false_positives = 0;
+    for (auto&& hk : absent) {
+        false_positives += filter->is_present(hk);
+    }
+    std::cout << format("{}: {:d} bytes, {:.3f} bits per key, false positive rate {:.5f}\n", name, filter->memory_size(),
+            double(filter->memory_size()) * 8 / nr_keys, double(false_positives) / absent.size());
+
+    uint64_t sink = 0;
+    size_t idx = 0;
+
+    std::cout << "Timing negative probes...\n";
+
+    time_it([&] {
+        sink += filter->is_present(absent[idx++ % absent.size()]);
+    });
+
+    std::cout << "Timing positive probes...\n";
+
+    time_it([&] {
+        sink += filter->is_present(present[idx++ % present.size()]);
+    });
+
+    black_hole = sink;
+}
+
+int main(int argc, char* argv[]) {
+    auto spec = utils::bloom_calculations::compute_bloom_spec(utils::bloom_calculations::max_buckets_per_element(nr_keys), fp_chance);
+    auto classic_bits = align_up<int64_t>(nr_keys * spec.buckets_per_element + utils::bloom_calculations::EXCESS, 64);
+    run("classic", utils::filter::create_filter(spec.K, make_bitset(classic_bits), utils::filter_format::m_format));
+
+    using split_block = utils::filter::split_block_bloom_filter;
+    auto split_block_bits = align_up<int64_t>(std::ceil(nr_keys * split_block::bits_per_element(fp_chance)), split_block::bits_per_block);
+    run(format("split_block ({})", utils::filter::split_block_probe_implementation()).c_str(),
+            utils::filter::create_filter(split_block::words_per_block, make_bitset(split_block_bits), utils::filter_format::split_block));
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <algorithm>
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/core/semaphore.hh>
+#include <seastar/core/future-util.hh>
+
+#include "db/commitlog/commitlog.hh"
+#include "utils/UUID_gen.hh"
+#include "test/lib/tmpdir.hh"
+#include "test/perf/perf.hh"
+
+// Measures the latency of commitlog writes, as seen by the caller of add(),
+// with a fixed number of writes in flight. Replay positions are released as
+// soon as the write completes, so segments are reclaimed (deleted or
+// recycled) as soon as they are filled.
+
+using clk = std::chrono::steady_clock;
+
+static void print_latency(const char* what, std::vector<clk::duration>& latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&] (double q) {
+        auto idx = std::min(latencies.size() - 1, size_t(q * latencies.size()));
+        return std::chrono::duration_cast<std::chrono::microseconds>(latencies[idx]).count();
+    };
+    std::cout << format("{} latency [us]: p50 {:d}, p90 {:d}, p99 {:d}, p999 {:d}, max {:d}\n", what,
+            at(0.5), at(0.9), at(0.99), at(0.999), at(1.0));
+}
+
+int main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("requests", bpo::value<unsigned>()->default_value(200000), "number of writes")
+        ("concurrency", bpo::value<unsigned>()->default_value(64), "number of writes in flight")
+        ("size", bpo::value<unsigned>()->default_value(256), "size of a single write, in bytes")
+        ("mode", bpo::value<sstring>()->default_value("batch"), "commitlog sync mode, one of: batch (default), periodic")
+        ("sync-period", bpo::value<unsigned>()->default_value(10000), "sync period in periodic mode, in ms")
+        ("segment-size", bpo::value<unsigned>()->default_value(32), "segment size, in MB")
+        ("total-space", bpo::value<unsigned>()->default_value(1024), "commitlog disk space, in MB")
+        ("o-dsync", bpo::value<bool>()->default_value(false), "open segments with O_DSYNC")
+        ("reuse-segments", bpo::value<bool>()->default_value(true), "recycle released segment files")
+        ("compression", bpo::value<sstring>()->default_value("none"), "segment compression, one of: none (default), lz4, zstd")
+        ("testdir", bpo::value<sstring>()->default_value(""), "directory in which to create the commitlog (default: a temporary directory)");
+
+    return app.run(argc, argv, [&app] {
+        return seastar::async([&app] {
+            auto& opts = app.configuration();
+            auto requests = opts["requests"].as<unsigned>();
+            auto concurrency = opts["concurrency"].as<unsigned>();
+            auto size = opts["size"].as<unsigned>();
+
+            std::optional<tmpdir> tmp;
+            auto dir = opts["testdir"].as<sstring>();
+            if (dir.empty()) {
+                tmp.emplace();
+                dir = tmp->path().string();
+            }
+
+            db::commitlog::config cfg;
+            cfg.commit_log_location = dir;
+            cfg.metrics_category_name = "commitlog";
+            cfg.commitlog_segment_size_in_mb = opts["segment-size"].as<unsigned>();
+            cfg.commitlog_total_space_in_mb = opts["total-space"].as<unsigned>();
+            cfg.commitlog_sync_period_in_ms = opts["sync-period"].as<unsigned>();
+            cfg.use_o_dsync = opts["o-dsync"].as<bool>();
+            cfg.reuse_segments = opts["reuse-segments"].as<bool>();
+            auto mode = opts["mode"].as<sstring>();
+            if (mode == "batch") {
+                cfg.mode = db::commitlog::sync_mode::BATCH;
+            } else if (mode == "periodic") {
+                cfg.mode = db::commitlog::sync_mode::PERIODIC;
+            } else {
+                throw std::invalid_argument(format("Invalid mode: {}", mode));
+            }
+            auto compression = opts["compression"].as<sstring>();
+            if (compression == "lz4") {
+                cfg.segment_compression = db::commitlog::compression::lz4;
+            } else if (compression == "zstd") {
+                cfg.segment_compression = db::commitlog::compression::zstd;
+            } else if (compression != "none") {
+                throw std::invalid_argument(format("Invalid compression: {}", compression));
+            }
+
+            std::cout << format("Writing {:d} entries of {:d} bytes, {:d} in flight, {} mode{}, segment reuse {}, compression {}\n",
+                    requests, size, concurrency, mode, cfg.use_o_dsync ? " with O_DSYNC" : "",
+                    cfg.reuse_segments ? "enabled" : "disabled", compression);
+
+            auto log = db::commitlog::create_commitlog(cfg).get0();
+            auto id = utils::UUID_gen::get_time_UUID();
+            std::vector<clk::duration> latencies;
+            latencies.reserve(requests);
+
+            semaphore in_flight(concurrency);
+            auto start = clk::now();
+            parallel_for_each(boost::irange(0u, requests), [&] (unsigned) {
+                return with_semaphore(in_flight, 1, [&] {
+                    auto t0 = clk::now();
+                    return log.add_mutation(id, size, db::commitlog::force_sync::no, [size] (db::commitlog::output& out) {
+                        out.fill('x', size);
+                    }).then([&latencies, t0] (db::rp_handle) {
+                        // Dropping the handle releases the entry.
+                        latencies.push_back(clk::now() - t0);
+                    });
+                });
+            }).get();
+            auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(clk::now() - start).count();
+
+            std::cout << format("{:.0f} writes/s, {:.2f} MB/s\n", requests / elapsed, double(requests) * size / elapsed / (1024 * 1024));
+            print_latency("write", latencies);
+            std::cout << format("flushes: {:d}, segments created: {:d}, recycled: {:d}, destroyed: {:d}\n",
+                    log.get_flush_count(), log.get_num_segments_created(), log.get_num_segments_recycled(),
+                    log.get_num_segments_destroyed());
+
+            log.shutdown().get();
+            log.clear().get();
+        });
+    });
+}
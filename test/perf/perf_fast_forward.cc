@@ -39,6 +39,7 @@
 #include "sstables/compaction_manager.hh"
 #include "transport/messages/result_message.hh"
 #include "sstables/shared_index_lists.hh"
+#include "sstables/partition_index_cache.hh"
 
 using namespace std::chrono_literals;
 using namespace seastar;
@@ -61,6 +62,7 @@ struct metrics_snapshot {
     steady_clock_type::duration idle_time;
     reactor::io_stats io;
     sstables::shared_index_lists::stats index;
+    sstables::index_page_cache_tracker::stats index_cache;
     cache_tracker::stats cache;
 
     metrics_snapshot() {
@@ -70,6 +72,7 @@ struct metrics_snapshot {
         idle_time = r.total_idle_time();
         hr_clock = std::chrono::high_resolution_clock::now();
         index = sstables::shared_index_lists::shard_stats();
+        index_cache = sstables::index_page_cache_tracker::shard_tracker().get_stats();
         cache = cql_env->local_db().row_cache_tracker().get_stats();
     }
 };
@@ -620,6 +623,9 @@ struct test_result {
     uint64_t index_misses() const { return after.index.misses - before.index.misses; }
     uint64_t index_blocks() const { return after.index.blocks - before.index.blocks; }
 
+    uint64_t index_cache_hits() const { return after.index_cache.hits - before.index_cache.hits; }
+    uint64_t index_cache_misses() const { return after.index_cache.misses - before.index_cache.misses; }
+
     uint64_t cache_hits() const { return after.cache.partition_hits - before.cache.partition_hits; }
     uint64_t cache_misses() const { return after.cache.partition_misses - before.cache.partition_misses; }
     uint64_t cache_insertions() const { return after.cache.partition_insertions - before.cache.partition_insertions; }
@@ -811,6 +817,20 @@ static test_result scan_with_stride_partitions(column_family& cf, int n, int n_r
     return {before, fragments};
 }
 
+// Reads every stride-th partition using a separate single-partition reader for each.
+static test_result read_partitions_with_stride(column_family& cf, const std::vector<dht::decorated_key>& keys, int stride) {
+    metrics_snapshot before;
+
+    uint64_t fragments = 0;
+    for (size_t i = 0; i < keys.size(); i += stride) {
+        auto pr = dht::partition_range::make_singular(keys[i]);
+        auto rd = cf.make_reader(cf.schema(), pr, cf.schema()->full_slice());
+        fragments += consume_all(rd);
+    }
+
+    return {before, fragments};
+}
+
 static test_result slice_rows(column_family& cf, int offset = 0, int n_read = 1) {
     auto rd = cf.make_reader(cf.schema(),
         query::full_partition_range,
@@ -1084,6 +1104,7 @@ std::unique_ptr<output_manager> output_mgr;
 
 void clear_cache() {
     cql_env->local_db().row_cache_tracker().clear();
+    sstables::index_page_cache_tracker::shard_tracker().clear();
 }
 
 void on_test_group() {
@@ -1577,6 +1598,34 @@ void test_small_partition_slicing(column_family& cf2, multipart_ds& ds) {
     test(n_parts / 2, 4096);
 }
 
+void test_small_partition_point_reads(column_family& cf2, multipart_ds& ds) {
+    auto n_parts = ds.n_partitions(cfg);
+
+    output_mgr->set_test_param_names({{"stride", "{:<7}"}, {"idx cache", "{:<10}"}}, test_result::stats_names());
+    auto keys = make_pkeys(cf2.schema(), n_parts);
+    auto test = [&] (int stride) {
+      run_test_case([&] {
+        // The first pass starts with an empty index page cache, the second one can be served from it.
+        test_result_vector results;
+        for (auto pass : {"cold", "warm"}) {
+            auto r = read_partitions_with_stride(cf2, keys, stride);
+            r.set_params(to_sstrings(stride, pass));
+            check_fragment_count(r, (n_parts + stride - 1) / stride);
+            results.push_back(std::move(r));
+        }
+        if (sstables::index_page_cache_tracker::shard_tracker().enabled() && results.back().index_cache_misses()) {
+            results.back().set_error("Expected all index pages to be served from the index page cache");
+        }
+        return results;
+      });
+    };
+
+    test(1);
+    test(16);
+    test(256);
+    test(4096);
+}
+
 static
 auto make_datasets() {
     std::map<std::string, std::unique_ptr<dataset>> dsets;
@@ -1723,6 +1772,13 @@ static std::initializer_list<test_group> test_groups = {
         test_group::type::small_partition,
         make_test_fn(test_small_partition_slicing),
     },
+    {
+        "small-partition-point-reads",
+        "Testing single-partition reads of small partitions with a cold and a warm index page cache",
+        test_group::requires_cache::no,
+        test_group::type::small_partition,
+        make_test_fn(test_small_partition_point_reads),
+    },
 };
 
 // Disables compaction for given tables.
@@ -219,6 +219,96 @@ PERF_TEST_F(combined, overlapping_partitions_disjoint_rows)
     ));
 }
 
+// Merging many readers, as when compacting or reading a table with many
+// sstables (e.g. many size tiers), for 2 to 64 readers.
+class combined_many {
+    static constexpr size_t partition_count = 256;
+    static constexpr size_t rows_per_partition = 8;
+    static constexpr size_t run_length = 8;
+    mutable simple_schema _schema;
+    std::vector<dht::decorated_key> _dkeys;
+private:
+    mutation make_partition(size_t pk, size_t first_row, size_t row_stride) const {
+        auto m = mutation(_schema.schema(), _dkeys[pk]);
+        for (auto i = 0u; i < rows_per_partition; i++) {
+            m.apply(_schema.make_row(_schema.make_ckey(first_row + i * row_stride), "value"));
+        }
+        return m;
+    }
+    std::vector<flat_mutation_reader> make_readers(std::vector<std::vector<mutation>> mss) const {
+        return boost::copy_range<std::vector<flat_mutation_reader>>(
+            mss
+            | boost::adaptors::transformed([] (auto&& ms) {
+                return flat_mutation_reader_from_mutations(std::move(ms));
+            })
+        );
+    }
+protected:
+    // Each partition is in one of the readers, consecutive partitions are in different readers.
+    std::vector<flat_mutation_reader> interleaved_partitions(size_t n) const {
+        std::vector<std::vector<mutation>> mss(n);
+        for (auto pk = 0u; pk < partition_count; pk++) {
+            mss[pk % n].push_back(make_partition(pk, 0, 1));
+        }
+        return make_readers(std::move(mss));
+    }
+    // Each partition is in one of the readers, which hold runs of consecutive partitions.
+    std::vector<flat_mutation_reader> partition_runs(size_t n) const {
+        std::vector<std::vector<mutation>> mss(n);
+        for (auto pk = 0u; pk < partition_count; pk++) {
+            mss[(pk / run_length) % n].push_back(make_partition(pk, 0, 1));
+        }
+        return make_readers(std::move(mss));
+    }
+    // Each partition is in all of the readers, which have interleaved rows of it.
+    std::vector<flat_mutation_reader> interleaved_rows(size_t n) const {
+        std::vector<std::vector<mutation>> mss(n);
+        for (auto pk = 0u; pk < partition_count / 16; pk++) {
+            for (auto r = 0u; r < n; r++) {
+                mss[r].push_back(make_partition(pk, r, n));
+            }
+        }
+        return make_readers(std::move(mss));
+    }
+    schema_ptr schema() const { return _schema.schema(); }
+    future<> consume_all(flat_mutation_reader mr) const {
+        return do_with(std::move(mr), [] (auto& mr) {
+            perf_tests::start_measuring_time();
+            return mr.consume_pausable([] (mutation_fragment mf) {
+                perf_tests::do_not_optimize(mf);
+                return stop_iteration::no;
+            }, db::no_timeout).then([] {
+                perf_tests::stop_measuring_time();
+            });
+        });
+    }
+public:
+    combined_many()
+        : _dkeys(_schema.make_pkeys(partition_count))
+    { }
+};
+
+#define COMBINED_MANY_PERF_TESTS(n) \
+    PERF_TEST_F(combined_many, interleaved_partitions_##n) \
+    { \
+        return consume_all(make_combined_reader(schema(), interleaved_partitions(n))); \
+    } \
+    PERF_TEST_F(combined_many, partition_runs_##n) \
+    { \
+        return consume_all(make_combined_reader(schema(), partition_runs(n))); \
+    } \
+    PERF_TEST_F(combined_many, interleaved_rows_##n) \
+    { \
+        return consume_all(make_combined_reader(schema(), interleaved_rows(n))); \
+    }
+
+COMBINED_MANY_PERF_TESTS(2)
+COMBINED_MANY_PERF_TESTS(4)
+COMBINED_MANY_PERF_TESTS(8)
+COMBINED_MANY_PERF_TESTS(16)
+COMBINED_MANY_PERF_TESTS(32)
+COMBINED_MANY_PERF_TESTS(64)
+
 class memtable {
     static constexpr size_t partition_count = 1000;
     static constexpr size_t row_count = 50;
@@ -46,9 +46,14 @@
 #include <seastar/core/shared_ptr.hh>
 #include "utils/large_bitset.hh"
 #include <array>
+#include <cmath>
 #include <cstdlib>
 #include "bloom_filter.hh"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 namespace utils {
 namespace filter {
 
@@ -77,6 +82,14 @@ bool bloom_filter::is_present(hashed_key key) {
     return result;
 }
 
+// Only the first bit is prefetched, since negative probes usually stop early.
+void bloom_filter::prefetch(hashed_key key) {
+    for_each_index(key, 1, _bitset.size(), _format, [this] (auto i) {
+        _bitset.prefetch(i);
+        return stop_iteration::yes;
+    });
+}
+
 void bloom_filter::add(const bytes_view& key) {
     for_each_index(make_hashed_key(key), _hash_count, _bitset.size(), _format, [this] (auto i) {
         _bitset.set(i);
@@ -88,15 +101,180 @@ bool bloom_filter::is_present(const bytes_view& key) {
     return is_present(make_hashed_key(key));
 }
 
+namespace {
+
+// Odd multipliers used to derive the bit set in each word of a block from the key.
+// Same constants as used by the split block bloom filters of Impala and Parquet.
+alignas(32) constexpr uint32_t split_block_salt[split_block_bloom_filter::words_per_block] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+inline uint32_t split_block_bit(uint32_t key, int word) {
+    return (key * split_block_salt[word]) >> 27;
+}
+
+// Word i of a block occupies bits [32 * i, 32 * i + 32) of the block, which
+// on a little-endian machine matches the in-memory layout of eight uint32_t.
+bool probe_scalar(const uint64_t* block, uint32_t key) {
+    for (int i = 0; i < split_block_bloom_filter::words_per_block; ++i) {
+        auto bit = (i % 2) * 32 + split_block_bit(key, i);
+        if (!((block[i / 2] >> bit) & 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#ifdef __SSE4_1__
+// SSE has no per-lane variable shift, so 1 << bit is computed by building the
+// float 2^bit and converting it back. The conversion of 2^31 overflows to
+// 0x80000000, which happens to be the expected value.
+bool probe_sse4_1(const uint64_t* block, uint32_t key) {
+    const __m128i k = _mm_set1_epi32(key);
+    const __m128i exponent_bias = _mm_set1_epi32(127);
+    for (int half = 0; half < 2; ++half) {
+        auto salt = _mm_load_si128(reinterpret_cast<const __m128i*>(split_block_salt) + half);
+        auto bits = _mm_srli_epi32(_mm_mullo_epi32(k, salt), 27);
+        auto mask = _mm_cvttps_epi32(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(bits, exponent_bias), 23)));
+        auto words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block) + half);
+        if (!_mm_testc_si128(words, mask)) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+[[gnu::target("avx2")]]
+bool probe_avx2(const uint64_t* block, uint32_t key) {
+    auto salt = _mm256_load_si256(reinterpret_cast<const __m256i*>(split_block_salt));
+    auto bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(key), salt), 27);
+    auto mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+    auto words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    return _mm256_testc_si256(words, mask);
+}
+
+#endif
+
+struct split_block_probe {
+    using func_type = bool (*)(const uint64_t* block, uint32_t key);
+
+    func_type func;
+    const char* name;
+
+    static split_block_probe select() {
+#if defined(__x86_64__) || defined(__i386__)
+        // Needed since we may be called before the constructor of libgcc which initializes the CPU model.
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return { probe_avx2, "avx2" };
+        }
+#ifdef __SSE4_1__
+        return { probe_sse4_1, "sse4.1" };
+#endif
+#endif
+        return { probe_scalar, "scalar" };
+    }
+};
+
+const split_block_probe selected_split_block_probe = split_block_probe::select();
+
+}
+
+split_block_bloom_filter::split_block_bloom_filter(bitmap&& bs)
+    : bloom_filter(words_per_block, std::move(bs), filter_format::split_block)
+    , _num_blocks(bits().size() / bits_per_block)
+{
+    if (!_num_blocks || bits().size() % bits_per_block) {
+        throw std::invalid_argument(format("Invalid split block bloom filter size: {} bits", bits().size()));
+    }
+}
+
+// The words of a block never straddle chunks of the storage, since the
+// number of words in a chunk is a multiple of the block size.
+const uint64_t* split_block_bloom_filter::block_for(uint64_t hash) {
+    auto idx = uint64_t((static_cast<unsigned __int128>(hash) * _num_blocks) >> 64);
+    return &bits().get_storage()[idx * (bits_per_block / 64)];
+}
+
+void split_block_bloom_filter::add(const bytes_view& key) {
+    auto h = make_hashed_key(key).hash();
+    auto idx = uint64_t((static_cast<unsigned __int128>(h[1]) * _num_blocks) >> 64);
+    auto k = static_cast<uint32_t>(h[0]);
+    for (int i = 0; i < words_per_block; ++i) {
+        bits().set(idx * bits_per_block + i * 32 + split_block_bit(k, i));
+    }
+}
+
+bool split_block_bloom_filter::is_present(hashed_key key) {
+    auto h = key.hash();
+    return selected_split_block_probe.func(block_for(h[1]), static_cast<uint32_t>(h[0]));
+}
+
+void split_block_bloom_filter::prefetch(hashed_key key) {
+    __builtin_prefetch(block_for(key.hash()[1]));
+}
+
+bool split_block_bloom_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
+double split_block_bloom_filter::false_positive_rate(double bits_per_element) {
+    // Keys are spread among blocks following a Poisson distribution. A block
+    // holding k keys yields a false positive when all eight tested bits are
+    // among those set by the k keys in the respective words.
+    double lambda = bits_per_block / bits_per_element;
+    int max_keys = int(lambda + 10 * std::sqrt(lambda) + 10);
+    double p = std::exp(-lambda);
+    double fpr = 0;
+    for (int k = 0; k <= max_keys; ++k) {
+        fpr += p * std::pow(1 - std::pow(31.0 / 32, k), words_per_block);
+        p *= lambda / (k + 1);
+    }
+    return fpr;
+}
+
+double split_block_bloom_filter::bits_per_element(double max_false_pos_prob) {
+    // Beyond that, the false positive rate is dominated by the hash rather than the filter size.
+    constexpr double max_bits_per_element = 64;
+    double bits = 1;
+    while (bits < max_bits_per_element && false_positive_rate(bits) > max_false_pos_prob) {
+        bits += 0.5;
+    }
+    return bits;
+}
+
+const char* split_block_probe_implementation() {
+    return selected_split_block_probe.name;
+}
+
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format) {
+    if (format == filter_format::split_block) {
+        return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+    }
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
 
 filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter_format format) {
     int64_t num_bits = (num_elements * buckets_per) + bloom_calculations::EXCESS;
+    if (format == filter_format::split_block) {
+        large_bitset bitset(align_up<int64_t>(num_bits, split_block_bloom_filter::bits_per_block));
+        return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+    }
     num_bits = align_up<int64_t>(num_bits, 64);  // Seems to be implied in origin
     large_bitset bitset(num_bits);
     return std::make_unique<murmur3_bloom_filter>(hash, std::move(bitset), format);
 }
+
+filter_ptr create_split_block_filter(int64_t num_elements, double max_false_pos_prob) {
+    auto bits_per_element = split_block_bloom_filter::bits_per_element(max_false_pos_prob);
+    auto num_blocks = std::max<uint64_t>(1, std::ceil(std::max<int64_t>(1, num_elements) * bits_per_element
+            / split_block_bloom_filter::bits_per_block));
+    large_bitset bitset(num_blocks * split_block_bloom_filter::bits_per_block);
+    return std::make_unique<split_block_bloom_filter>(std::move(bitset));
+}
 }
 }
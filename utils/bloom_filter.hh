@@ -62,6 +62,7 @@ class bloom_filter: public i_filter {
 public:
     int num_hashes() { return _hash_count; }
     bitmap& bits() { return _bitset; }
+    filter_format format() const { return _format; }
 
     bloom_filter(int hashes, bitmap&& bs, filter_format format)
         : _bitset(std::move(bs))
@@ -75,6 +76,8 @@ class bloom_filter: public i_filter {
 
     virtual bool is_present(hashed_key key) override;
 
+    virtual void prefetch(hashed_key key) override;
+
     virtual void clear() override {
         _bitset.clear();
     }
@@ -93,6 +96,45 @@ struct murmur3_bloom_filter: public bloom_filter {
     {}
 };
 
+// Split block bloom filter.
+//
+// The bitset is divided into 256-bit blocks and all bits of a key are set in a
+// single block, one bit in each of its eight 32-bit words. A negative probe thus
+// touches a single cache line instead of up to k of them, and the eight bits are
+// computed and tested at once with SIMD instructions where the CPU supports them.
+// The price is a slightly higher false positive rate for the same number of bits
+// per element, which create_split_block_filter() compensates for.
+class split_block_bloom_filter : public bloom_filter {
+public:
+    static constexpr int words_per_block = 8;
+    static constexpr int bits_per_block = words_per_block * 32;
+private:
+    uint64_t _num_blocks;
+private:
+    const uint64_t* block_for(uint64_t hash);
+public:
+    split_block_bloom_filter(bitmap&& bs);
+
+    uint64_t num_blocks() const { return _num_blocks; }
+
+    virtual void add(const bytes_view& key) override;
+
+    virtual bool is_present(const bytes_view& key) override;
+
+    virtual bool is_present(hashed_key key) override;
+
+    virtual void prefetch(hashed_key key) override;
+
+    // Estimated false positive rate of a filter with the given number of bits per element.
+    static double false_positive_rate(double bits_per_element);
+
+    // Smallest number of bits per element which satisfies the given false positive rate.
+    static double bits_per_element(double max_false_pos_prob);
+};
+
+// Name of the SIMD probe implementation selected for this CPU.
+const char* split_block_probe_implementation();
+
 struct always_present_filter: public i_filter {
 
     virtual bool is_present(const bytes_view& key) override {
@@ -116,5 +158,6 @@ struct always_present_filter: public i_filter {
 
 filter_ptr create_filter(int hash, large_bitset&& bitset, filter_format format);
 filter_ptr create_filter(int hash, int64_t num_elements, int buckets_per, filter_format format);
+filter_ptr create_split_block_filter(int64_t num_elements, double max_false_pos_prob);
 }
 }
@@ -0,0 +1,1146 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <boost/intrusive/parent_from_member.hpp>
+#include "utils/allocation_strategy.hh"
+
+//
+// Intrusive B+tree keyed by a 64-bit prefix of the element key.
+//
+// Compared to a red-black tree, nodes hold many elements, so a lookup touches
+// O(log_B(n)) nodes instead of O(log_2(n)), and most of the comparisons are done
+// on integer prefixes stored inline in the nodes rather than on the elements
+// themselves. Elements are dereferenced only when their prefix is equal to the
+// prefix of the looked up key.
+//
+// The prefix function must be consistent with the element ordering, i.e.
+// prefix(a) < prefix(b) must imply a < b.
+//
+// Separators in inner nodes bound the prefixes of the children on both sides:
+// the prefixes of the elements to the left of a separator are not greater than
+// it, and those to the right are not smaller. Elements whose prefix is equal to
+// the prefix of a looked up key may thus span several children only if their
+// separators are equal to that prefix too, and those children are binary
+// searched by comparing the key with their last element. Lookups remain
+// logarithmic when many elements share the same prefix.
+//
+// Nodes are allocated using current_allocator() and are movable, so the tree can
+// live in LSA memory. Elements are linked through a member_hook which can be moved
+// by the allocator as well. Leaves hold pointers to the hooks and hooks point back
+// to their leaf, so iterators, which point to hooks, remain valid across insertions
+// and erasures of other elements, like in the red-black tree.
+//
+namespace bplus {
+
+// Maximum number of keys in a node. The keys of a node fill one cache line, a
+// leaf with its hook pointers and links spans about three.
+static constexpr unsigned node_capacity = 8;
+// Erasure merges a node which falls below this many keys with a sibling, or
+// refills it from one, so nodes other than the root are at least half full
+// after erasures. Splits of appends leave the rightmost nodes emptier, until
+// they are filled by further appends.
+static constexpr unsigned node_min_fill = node_capacity / 2;
+
+class node_base;
+class leaf_node;
+class inner_node;
+class tree_base;
+class member_hook;
+
+template<typename T, member_hook T::*Member>
+class tree;
+
+// Links an element into a tree. Must be a member of the element.
+//
+// The hook is auto-unlinking, destroying a linked element removes it from the tree.
+class member_hook {
+    leaf_node* _leaf = nullptr;
+
+    friend class leaf_node;
+    friend class tree_base;
+    template<typename T, member_hook T::*Member>
+    friend class tree;
+public:
+    member_hook() noexcept = default;
+    member_hook(const member_hook&) = delete;
+    // Takes over the position of the other hook in the tree.
+    member_hook(member_hook&& o) noexcept;
+    ~member_hook() {
+        if (_leaf) {
+            unlink();
+        }
+    }
+
+    bool is_linked() const noexcept { return _leaf != nullptr; }
+
+    // Removes the element from its tree. Nodes are freed using current_allocator().
+    void unlink() noexcept;
+};
+
+class node_base {
+protected:
+    friend class leaf_node;
+    friend class inner_node;
+    friend class tree_base;
+    template<typename T, member_hook T::*Member>
+    friend class tree;
+
+    union {
+        inner_node* _parent;
+        tree_base* _tree; // when _is_root
+    };
+    uint8_t _size = 0; // Number of keys
+    bool _is_leaf;
+    bool _is_root = false;
+    int64_t _keys[node_capacity];
+protected:
+    explicit node_base(bool is_leaf) noexcept : _parent(nullptr), _is_leaf(is_leaf) { }
+    node_base(node_base&& o) noexcept;
+    ~node_base() = default;
+public:
+    node_base(const node_base&) = delete;
+
+    // Returns the number of keys which are smaller than the prefix.
+    unsigned count_less(int64_t prefix) const noexcept {
+        unsigned n = 0;
+        for (unsigned i = 0; i < _size; ++i) {
+            n += _keys[i] < prefix;
+        }
+        return n;
+    }
+
+    // Returns the number of keys which are not greater than the prefix.
+    unsigned count_not_greater(int64_t prefix) const noexcept {
+        unsigned n = 0;
+        for (unsigned i = 0; i < _size; ++i) {
+            n += _keys[i] <= prefix;
+        }
+        return n;
+    }
+
+    bool is_full() const noexcept { return _size == node_capacity; }
+    bool is_leaf() const noexcept { return _is_leaf; }
+    unsigned size() const noexcept { return _size; }
+};
+
+class leaf_node final : public node_base {
+    friend class tree_base;
+    friend class member_hook;
+    template<typename T, member_hook T::*Member>
+    friend class tree;
+
+    member_hook* _hooks[node_capacity];
+    leaf_node* _prev = nullptr;
+    leaf_node* _next = nullptr;
+public:
+    leaf_node() noexcept : node_base(true) { }
+    leaf_node(leaf_node&& o) noexcept
+        : node_base(std::move(o))
+        , _prev(o._prev)
+        , _next(o._next)
+    {
+        for (unsigned i = 0; i < _size; ++i) {
+            _hooks[i] = o._hooks[i];
+            _hooks[i]->_leaf = this;
+        }
+        if (_prev) {
+            _prev->_next = this;
+        }
+        if (_next) {
+            _next->_prev = this;
+        }
+    }
+
+    unsigned index_of(const member_hook* h) const noexcept {
+        unsigned i = 0;
+        while (_hooks[i] != h) {
+            ++i;
+        }
+        return i;
+    }
+
+    void insert(unsigned idx, int64_t prefix, member_hook* h) noexcept {
+        for (unsigned i = _size; i > idx; --i) {
+            _keys[i] = _keys[i - 1];
+            _hooks[i] = _hooks[i - 1];
+        }
+        _keys[idx] = prefix;
+        _hooks[idx] = h;
+        h->_leaf = this;
+        ++_size;
+    }
+
+    void remove(unsigned idx) noexcept {
+        _hooks[idx]->_leaf = nullptr;
+        for (unsigned i = idx + 1; i < _size; ++i) {
+            _keys[i - 1] = _keys[i];
+            _hooks[i - 1] = _hooks[i];
+        }
+        --_size;
+    }
+};
+
+class inner_node final : public node_base {
+    friend class node_base;
+    friend class tree_base;
+    template<typename T, member_hook T::*Member>
+    friend class tree;
+
+    // Child i holds elements whose prefixes are not greater than _keys[i].
+    node_base* _children[node_capacity + 1];
+public:
+    inner_node() noexcept : node_base(false) { }
+    inner_node(inner_node&& o) noexcept
+        : node_base(std::move(o))
+    {
+        for (unsigned i = 0; i <= _size; ++i) {
+            _children[i] = o._children[i];
+            _children[i]->_parent = this;
+        }
+    }
+
+    unsigned index_of(const node_base* child) const noexcept {
+        unsigned i = 0;
+        while (_children[i] != child) {
+            ++i;
+        }
+        return i;
+    }
+
+    // Inserts child to the right of the child at idx, separated from it by key.
+    void insert(unsigned idx, int64_t key, node_base* child) noexcept {
+        for (unsigned i = _size; i > idx; --i) {
+            _keys[i] = _keys[i - 1];
+            _children[i + 1] = _children[i];
+        }
+        _keys[idx] = key;
+        _children[idx + 1] = child;
+        child->_parent = this;
+        ++_size;
+    }
+
+    // Removes the child at idx, which must not be the first one, together with the
+    // key to its left. Used when the child is merged into its left sibling, which
+    // is then bounded by the key to the right of the removed child.
+    void remove_with_left_key(unsigned idx) noexcept {
+        for (unsigned i = idx; i < _size; ++i) {
+            _keys[i - 1] = _keys[i];
+        }
+        for (unsigned i = idx + 1; i <= _size; ++i) {
+            _children[i - 1] = _children[i];
+        }
+        --_size;
+    }
+
+    // Removes the child at idx. The node must have more than one child.
+    void remove(unsigned idx) noexcept {
+        // Child i is bounded by _keys[i], so drop the key to the right of the removed
+        // child, or the one to its left if it is the last child.
+        unsigned key_idx = idx == _size ? idx - 1 : idx;
+        for (unsigned i = key_idx + 1; i < _size; ++i) {
+            _keys[i - 1] = _keys[i];
+        }
+        for (unsigned i = idx + 1; i <= _size; ++i) {
+            _children[i - 1] = _children[i];
+        }
+        --_size;
+    }
+};
+
+class tree_base {
+protected:
+    // Represents end(). Never linked, which distinguishes it from element hooks.
+    member_hook _header;
+    node_base* _root = nullptr;
+    size_t _size = 0;
+
+    friend class node_base;
+    friend class member_hook;
+
+    static constexpr unsigned max_height = 32;
+protected:
+    tree_base() noexcept = default;
+    tree_base(tree_base&& o) noexcept
+        : _root(std::exchange(o._root, nullptr))
+        , _size(std::exchange(o._size, 0))
+    {
+        if (_root) {
+            _root->_tree = this;
+        }
+    }
+    ~tree_base() {
+        assert(!_root);
+    }
+
+    static tree_base* tree_of(const node_base* n) noexcept {
+        while (!n->_is_root) {
+            n = n->_parent;
+        }
+        return n->_tree;
+    }
+
+    static tree_base* tree_of_header(const member_hook* h) noexcept {
+        return boost::intrusive::get_parent_from_member(const_cast<member_hook*>(h), &tree_base::_header);
+    }
+
+    void set_root(node_base* n) noexcept {
+        _root = n;
+        n->_is_root = true;
+        n->_tree = this;
+    }
+
+    leaf_node* leftmost_leaf() const noexcept {
+        node_base* n = _root;
+        while (!n->_is_leaf) {
+            n = static_cast<inner_node*>(n)->_children[0];
+        }
+        return static_cast<leaf_node*>(n);
+    }
+
+    leaf_node* rightmost_leaf() const noexcept {
+        return rightmost_leaf_of(_root);
+    }
+
+    static leaf_node* rightmost_leaf_of(node_base* n) noexcept {
+        while (!n->_is_leaf) {
+            auto in = static_cast<inner_node*>(n);
+            n = in->_children[in->_size];
+        }
+        return static_cast<leaf_node*>(n);
+    }
+
+    // Returns the separator between a leaf, which must not be the leftmost one, and
+    // the previous leaf. It is in their lowest common ancestor.
+    static int64_t lower_separator(const leaf_node* leaf) noexcept {
+        const node_base* n = leaf;
+        while (true) {
+            inner_node* parent = n->_parent;
+            unsigned idx = parent->index_of(n);
+            if (idx) {
+                return parent->_keys[idx - 1];
+            }
+            n = parent;
+        }
+    }
+
+    member_hook* header() const noexcept {
+        return const_cast<member_hook*>(&_header);
+    }
+
+    member_hook* first() const noexcept {
+        return _root ? leftmost_leaf()->_hooks[0] : header();
+    }
+
+    // Returns the hook following h, or the header if h is the last one.
+    static member_hook* next(const member_hook* h) noexcept {
+        leaf_node* leaf = h->_leaf;
+        unsigned idx = leaf->index_of(h) + 1;
+        if (idx < leaf->_size) {
+            return leaf->_hooks[idx];
+        }
+        if (leaf->_next) {
+            return leaf->_next->_hooks[0];
+        }
+        return tree_of(leaf)->header();
+    }
+
+    // Returns the hook preceding h, which may be the header.
+    static member_hook* prev(const member_hook* h) noexcept {
+        leaf_node* leaf = h->_leaf;
+        if (!leaf) {
+            leaf = tree_of_header(h)->rightmost_leaf();
+            return leaf->_hooks[leaf->_size - 1];
+        }
+        unsigned idx = leaf->index_of(h);
+        if (idx) {
+            return leaf->_hooks[idx - 1];
+        }
+        leaf = leaf->_prev;
+        return leaf->_hooks[leaf->_size - 1];
+    }
+
+    // Links h before the hook at pos, which may be the header. If h is linked
+    // into another tree, it is unlinked from it once linking can no longer fail.
+    // Provides strong exception guarantees.
+    void insert_before(member_hook* pos, int64_t prefix, member_hook* h);
+
+    // Unlinks h. Returns the hook following it. Without rebalance_nodes, only
+    // emptied nodes are freed.
+    member_hook* erase(member_hook* h, bool rebalance_nodes = true) noexcept;
+
+    // Frees all nodes. Elements must be already unlinked.
+    void free_nodes(node_base* n) noexcept;
+
+    static size_t memory_usage_of(const node_base* n) noexcept;
+private:
+    void remove_node(node_base* n, bool rebalance_nodes) noexcept;
+    // Merges n with a sibling, or moves an element or child of a sibling into it, if n
+    // is underfull, and so on up the tree. Collapses single-child roots.
+    void rebalance(node_base* n) noexcept;
+    void collapse_root() noexcept;
+    bool rebalance_leaves(inner_node* parent, unsigned left_idx, bool underfull_left) noexcept;
+    bool rebalance_inner_nodes(inner_node* parent, unsigned left_idx, bool underfull_left) noexcept;
+};
+inline
+member_hook::member_hook(member_hook&& o) noexcept
+    : _leaf(std::exchange(o._leaf, nullptr))
+{
+    if (_leaf) {
+        _leaf->_hooks[_leaf->index_of(&o)] = this;
+    }
+}
+
+inline
+node_base::node_base(node_base&& o) noexcept
+    : _parent(o._parent)
+    , _size(o._size)
+    , _is_leaf(o._is_leaf)
+    , _is_root(o._is_root)
+{
+    std::copy(o._keys, o._keys + _size, _keys);
+    if (_is_root) {
+        _tree->_root = this;
+    } else {
+        _parent->_children[_parent->index_of(&o)] = this;
+    }
+}
+
+inline
+void tree_base::insert_before(member_hook* pos, int64_t prefix, member_hook* h) {
+    leaf_node* leaf = nullptr;
+    unsigned idx = 0;
+    if (_root) {
+        if (pos->_leaf) {
+            leaf = pos->_leaf;
+            idx = leaf->index_of(pos);
+            // An element which goes between two leaves joins the previous one if its
+            // prefix is smaller than their separator, which then keeps bounding it.
+            if (idx == 0 && leaf->_prev && prefix < lower_separator(leaf)) {
+                leaf = leaf->_prev;
+                idx = leaf->_size;
+            }
+        } else {
+            leaf = rightmost_leaf();
+            idx = leaf->_size;
+        }
+    }
+
+    // Allocate all nodes needed by the split up front, so that a failure
+    // leaves the tree untouched.
+    unsigned inner_needed = 0;
+    if (leaf && leaf->is_full()) {
+        node_base* top = leaf;
+        while (!top->_is_root && top->_parent->is_full()) {
+            top = top->_parent;
+            ++inner_needed;
+        }
+        inner_needed += top->_is_root; // for the new root
+        assert(inner_needed <= max_height);
+    }
+
+    auto& alloc = current_allocator();
+    std::array<inner_node*, max_height> inners;
+    unsigned inner_allocated = 0;
+    leaf_node* new_leaf = nullptr;
+    if (!leaf || leaf->is_full()) {
+        new_leaf = alloc.construct<leaf_node>();
+        try {
+            while (inner_allocated < inner_needed) {
+                inners[inner_allocated] = alloc.construct<inner_node>();
+                ++inner_allocated;
+            }
+        } catch (...) {
+            while (inner_allocated) {
+                alloc.destroy(inners[--inner_allocated]);
+            }
+            alloc.destroy(new_leaf);
+            throw;
+        }
+    }
+
+    if (h->_leaf) {
+        assert(tree_of(h->_leaf) != this);
+        h->unlink();
+    }
+
+    ++_size;
+    if (!leaf) {
+        set_root(new_leaf);
+        new_leaf->insert(0, prefix, h);
+        return;
+    }
+    if (!new_leaf) {
+        leaf->insert(idx, prefix, h);
+        return;
+    }
+
+    // Split the leaf, the new leaf goes to the right. When appending past the last
+    // element of the tree, which is common for time-ordered keys, leave the left
+    // leaf full instead of splitting it in half.
+    const unsigned half = (idx == node_capacity && !leaf->_next) ? node_capacity : node_capacity / 2;
+    for (unsigned i = half; i < node_capacity; ++i) {
+        new_leaf->_keys[i - half] = leaf->_keys[i];
+        new_leaf->_hooks[i - half] = leaf->_hooks[i];
+        new_leaf->_hooks[i - half]->_leaf = new_leaf;
+    }
+    new_leaf->_size = node_capacity - half;
+    leaf->_size = half;
+    new_leaf->_prev = leaf;
+    new_leaf->_next = leaf->_next;
+    if (leaf->_next) {
+        leaf->_next->_prev = new_leaf;
+    }
+    leaf->_next = new_leaf;
+    if (idx < half || (idx == half && half != node_capacity)) {
+        leaf->insert(idx, prefix, h);
+    } else {
+        new_leaf->insert(idx - half, prefix, h);
+    }
+
+    // Propagate the split up. The separator is the largest prefix in the left node.
+    node_base* left = leaf;
+    node_base* right = new_leaf;
+    int64_t separator = leaf->_keys[leaf->_size - 1];
+    unsigned next_inner = 0;
+    while (true) {
+        if (left->_is_root) {
+            inner_node* root = inners[next_inner++];
+            left->_is_root = false;
+            root->_children[0] = left;
+            left->_parent = root;
+            root->_keys[0] = separator;
+            root->_children[1] = right;
+            right->_parent = root;
+            root->_size = 1;
+            set_root(root);
+            break;
+        }
+        inner_node* parent = left->_parent;
+        unsigned pos = parent->index_of(left);
+        if (!parent->is_full()) {
+            parent->insert(pos, separator, right);
+            break;
+        }
+
+        // Split a full inner node. Build the merged sequence of node_capacity + 1 keys
+        // and node_capacity + 2 children, the middle key goes up to the grandparent.
+        int64_t keys[node_capacity + 1];
+        node_base* children[node_capacity + 2];
+        for (unsigned i = 0, k = 0; i < node_capacity; ++i) {
+            if (i == pos) {
+                keys[k++] = separator;
+            }
+            keys[k++] = parent->_keys[i];
+        }
+        if (pos == node_capacity) {
+            keys[node_capacity] = separator;
+        }
+        for (unsigned i = 0, k = 0; i <= node_capacity; ++i) {
+            children[k++] = parent->_children[i];
+            if (i == pos) {
+                children[k++] = right;
+            }
+        }
+
+        inner_node* new_inner = inners[next_inner++];
+        const unsigned mid = (half == node_capacity && pos == node_capacity) ? node_capacity : (node_capacity + 1) / 2;
+        for (unsigned i = 0; i < mid; ++i) {
+            parent->_keys[i] = keys[i];
+        }
+        for (unsigned i = 0; i <= mid; ++i) {
+            parent->_children[i] = children[i];
+            children[i]->_parent = parent;
+        }
+        parent->_size = mid;
+        for (unsigned i = mid + 1; i <= node_capacity; ++i) {
+            new_inner->_keys[i - mid - 1] = keys[i];
+        }
+        for (unsigned i = mid + 1; i <= node_capacity + 1; ++i) {
+            new_inner->_children[i - mid - 1] = children[i];
+            children[i]->_parent = new_inner;
+        }
+        new_inner->_size = node_capacity - mid;
+
+        separator = keys[mid];
+        left = parent;
+        right = new_inner;
+    }
+    assert(next_inner == inner_needed);
+}
+
+inline
+void tree_base::remove_node(node_base* n, bool rebalance_nodes) noexcept {
+    auto& alloc = current_allocator();
+    while (true) {
+        if (n->_is_root) {
+            _root = nullptr;
+            if (n->_is_leaf) {
+                alloc.destroy(static_cast<leaf_node*>(n));
+            } else {
+                alloc.destroy(static_cast<inner_node*>(n));
+            }
+            return;
+        }
+        inner_node* parent = n->_parent;
+        unsigned idx = parent->index_of(n);
+        if (n->_is_leaf) {
+            alloc.destroy(static_cast<leaf_node*>(n));
+        } else {
+            alloc.destroy(static_cast<inner_node*>(n));
+        }
+        if (parent->_size == 0) {
+            // n was the only child.
+            n = parent;
+            continue;
+        }
+        parent->remove(idx);
+        if (rebalance_nodes) {
+            rebalance(parent);
+        } else {
+            collapse_root();
+        }
+        return;
+    }
+}
+
+// Merges the leaf at left_idx with the one to its right if they fit in one leaf,
+// otherwise moves elements from the fuller one into the underfull one until it is
+// half full. Returns true if they were merged.
+inline
+bool tree_base::rebalance_leaves(inner_node* parent, unsigned left_idx, bool underfull_left) noexcept {
+    auto left = static_cast<leaf_node*>(parent->_children[left_idx]);
+    auto right = static_cast<leaf_node*>(parent->_children[left_idx + 1]);
+    if (left->_size + right->_size <= node_capacity) {
+        for (unsigned i = 0; i < right->_size; ++i) {
+            left->_keys[left->_size + i] = right->_keys[i];
+            left->_hooks[left->_size + i] = right->_hooks[i];
+            right->_hooks[i]->_leaf = left;
+        }
+        left->_size += right->_size;
+        right->_size = 0;
+        left->_next = right->_next;
+        if (right->_next) {
+            right->_next->_prev = left;
+        }
+        parent->remove_with_left_key(left_idx + 1);
+        current_allocator().destroy(right);
+        return true;
+    }
+    // The donor keeps more than node_min_fill elements, since together they
+    // don't fit in one leaf.
+    while (underfull_left && left->_size < node_min_fill) {
+        int64_t prefix = right->_keys[0];
+        member_hook* h = right->_hooks[0];
+        right->remove(0);
+        left->insert(left->_size, prefix, h);
+    }
+    while (!underfull_left && right->_size < node_min_fill) {
+        int64_t prefix = left->_keys[left->_size - 1];
+        member_hook* h = left->_hooks[left->_size - 1];
+        left->remove(left->_size - 1);
+        right->insert(0, prefix, h);
+    }
+    // The separator is the largest prefix in the left leaf, like after a split.
+    parent->_keys[left_idx] = left->_keys[left->_size - 1];
+    return false;
+}
+
+// Like rebalance_leaves() for inner nodes, the separator between them in the
+// parent goes down between their children. Returns true if they were merged.
+inline
+bool tree_base::rebalance_inner_nodes(inner_node* parent, unsigned left_idx, bool underfull_left) noexcept {
+    auto left = static_cast<inner_node*>(parent->_children[left_idx]);
+    auto right = static_cast<inner_node*>(parent->_children[left_idx + 1]);
+    int64_t separator = parent->_keys[left_idx];
+    if (left->_size + right->_size + 1 <= node_capacity) {
+        left->_keys[left->_size] = separator;
+        for (unsigned i = 0; i < right->_size; ++i) {
+            left->_keys[left->_size + 1 + i] = right->_keys[i];
+        }
+        for (unsigned i = 0; i <= right->_size; ++i) {
+            left->_children[left->_size + 1 + i] = right->_children[i];
+            right->_children[i]->_parent = left;
+        }
+        left->_size += right->_size + 1;
+        right->_size = 0;
+        parent->remove_with_left_key(left_idx + 1);
+        current_allocator().destroy(right);
+        return true;
+    }
+    while (underfull_left && left->_size < node_min_fill) {
+        left->_keys[left->_size] = separator;
+        left->_children[left->_size + 1] = right->_children[0];
+        right->_children[0]->_parent = left;
+        ++left->_size;
+        parent->_keys[left_idx] = right->_keys[0];
+        for (unsigned i = 1; i < right->_size; ++i) {
+            right->_keys[i - 1] = right->_keys[i];
+        }
+        for (unsigned i = 1; i <= right->_size; ++i) {
+            right->_children[i - 1] = right->_children[i];
+        }
+        --right->_size;
+        separator = parent->_keys[left_idx];
+    }
+    while (!underfull_left && right->_size < node_min_fill) {
+        for (unsigned i = right->_size; i > 0; --i) {
+            right->_keys[i] = right->_keys[i - 1];
+        }
+        for (unsigned i = right->_size + 1; i > 0; --i) {
+            right->_children[i] = right->_children[i - 1];
+        }
+        right->_keys[0] = separator;
+        right->_children[0] = left->_children[left->_size];
+        right->_children[0]->_parent = right;
+        ++right->_size;
+        parent->_keys[left_idx] = left->_keys[left->_size - 1];
+        --left->_size;
+        separator = parent->_keys[left_idx];
+    }
+    return false;
+}
+
+inline
+void tree_base::rebalance(node_base* n) noexcept {
+    while (!n->_is_root && n->_size < node_min_fill) {
+        inner_node* parent = n->_parent;
+        if (parent->_size == 0) {
+            // n is the only child, left behind by a split of an append.
+            n = parent;
+            continue;
+        }
+        // Pair n with its left sibling, or with its right one if it is the first child.
+        unsigned idx = parent->index_of(n);
+        unsigned left_idx = idx ? idx - 1 : 0;
+        bool merged = n->_is_leaf
+                ? rebalance_leaves(parent, left_idx, idx == 0)
+                : rebalance_inner_nodes(parent, left_idx, idx == 0);
+        if (!merged) {
+            break;
+        }
+        // The parent lost a child.
+        n = parent;
+    }
+    collapse_root();
+}
+
+inline
+void tree_base::collapse_root() noexcept {
+    while (!_root->_is_leaf && _root->_size == 0) {
+        auto old_root = static_cast<inner_node*>(_root);
+        set_root(old_root->_children[0]);
+        current_allocator().destroy(old_root);
+    }
+}
+
+inline
+member_hook* tree_base::erase(member_hook* h, bool rebalance_nodes) noexcept {
+    leaf_node* leaf = h->_leaf;
+    unsigned idx = leaf->index_of(h);
+    member_hook* next;
+    if (idx + 1 < leaf->_size) {
+        next = leaf->_hooks[idx + 1];
+    } else if (leaf->_next) {
+        next = leaf->_next->_hooks[0];
+    } else {
+        next = header();
+    }
+    leaf->remove(idx);
+    --_size;
+    if (leaf->_size == 0) {
+        if (leaf->_prev) {
+            leaf->_prev->_next = leaf->_next;
+        }
+        if (leaf->_next) {
+            leaf->_next->_prev = leaf->_prev;
+        }
+        remove_node(leaf, rebalance_nodes);
+    } else if (rebalance_nodes) {
+        rebalance(leaf);
+    }
+    return next;
+}
+
+inline
+void tree_base::free_nodes(node_base* n) noexcept {
+    auto& alloc = current_allocator();
+    if (n->_is_leaf) {
+        alloc.destroy(static_cast<leaf_node*>(n));
+    } else {
+        auto in = static_cast<inner_node*>(n);
+        for (unsigned i = 0; i <= in->_size; ++i) {
+            free_nodes(in->_children[i]);
+        }
+        alloc.destroy(in);
+    }
+}
+
+inline
+size_t tree_base::memory_usage_of(const node_base* n) noexcept {
+    if (n->_is_leaf) {
+        return sizeof(leaf_node);
+    }
+    auto in = static_cast<const inner_node*>(n);
+    size_t usage = sizeof(inner_node);
+    for (unsigned i = 0; i <= in->_size; ++i) {
+        usage += memory_usage_of(in->_children[i]);
+    }
+    return usage;
+}
+
+inline
+void member_hook::unlink() noexcept {
+    tree_base::tree_of(_leaf)->erase(this);
+}
+
+//
+// T is the element type, Member is the pointer to its member_hook.
+//
+// The tree doesn't store a comparator. Operations which need to order elements
+// take one, which in addition to the usual strict weak ordering of elements and
+// keys must provide int64_t prefix(const K&) for T and for all key types used in
+// lookups. The prefix must be consistent with the ordering, see above.
+//
+// Iterators remain valid until the element they point to is unlinked or moved,
+// like those of boost::intrusive containers.
+//
+template<typename T, member_hook T::*Member>
+class tree : private tree_base {
+public:
+    template<bool Const>
+    class iterator_base {
+        member_hook* _hook = nullptr;
+
+        friend class tree;
+        template<bool> friend class iterator_base;
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = std::conditional_t<Const, const T, T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type*;
+        using reference = value_type&;
+
+        iterator_base() noexcept = default;
+        explicit iterator_base(member_hook* h) noexcept : _hook(h) { }
+        template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+        iterator_base(const iterator_base<OtherConst>& o) noexcept : _hook(o._hook) { }
+
+        reference operator*() const noexcept { return *element_of(_hook); }
+        pointer operator->() const noexcept { return element_of(_hook); }
+
+        iterator_base& operator++() noexcept {
+            _hook = tree_base::next(_hook);
+            return *this;
+        }
+        iterator_base operator++(int) noexcept {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+        iterator_base& operator--() noexcept {
+            _hook = tree_base::prev(_hook);
+            return *this;
+        }
+        iterator_base operator--(int) noexcept {
+            auto it = *this;
+            --*this;
+            return it;
+        }
+
+        template<bool OtherConst>
+        bool operator==(const iterator_base<OtherConst>& o) const noexcept { return _hook == o._hook; }
+        template<bool OtherConst>
+        bool operator!=(const iterator_base<OtherConst>& o) const noexcept { return _hook != o._hook; }
+
+        iterator_base<false> unconst() const noexcept { return iterator_base<false>(_hook); }
+    };
+
+    using value_type = T;
+    using iterator = iterator_base<false>;
+    using const_iterator = iterator_base<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+private:
+    static T* element_of(member_hook* h) noexcept {
+        return boost::intrusive::get_parent_from_member<T, member_hook>(h, Member);
+    }
+
+    static member_hook* hook_of(const T& e) noexcept {
+        return const_cast<member_hook*>(&(e.*Member));
+    }
+
+    // Returns the hook of the first element not less than the key.
+    // If Upper, returns the hook of the first element greater than the key.
+    template<bool Upper, typename Key, typename Compare>
+    member_hook* bound(const Key& key, const Compare& cmp) const {
+        if (!_root) {
+            return header();
+        }
+        int64_t prefix = cmp.prefix(key);
+        // Whether an element, whose prefix is equal to the prefix of the key, goes before the bound.
+        auto precedes = [&] (member_hook* h) {
+            const T& e = *element_of(h);
+            if constexpr (Upper) {
+                return !cmp(key, e);
+            } else {
+                return cmp(e, key);
+            }
+        };
+
+        // Children count_less() to count_not_greater() may hold elements with the prefix of the
+        // key, all others go either before or after the bound. Descend into the first of them
+        // whose last element doesn't go before the bound, or into the last of them.
+        node_base* n = _root;
+        while (!n->_is_leaf) {
+            auto in = static_cast<inner_node*>(n);
+            unsigned lo = in->count_less(prefix);
+            unsigned hi = in->count_not_greater(prefix);
+            while (lo < hi) {
+                unsigned mid = (lo + hi) / 2;
+                leaf_node* last = rightmost_leaf_of(in->_children[mid]);
+                unsigned last_idx = last->_size - 1;
+                if (last->_keys[last_idx] < prefix || precedes(last->_hooks[last_idx])) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            n = in->_children[lo];
+        }
+
+        auto leaf = static_cast<leaf_node*>(n);
+        unsigned lo = leaf->count_less(prefix);
+        unsigned hi = leaf->count_not_greater(prefix);
+        while (lo < hi) {
+            unsigned mid = (lo + hi) / 2;
+            if (precedes(leaf->_hooks[mid])) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo < leaf->_size) {
+            return leaf->_hooks[lo];
+        }
+        // All elements of the leaf go before the bound, so it is the first element after the leaf.
+        return leaf->_next ? leaf->_next->_hooks[0] : header();
+    }
+
+    // Returns the hook preceding h, or nullptr if h is the first one.
+    member_hook* prev_or_null(member_hook* h) const noexcept {
+        if (!h->_leaf) {
+            return _root ? tree_base::prev(h) : nullptr;
+        }
+        leaf_node* leaf = h->_leaf;
+        if (leaf->_hooks[0] == h && !leaf->_prev) {
+            return nullptr;
+        }
+        return tree_base::prev(h);
+    }
+public:
+    tree() noexcept = default;
+    tree(tree&& o) noexcept = default;
+    tree(const tree&) = delete;
+    ~tree() {
+        clear();
+    }
+
+    bool empty() const noexcept { return !_root; }
+    size_t size() const noexcept { return _size; }
+    // For compatibility with boost::intrusive containers, the size is known in constant time.
+    size_t calculate_size() const noexcept { return _size; }
+
+    // Memory taken by the nodes. Walks all of the inner nodes.
+    size_t external_memory_usage() const noexcept {
+        return _root ? memory_usage_of(_root) : 0;
+    }
+
+    iterator begin() noexcept { return iterator(first()); }
+    iterator end() noexcept { return iterator(header()); }
+    const_iterator begin() const noexcept { return const_iterator(first()); }
+    const_iterator end() const noexcept { return const_iterator(header()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    static iterator iterator_to(T& e) noexcept { return iterator(hook_of(e)); }
+    static const_iterator iterator_to(const T& e) noexcept { return const_iterator(hook_of(e)); }
+
+    // Returns the tree into which e is linked.
+    static tree& container_of(T& e) noexcept {
+        return static_cast<tree&>(*tree_of(hook_of(e)->_leaf));
+    }
+
+    // Returns true if and only if e is the only member of its tree.
+    static bool is_only_member(T& e) noexcept {
+        return container_of(e)._size == 1;
+    }
+
+    template<typename Key, typename Compare>
+    iterator lower_bound(const Key& key, const Compare& cmp) { return iterator(bound<false>(key, cmp)); }
+    template<typename Key, typename Compare>
+    const_iterator lower_bound(const Key& key, const Compare& cmp) const { return const_iterator(bound<false>(key, cmp)); }
+
+    template<typename Key, typename Compare>
+    iterator upper_bound(const Key& key, const Compare& cmp) { return iterator(bound<true>(key, cmp)); }
+    template<typename Key, typename Compare>
+    const_iterator upper_bound(const Key& key, const Compare& cmp) const { return const_iterator(bound<true>(key, cmp)); }
+
+    template<typename Key, typename Compare>
+    iterator find(const Key& key, const Compare& cmp) {
+        member_hook* h = bound<false>(key, cmp);
+        return iterator((h->_leaf && !cmp(key, *element_of(h))) ? h : header());
+    }
+    template<typename Key, typename Compare>
+    const_iterator find(const Key& key, const Compare& cmp) const {
+        return const_cast<tree*>(this)->find(key, cmp);
+    }
+
+    // Links e before the hint, which must be the position at which e belongs.
+    // If e is linked into another tree, it is moved from there.
+    // Provides strong exception guarantees.
+    template<typename Compare>
+    iterator insert_before(const_iterator hint, T& e, const Compare& cmp) {
+        tree_base::insert_before(hint._hook, cmp.prefix(e), hook_of(e));
+        return iterator_to(e);
+    }
+
+    // Links e unless an equal element is already present, in which case returns
+    // an iterator to it and false. The hint is used if e belongs right before it.
+    template<typename Compare>
+    std::pair<iterator, bool> insert_check(const_iterator hint, T& e, const Compare& cmp) {
+        member_hook* pos = hint._hook;
+        member_hook* before = prev_or_null(pos);
+        if ((!pos->_leaf || cmp(e, *element_of(pos))) && (!before || cmp(*element_of(before), e))) {
+            return {insert_before(hint, e, cmp), true};
+        }
+        pos = bound<false>(e, cmp);
+        if (pos->_leaf && !cmp(e, *element_of(pos))) {
+            return {iterator(pos), false};
+        }
+        return {insert_before(const_iterator(pos), e, cmp), true};
+    }
+
+    template<typename Compare>
+    iterator insert(const_iterator hint, T& e, const Compare& cmp) {
+        return insert_check(hint, e, cmp).first;
+    }
+
+    // Unlinks the first element and returns it, or nullptr if the tree is empty.
+    // Unlike with boost::intrusive containers, the tree stays balanced and can be
+    // used as usual afterwards.
+    T* unlink_leftmost_without_rebalance() noexcept {
+        if (!_root) {
+            return nullptr;
+        }
+        member_hook* h = leftmost_leaf()->_hooks[0];
+        tree_base::erase(h, false);
+        return element_of(h);
+    }
+
+    // Unlinks the element. Returns an iterator to the next element.
+    iterator erase(const_iterator it) noexcept {
+        return iterator(tree_base::erase(it._hook));
+    }
+
+    iterator erase(const_iterator b, const_iterator e) noexcept {
+        while (b != e) {
+            b = erase(b);
+        }
+        return b.unconst();
+    }
+
+    template<typename Disposer>
+    iterator erase_and_dispose(const_iterator it, Disposer&& disposer) noexcept {
+        T* e = element_of(it._hook);
+        auto next = erase(it);
+        disposer(e);
+        return next;
+    }
+
+    template<typename Disposer>
+    iterator erase_and_dispose(const_iterator b, const_iterator e, Disposer&& disposer) noexcept {
+        while (b != e) {
+            b = erase_and_dispose(b, disposer);
+        }
+        return b.unconst();
+    }
+
+    // Unlinks and disposes all elements, in order.
+    template<typename Disposer>
+    void clear_and_dispose(Disposer&& disposer) noexcept {
+        if (!_root) {
+            return;
+        }
+        for (leaf_node* leaf = leftmost_leaf(); leaf; leaf = leaf->_next) {
+            for (unsigned i = 0; i < leaf->_size; ++i) {
+                member_hook* h = leaf->_hooks[i];
+                h->_leaf = nullptr;
+                disposer(element_of(h));
+            }
+        }
+        free_nodes(std::exchange(_root, nullptr));
+        _size = 0;
+    }
+
+    void clear() noexcept {
+        clear_and_dispose([] (T*) { });
+    }
+
+    // Replaces the contents with clones of src elements. Prefixes are copied
+    // from src, so no comparator is needed.
+    template<typename Cloner, typename Disposer>
+    void clone_from(const tree& src, Cloner cloner, Disposer disposer) {
+        clear_and_dispose(disposer);
+        if (src.empty()) {
+            return;
+        }
+        try {
+            for (leaf_node* leaf = src.leftmost_leaf(); leaf; leaf = leaf->_next) {
+                for (unsigned i = 0; i < leaf->_size; ++i) {
+                    T* e = cloner(*element_of(leaf->_hooks[i]));
+                    try {
+                        tree_base::insert_before(header(), leaf->_keys[i], hook_of(*e));
+                    } catch (...) {
+                        disposer(e);
+                        throw;
+                    }
+                }
+            }
+        } catch (...) {
+            clear_and_dispose(disposer);
+            throw;
+        }
+    }
+};
+
+}
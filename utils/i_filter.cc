@@ -39,6 +39,10 @@ filter_ptr i_filter::get_filter(int64_t num_elements, double max_false_pos_proba
         return std::make_unique<filter::always_present_filter>();
     }
 
+    if (fformat == filter_format::split_block) {
+        return filter::create_split_block_filter(num_elements, max_false_pos_probability);
+    }
+
     int buckets_per_element = bloom_calculations::max_buckets_per_element(num_elements);
     auto spec = bloom_calculations::compute_bloom_spec(buckets_per_element, max_false_pos_probability);
     return filter::create_filter(spec.K, num_elements, spec.buckets_per_element, fformat);
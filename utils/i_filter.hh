@@ -51,6 +51,7 @@ using filter_ptr = std::unique_ptr<i_filter>;
 enum class filter_format {
     k_l_format,
     m_format,
+    split_block, // cache-line blocked filter, see split_block_bloom_filter
 };
 
 class hashed_key {
@@ -71,6 +72,9 @@ struct i_filter {
     virtual void add(const bytes_view& key) = 0;
     virtual bool is_present(const bytes_view& key) = 0;
     virtual bool is_present(hashed_key) = 0;
+    // Hints that is_present() will be called soon for the key, so that the memory
+    // accesses of probes of several filters can overlap.
+    virtual void prefetch(hashed_key) { }
     virtual void clear() = 0;
     virtual void close() = 0;
 
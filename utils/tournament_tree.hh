@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include "utils/small_vector.hh"
+
+namespace utils {
+
+// A tournament tree, a priority queue for k-way merging.
+//
+// Values live in slots (the leaves of the tree) and each inner node holds
+// the slot which won the match played there, so the root holds the
+// smallest value. Changing the value of a slot only replays the matches on
+// the path from that slot to the root, one comparison per level, so taking
+// the smallest value out and putting the next value of the same input in
+// costs log2(k) comparisons, about half of what a binary heap needs for the
+// same pop and push. Empty slots lose to any value without a comparison,
+// so taking a value out costs no comparisons at all.
+//
+// Unlike a tree of losers, which is cheaper still but can only replace the
+// winner, any slot can be updated, which is what lets values be put in
+// some time after the winner was taken out (e.g. after an input was
+// refilled asynchronously), in any order.
+//
+// Slots are not tied to inputs: a value is put in any free slot. The tree
+// grows when all slots are taken, which requires a rebuild, so reserve()
+// the expected number of inputs up front.
+//
+// Less must be a strict weak ordering of T. Among equal values the order in
+// which they are taken out is unspecified.
+template <typename T, typename Less, size_t N = 4>
+class tournament_tree {
+    using slot_index = uint32_t;
+    Less _less;
+    utils::small_vector<std::optional<T>, N> _slots;
+    // Inner nodes are [1, slots), slot i is node slots + i, the parent of
+    // node i is i / 2. _nodes[0] is unused.
+    utils::small_vector<slot_index, N> _nodes;
+    utils::small_vector<slot_index, N> _free;
+    size_t _size = 0;
+private:
+    // Returns true if the value in slot a goes before the value in slot b.
+    bool beats(slot_index a, slot_index b) const {
+        if (!_slots[a]) {
+            return false;
+        }
+        if (!_slots[b]) {
+            return true;
+        }
+        return _less(*_slots[a], *_slots[b]);
+    }
+    slot_index winner_of(size_t node) const {
+        const size_t k = _slots.size();
+        return node >= k ? slot_index(node - k) : _nodes[node];
+    }
+    void play(size_t node) {
+        auto a = winner_of(2 * node);
+        auto b = winner_of(2 * node + 1);
+        _nodes[node] = beats(b, a) ? b : a;
+    }
+    void replay(slot_index slot) {
+        for (size_t node = (slot + _slots.size()) / 2; node > 0; node /= 2) {
+            play(node);
+        }
+    }
+    void rebuild() {
+        const size_t k = _slots.size();
+        _nodes.clear();
+        _nodes.resize(k, 0);
+        for (size_t node = k - 1; node > 0; --node) {
+            play(node);
+        }
+    }
+    slot_index winner() const {
+        return _slots.size() > 1 ? _nodes[1] : 0;
+    }
+public:
+    explicit tournament_tree(Less less = Less())
+        : _less(std::move(less)) {
+    }
+
+    tournament_tree(tournament_tree&&) = default;
+
+    // The number of values in the tree.
+    size_t size() const {
+        return _size;
+    }
+    bool empty() const {
+        return !_size;
+    }
+
+    // Makes room for n values, so that pushing them does not rebuild the tree.
+    void reserve(size_t n) {
+        if (n <= _slots.size()) {
+            return;
+        }
+        _free.reserve(n);
+        for (auto i = _slots.size(); i < n; ++i) {
+            _slots.emplace_back();
+            _free.push_back(slot_index(i));
+        }
+        rebuild();
+    }
+
+    // The smallest value. The tree must not be empty.
+    T& top() {
+        assert(!empty());
+        return *_slots[winner()];
+    }
+    const T& top() const {
+        assert(!empty());
+        return *_slots[winner()];
+    }
+
+    void push(T value) {
+        if (_free.empty()) {
+            reserve(std::max<size_t>(1, _slots.size() * 2));
+        }
+        // The most recently freed slot, usually the one of the value
+        // this one replaces.
+        auto slot = _free.back();
+        _free.pop_back();
+        _slots[slot].emplace(std::move(value));
+        ++_size;
+        replay(slot);
+    }
+
+    // Takes the smallest value out. The tree must not be empty.
+    T pop() {
+        assert(!empty());
+        auto slot = winner();
+        T value = std::move(*_slots[slot]);
+        _slots[slot].reset();
+        _free.push_back(slot);
+        --_size;
+        replay(slot);
+        return value;
+    }
+
+    // Replaces the smallest value with the given one. Cheaper than pop()
+    // followed by push().
+    void replace_top(T value) {
+        assert(!empty());
+        auto slot = winner();
+        *_slots[slot] = std::move(value);
+        replay(slot);
+    }
+
+    void clear() {
+        _free.clear();
+        for (size_t i = _slots.size(); i > 0; --i) {
+            _slots[i - 1].reset();
+            _free.push_back(slot_index(i - 1));
+        }
+        _size = 0;
+        rebuild();
+    }
+
+    // Calls func on every value, in no particular order.
+    template <typename Func>
+    void for_each(Func&& func) {
+        for (auto& slot : _slots) {
+            if (slot) {
+                func(*slot);
+            }
+        }
+    }
+};
+
+}
@@ -25,15 +25,31 @@
 // which are available only when the library is linked statically.
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd/lib/zstd.h"
+#include "zstd/lib/dictBuilder/zdict.h"
 
 #include "compress.hh"
 #include "utils/class_registrator.hh"
 
 static const sstring COMPRESSION_LEVEL = "compression_level";
+static const sstring DICTIONARY_SIZE_KB = "dictionary_size_kb";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
 
+// Upper bound for the dictionary_size_kb option. Larger dictionaries would be
+// trained on too few samples, see compressor::max_dictionary_sample_size.
+static constexpr size_t MAX_DICTIONARY_SIZE_KB = compressor::max_dictionary_size / 1024;
+
+struct zstd_cdict_deleter {
+    void operator()(ZSTD_CDict* d) const { ZSTD_freeCDict(d); }
+};
+
+struct zstd_ddict_deleter {
+    void operator()(ZSTD_DDict* d) const { ZSTD_freeDDict(d); }
+};
+
 class zstd_processor : public compressor {
     int _compression_level = 3;
+    size_t _chunk_len;
+    size_t _dictionary_size = 0;
 
     // Manages memory for the compression context.
     std::unique_ptr<char[], free_deleter> _cctx_raw;
@@ -44,8 +60,16 @@ class zstd_processor : public compressor {
     std::unique_ptr<char[], free_deleter> _dctx_raw;
     // Decompression context. Observer of _dctx_raw.
     ZSTD_DCtx* _dctx;
+
+    // Engaged only for processors created by with_dictionary().
+    bytes _dictionary;
+    std::unique_ptr<ZSTD_CDict, zstd_cdict_deleter> _cdict;
+    std::unique_ptr<ZSTD_DDict, zstd_ddict_deleter> _ddict;
+private:
+    void init_contexts();
 public:
     zstd_processor(const opt_getter&);
+    zstd_processor(const zstd_processor& base, bytes_view dictionary);
 
     size_t uncompress(const char* input, size_t input_len, char* output,
                     size_t output_len) const override;
@@ -53,6 +77,11 @@ class zstd_processor : public compressor {
                     size_t output_len) const override;
     size_t compress_max_size(size_t input_len) const override;
 
+    size_t dictionary_size() const override;
+    bytes train_dictionary(bytes_view samples, const std::vector<size_t>& sample_sizes) const override;
+    shared_ptr<compressor> with_dictionary(bytes_view dictionary) const override;
+    bytes_view dictionary() const override;
+
     std::set<sstring> option_names() const override;
     std::map<sstring, sstring> options() const override;
 };
@@ -76,17 +105,57 @@ zstd_processor::zstd_processor(const opt_getter& opts)
         }
     }
 
+    auto dictionary_size_kb = opts(DICTIONARY_SIZE_KB);
+    if (dictionary_size_kb) {
+        int size_kb;
+        try {
+            size_kb = std::stoi(*dictionary_size_kb);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(
+                format("Invalid integer value {} for {}", *dictionary_size_kb, DICTIONARY_SIZE_KB));
+        }
+        if (size_kb < 0 || size_t(size_kb) > MAX_DICTIONARY_SIZE_KB) {
+            throw exceptions::configuration_exception(
+                format("{} must be between 0 and {}, got {}", DICTIONARY_SIZE_KB, MAX_DICTIONARY_SIZE_KB, size_kb));
+        }
+        _dictionary_size = size_t(size_kb) * 1024;
+    }
+
     auto chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB);
     if (!chunk_len_kb) {
         chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
     }
-    auto chunk_len = chunk_len_kb
+    _chunk_len = chunk_len_kb
        // This parameter has already been validated.
        ? std::stoi(*chunk_len_kb) * 1024
        : compression_parameters::DEFAULT_CHUNK_LENGTH;
 
+    init_contexts();
+}
+
+zstd_processor::zstd_processor(const zstd_processor& base, bytes_view dictionary)
+    : compressor(COMPRESSOR_NAME)
+    , _compression_level(base._compression_level)
+    , _chunk_len(base._chunk_len)
+    , _dictionary_size(base._dictionary_size)
+    , _dictionary(dictionary.begin(), dictionary.end()) {
+    // Compression parameters depend on the dictionary size, the context has to be sized for them.
+    auto cparams = ZSTD_getCParams(_compression_level, _chunk_len, _dictionary.size());
+    _cdict.reset(ZSTD_createCDict_advanced(_dictionary.data(), _dictionary.size(),
+            ZSTD_dlm_byRef, ZSTD_dct_auto, cparams, ZSTD_defaultCMem));
+    if (!_cdict) {
+        throw std::runtime_error("Unable to initialize ZSTD compression dictionary");
+    }
+    _ddict.reset(ZSTD_createDDict_byReference(_dictionary.data(), _dictionary.size()));
+    if (!_ddict) {
+        throw std::runtime_error("Unable to initialize ZSTD decompression dictionary");
+    }
+    init_contexts();
+}
+
+void zstd_processor::init_contexts() {
     // We assume that the uncompressed input length is always <= chunk_len.
-    auto cparams = ZSTD_getCParams(_compression_level, chunk_len, 0);
+    auto cparams = ZSTD_getCParams(_compression_level, _chunk_len, _dictionary.size());
     auto cctx_size = ZSTD_estimateCCtxSize_usingCParams(cparams);
     // According to the ZSTD documentation, pointer to the context buffer must be 8-bytes aligned.
     _cctx_raw = allocate_aligned_buffer<char>(cctx_size, 8);
@@ -98,13 +167,15 @@ zstd_processor::zstd_processor(const opt_getter& opts)
     auto dctx_size = ZSTD_estimateDCtxSize();
     _dctx_raw = allocate_aligned_buffer<char>(dctx_size, 8);
     _dctx = ZSTD_initStaticDCtx(_dctx_raw.get(), dctx_size);
-    if (!_cctx) {
+    if (!_dctx) {
         throw std::runtime_error("Unable to initialize ZSTD decompression context");
     }
 }
 
 size_t zstd_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
+    auto ret = _ddict
+        ? ZSTD_decompress_usingDDict(_dctx, output, output_len, input, input_len, _ddict.get())
+        : ZSTD_decompressDCtx(_dctx, output, output_len, input, input_len);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD decompression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -113,7 +184,9 @@ size_t zstd_processor::uncompress(const char* input, size_t input_len, char* out
 
 
 size_t zstd_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
-    auto ret = ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
+    auto ret = _cdict
+        ? ZSTD_compress_usingCDict(_cctx, output, output_len, input, input_len, _cdict.get())
+        : ZSTD_compressCCtx(_cctx, output, output_len, input, input_len, _compression_level);
     if (ZSTD_isError(ret)) {
         throw std::runtime_error( format("ZSTD compression failure: {}", ZSTD_getErrorName(ret)));
     }
@@ -124,12 +197,42 @@ size_t zstd_processor::compress_max_size(size_t input_len) const {
     return ZSTD_compressBound(input_len);
 }
 
+size_t zstd_processor::dictionary_size() const {
+    return _dictionary_size;
+}
+
+bytes zstd_processor::train_dictionary(bytes_view samples, const std::vector<size_t>& sample_sizes) const {
+    if (!_dictionary_size || sample_sizes.empty()) {
+        return bytes();
+    }
+    bytes dict(bytes::initialized_later(), _dictionary_size);
+    auto ret = ZDICT_trainFromBuffer(dict.data(), dict.size(), samples.data(), sample_sizes.data(), sample_sizes.size());
+    if (ZDICT_isError(ret)) {
+        // Not enough samples or nothing to learn from them.
+        return bytes();
+    }
+    dict.resize(ret);
+    return dict;
+}
+
+shared_ptr<compressor> zstd_processor::with_dictionary(bytes_view dictionary) const {
+    return make_shared<zstd_processor>(*this, dictionary);
+}
+
+bytes_view zstd_processor::dictionary() const {
+    return _dictionary;
+}
+
 std::set<sstring> zstd_processor::option_names() const {
-    return {COMPRESSION_LEVEL};
+    return {COMPRESSION_LEVEL, DICTIONARY_SIZE_KB};
 }
 
 std::map<sstring, sstring> zstd_processor::options() const {
-    return {{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    std::map<sstring, sstring> opts{{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    if (_dictionary_size) {
+        opts.emplace(DICTIONARY_SIZE_KB, std::to_string(_dictionary_size / 1024));
+    }
+    return opts;
 }
 
 static const class_registrator<compressor_ptr, zstd_processor, const compressor::opt_getter&>